@@ -6,6 +6,7 @@
 #include <QWaitCondition>
 #include <QString>
 #include <QStringList>
+#include <QVariantMap>
 
 #include <deque>
 #include <vector>
@@ -13,6 +14,14 @@
 #include <tuple>
 #include <atomic>
 #include <memory>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+#include "audiocensor/constants.h"
+#include "audiocensor/config_snapshot.h"
+#include "audiocensor/recognition_result.h"
+#include "audiocensor/device_catalog.h"
 
 // Прототипы классов PortAudio и Vosk
 typedef void PaStream;
@@ -21,6 +30,14 @@ struct VoskRecognizer;
 
 namespace audiocensor {
 
+class WordDetector;
+class CompiledDictionary;
+class DriftCompensator;
+class BoundaryRefiner;
+class LookbackRing;
+class RedecodeWorker;
+class EndpointTuner;
+
 /**
  * @brief Поток для обработки аудио и цензуры нежелательных слов
  */
@@ -30,11 +47,10 @@ class AudioProcessor : public QThread {
 public:
     /**
      * @brief Конструктор
-     * @param config Конфигурация аудио процессора
+     * @param config Снимок конфигурации аудио процессора
      * @param parent Родительский объект
      */
-    explicit AudioProcessor(const std::unordered_map<std::string, std::string>& config, 
-                           QObject* parent = nullptr);
+    explicit AudioProcessor(ConfigSnapshotPtr config, QObject* parent = nullptr);
     
     /**
      * @brief Деструктор
@@ -47,8 +63,25 @@ public:
      */
     bool initialize_audio();
     
+    /**
+     * @brief Обновляет список устройств, если набор звуковых карт системы изменился
+     *
+     * Вызывается периодически, пока обработка остановлена; во время обработки
+     * отключение и возвращение устройств обрабатывает поток обработки.
+     * Где набор звуковых карт не узнать, список обновляется раз в
+     * device_rescan_interval_ms. Открытые потоки при обновлении закрываются.
+     *
+     * @return true если список устройств изменился
+     */
+    bool refresh_devices();
+    
     /**
      * @brief Настройка входных и выходных потоков с учетом характеристик устройств
+     *
+     * Модель загружается только при первом вызове или смене пути к ней,
+     * распознаватель пересоздается при смене частоты. Переоткрываются только
+     * потоки, у которых сменилось устройство или частота.
+     *
      * @param input_index Индекс входного устройства
      * @param output_index Индекс выходного устройства
      * @return true если настройка прошла успешно, false в противном случае
@@ -64,25 +97,87 @@ public:
     
     /**
      * @brief Обновляет конфигурацию
-     * @param config Новая конфигурация
+     *
+     * Снимок подменяется атомарно и читается потоком обработки без копирования;
+     * зависящие от него размер буфера и кэш бипов поток пересчитывает сам.
+     * Снимок с уже примененной версией игнорируется.
+     *
+     * @param config Новый снимок конфигурации
+     */
+    void update_config(ConfigSnapshotPtr config);
+    
+    /**
+     * @brief Устанавливает скомпилированный словарь для детектора
+     * @param dictionary Словарь
+     */
+    void set_dictionary(std::shared_ptr<const CompiledDictionary> dictionary);
+    
+    /**
+     * @brief Возвращает словарь, по которому сейчас идут проверки
+     * @return Словарь или nullptr, если он не задан
+     */
+    std::shared_ptr<const CompiledDictionary> get_dictionary() const;
+    
+    /**
+     * @brief Компилирует словарь в фоновом потоке, сохраняет его на диск и публикует детектору
+     *
+     * Обработка аудио не останавливается: до публикации проверки идут по старому словарю.
+     * Вызов не ждет сборку: если предыдущий словарь еще собирается, запрос ставится
+     * в очередь, а более ранний несобранный запрос отбрасывается.
+     *
+     * @param target_words Запрещенные слова
+     * @param target_patterns Регулярные выражения
+     * @param version Версия словаря
      */
-    void update_config(const std::unordered_map<std::string, std::string>& config);
+    void reload_dictionary(std::vector<std::string> target_words,
+                           std::vector<std::string> target_patterns,
+                           uint64_t version);
     
     /**
      * @brief Приостанавливает обработку аудио
+     *
+     * Поток обработки останавливает аудио потоки и спит на условной переменной,
+     * не потребляя процессорное время. Буфер задержки сохраняется.
      */
     void pause();
     
     /**
-     * @brief Возобновляет обработку аудио
+     * @brief Возобновляет обработку аудио с того же места буфера задержки
      */
     void resume();
     
     /**
-     * @brief Останавливает обработку аудио и корректно освобождает ресурсы
+     * @brief Останавливает обработку аудио
+     *
+     * Потоки останавливаются, но остаются открытыми, модель остается в памяти:
+     * следующий запуск не требует их повторной подготовки. Возвращается только
+     * после выхода из run(), поэтому после вызова ресурсы можно освобождать.
      */
     void stop_processing();
     
+    /**
+     * @brief Счетчики сбоев аудио потоков (xrun)
+     */
+    struct XrunStats {
+        uint64_t input_overflows = 0;    // Переполнения входного потока (потеря сэмплов)
+        uint64_t output_underflows = 0;  // Опустошения выходного потока (пропуски воспроизведения)
+        uint64_t read_errors = 0;        // Прочие ошибки чтения
+        uint64_t write_errors = 0;       // Прочие ошибки записи
+        uint64_t samples_realigned = 0;  // Сэмплы тишины, вставленные вместо потерянного входа
+        int latency_increases = 0;       // Сколько раз увеличивалась задержка устройств
+        int device_reconnects = 0;       // Сколько раз устройства переподключались после отключения
+        double drift_ppm = 0.0;          // Расхождение часов выхода относительно входа, ppm
+        uint64_t samples_compressed = 0; // Сэмплы тишины, выброшенные для возврата задержки к цели
+        double input_latency = 0.0;      // Текущая задержка входного устройства, с
+        double output_latency = 0.0;     // Текущая задержка выходного устройства, с
+    };
+    
+    /**
+     * @brief Возвращает счетчики сбоев аудио потоков
+     * @return Копия счетчиков
+     */
+    XrunStats get_xrun_stats() const;
+    
     /**
      * @brief Проверяет, запущен ли аудио процессор
      * @return true если процессор запущен, false в противном случае
@@ -102,6 +197,38 @@ protected:
     void run() override;
 
 private:
+    /**
+     * @brief Списки для сборки словаря
+     */
+    struct DictionaryRequest {
+        std::vector<std::string> target_words;
+        std::vector<std::string> target_patterns;
+        uint64_t version;
+    };
+    
+    /**
+     * @brief Настройки, которые поток обработки читает на каждом чанке
+     *
+     * Разбираются из снимка один раз в apply_config_snapshot, чтобы горячий путь
+     * не искал ключи и не разбирал строки.
+     */
+    struct ProcessingSettings {
+        bool censoring_enabled = true;
+        bool debug_mode = false;
+        bool log_to_file = false;
+        std::string log_file;
+        int safety_margin = DEFAULT_SAFETY_MARGIN;               // Запас вокруг слова, чанки
+        double redecode_confidence = DEFAULT_REDECODE_CONFIDENCE;
+        int near_miss_distance = DEFAULT_VERIFY_NEAR_MISS_DISTANCE;
+        int redecode_padding_ms = DEFAULT_REDECODE_PADDING_MS;
+        int recognizer_cycle_s = DEFAULT_RECOGNIZER_CYCLE_S;
+        int device_error_threshold = DEFAULT_DEVICE_ERROR_THRESHOLD;
+        bool xrun_adaptive_latency = false;
+        int xrun_window_ms = DEFAULT_XRUN_WINDOW_MS;
+        int xrun_threshold = DEFAULT_XRUN_THRESHOLD;
+        double xrun_max_latency_ms = DEFAULT_XRUN_MAX_LATENCY_MS;
+    };
+    
     /**
      * @brief Обрабатывает результаты распознавания и отмечает регионы для цензуры
      * @param result_json Результаты распознавания в формате JSON
@@ -109,9 +236,231 @@ private:
     void process_recognition_result(const std::string& result_json);
     
     /**
-     * @brief Освобождает все аудио ресурсы
+     * @brief Уточняет границу слова по аудио в буфере задержки
+     * @param boundary Граница (индекс захвата); заменяется уточненной
+     * @param word_start true - начало слова, false - конец
+     * @return true если граница уточнена; false если уточнение выключено или аудио нет в буфере
+     */
+    bool refine_boundary(int64_t& boundary, bool word_start);
+    
+    /**
+     * @brief Добавляет регион цензуры для слова, уточняя его границы
+     * @param first_sample Индекс захвата начала слова
+     * @param last_sample Индекс захвата конца слова
+     * @param margin_samples Запас по краям, если границу не удалось уточнить
+     */
+    void add_censor_region(int64_t first_sample, int64_t last_sample, int64_t margin_samples);
+    
+    /**
+     * @brief Ставит окно слова с низкой уверенностью в очередь повторного распознавания
+     * @param word Слово основного распознавателя
+     * @param first_sample Индекс захвата начала слова
+     * @param last_sample Индекс захвата конца слова
+     */
+    void schedule_redecode(const std::string& word, int64_t first_sample, int64_t last_sample);
+    
+    /**
+     * @brief Забирает результаты повторного распознавания и отмечает найденные запрещенные слова
+     */
+    void collect_redecode_results();
+    
+    /**
+     * @brief Подает чанк распознавателю и обрабатывает окончательный результат
+     *
+     * Результат забирается, когда конец фразы нашел эндпоинтер Vosk или
+     * своя проверка тишины (тогда он запрашивается принудительно).
+     *
+     * @param chunk Чанк захвата
+     */
+    void recognize_chunk(const std::vector<short>& chunk);
+    
+    /**
+     * @brief Измеряет время до окончательного результата и подстраивает эндпоинтер
+     * @param forced Результат запрошен принудительно
+     */
+    void note_final_result(bool forced);
+    
+    /**
+     * @brief Заменяет распознаватель заранее созданным, если он обработал recognizer_cycle_s аудио
+     *
+     * Вызывается после окончательного результата, то есть на паузе в речи:
+     * незаконченной фразы в распознавателе нет. Новый распознаватель начинает
+     * время с нуля, сдвиг шкалы захвата переносится на него.
+     *
+     * @return true если распознаватель заменен
+     */
+    bool cycle_recognizer();
+    
+    /**
+     * @brief Создает запасной распознаватель в отдельном потоке
+     * @param retired Замененный распознаватель; освобождается в том же потоке
+     */
+    void prepare_spare_recognizer(std::shared_ptr<VoskRecognizer> retired = nullptr);
+    
+    /**
+     * @brief Дожидается создания запасного распознавателя и удаляет его
+     */
+    void discard_spare_recognizer();
+    
+    /**
+     * @brief Собирает, сохраняет и публикует словари, пока поступают запросы (поток dictionary_builder)
+     */
+    void build_dictionaries();
+    
+    /**
+     * @brief Глушит регионы цензуры в блоке сэмплов с плавными краями
+     * @param samples Сэмплы блока
+     * @param count Количество сэмплов
+     * @param first_sample Индекс захвата первого сэмпла
+     */
+    void apply_censorship(short* samples, size_t count, int64_t first_sample);
+    
+    /**
+     * @brief Возвращает длину перехода на краях региона цензуры
+     * @return Количество сэмплов
+     */
+    int64_t censor_fade_samples() const;
+    
+    /**
+     * @brief Подключает скомпилированный словарь из файла или компилирует его из списков конфигурации
+     */
+    void load_dictionary();
+    
+    /**
+     * @brief Останавливает аудио потоки и ждет снятия паузы или остановки обработки
+     */
+    void wait_while_paused();
+    
+    /**
+     * @brief Открывает входной и выходной потоки выбранных устройств
+     * @param input_latency Задержка входного устройства, с
+     * @param output_latency Задержка выходного устройства, с
+     * @return true если оба потока открыты, false в противном случае
+     */
+    bool open_streams(double input_latency, double output_latency);
+    
+    /**
+     * @brief Открывает входной поток выбранного устройства
+     * @param latency Задержка устройства, с
+     * @return true если поток открыт
+     */
+    bool open_input_stream(double latency);
+    
+    /**
+     * @brief Открывает выходной поток выбранного устройства
+     * @param latency Задержка устройства, с
+     * @return true если поток открыт
+     */
+    bool open_output_stream(double latency);
+    
+    /**
+     * @brief Останавливает и закрывает входной и выходной потоки
+     */
+    void close_streams();
+    
+    /**
+     * @brief Останавливает и закрывает входной поток
+     */
+    void close_input_stream();
+    
+    /**
+     * @brief Останавливает и закрывает выходной поток
+     */
+    void close_output_stream();
+    
+    /**
+     * @brief Останавливает потоки, не закрывая их
+     */
+    void stop_streams();
+    
+    /**
+     * @brief Читает чанк с входа, учитывает переполнение и выравнивает временную шкалу
+     * @param chunk Буфер чанка
+     * @return true если данные прочитаны, false при ошибке чтения
+     */
+    bool read_input_chunk(std::vector<short>& chunk);
+    
+    /**
+     * @brief Записывает чанк на выход и учитывает опустошение потока
+     * @param chunk Буфер чанка
+     */
+    void write_output_chunk(const std::vector<short>& chunk);
+    
+    /**
+     * @brief Применяет новый снимок конфигурации в потоке обработки
+     *
+     * Настройки и кэш бипов принадлежат потоку обработки: update_config только
+     * публикует снимок, а поток разбирает его, увидев новую версию. Размер буфера
+     * задержки сюда не входит: он фиксируется в начале run().
+     *
+     * @param config Текущий снимок
+     */
+    void apply_config_snapshot(const ConfigSnapshotPtr& config);
+    
+    /**
+     * @brief Добавляет сэмплы в буфер задержки, продвигая индекс захвата
+     * @param samples Сэмплы (nullptr - тишина)
+     * @param count Количество сэмплов
+     */
+    void append_to_buffer(const short* samples, size_t count);
+    
+    /**
+     * @brief Учитывает ошибку потока и решает, отключено ли устройство
+     * @param error Код ошибки PortAudio
+     * @param consecutive_errors Счетчик ошибок подряд для этого потока
+     */
+    void note_stream_error(int error, int& consecutive_errors);
+    
+    /**
+     * @brief Ждет возвращения выбранных устройств и переоткрывает потоки
+     *
+     * Каталог устройств пересканируется с интервалом device_reconnect_interval_ms,
+     * пока устройства не найдутся по ключу или обработка не будет остановлена.
+     * Время без входа восполняется тишиной.
+     *
+     * @return true если потоки переоткрыты
+     */
+    bool reconnect_devices();
+    
+    /**
+     * @brief Отправляет список устройств из каталога в интерфейс
+     * @param detailed Выводить в лог характеристики каждого устройства
+     */
+    void publish_device_list(bool detailed);
+    
+    /**
+     * @brief Выводит в лог подключенные и отключенные устройства
+     * @param changes Изменения списка устройств
+     */
+    void log_device_changes(const DeviceCatalog::Changes& changes);
+    
+    /**
+     * @brief Регистрирует сбой и решает, нужно ли увеличить задержку устройств
+     */
+    void record_xrun();
+    
+    /**
+     * @brief Отправляет счетчики сбоев в интерфейс (не чаще раза в секунду)
+     * @param force Отправить независимо от времени последней отправки
+     */
+    void publish_xrun_stats(bool force = false);
+    
+    /**
+     * @brief Переоткрывает потоки с увеличенной задержкой устройств
+     * @return true если потоки переоткрыты
+     */
+    bool increase_latency();
+    
+    /**
+     * @brief Освобождает все аудио ресурсы (закрывает потоки, выгружает модель, завершает PortAudio)
      */
     void cleanup_resources();
+    
+    /**
+     * @brief Возвращает текущий снимок конфигурации
+     * @return Снимок конфигурации
+     */
+    ConfigSnapshotPtr current_config() const;
 
 signals:
     /**
@@ -154,6 +503,12 @@ signals:
      */
     void censorApplied(int chunk, int start, int end);
     
+    /**
+     * @brief Сигнал для счетчиков сбоев аудио потоков
+     * @param stats Счетчики (поля XrunStats)
+     */
+    void xrunUpdate(const QVariantMap& stats);
+    
     /**
      * @brief Сигнал для обновления состояния буфера
      * @param current Текущий размер буфера
@@ -162,21 +517,42 @@ signals:
     void bufferUpdate(int current, int maximum);
 
 private:
-    // Конфигурация
-    std::unordered_map<std::string, std::string> config;
+    // Конфигурация: читается и подменяется через std::atomic_load/atomic_store
+    ConfigSnapshotPtr config_snapshot;
     
     // Флаги состояния
     std::atomic<bool> running;
     std::atomic<bool> paused;
     
-    // Аудио объекты
-    void* audio; // Эквивалент PyAudio
+    // Ожидание на паузе: флаг меняется под pause_lock, поток будится через pause_condition
+    QMutex pause_lock;
+    QWaitCondition pause_condition;
+    
+    // Аудио объекты: PortAudio, потоки и модель живут всю сессию процессора,
+    // запуск и остановка только стартуют и останавливают потоки
+    DeviceCatalog device_catalog;
     PaStream* input_stream;
     PaStream* output_stream;
     
     // Объекты распознавания речи
     std::shared_ptr<VoskModel> model;
     std::shared_ptr<VoskRecognizer> recognizer;
+    std::string loaded_model_path;
+    
+    // Смена распознавателя на паузах речи: состояние Vosk не растет за долгую сессию
+    int64_t recognizer_samples_fed;   // Сэмплы, поданные текущему распознавателю
+    uint64_t recognizer_cycles;
+    std::shared_ptr<VoskRecognizer> spare_recognizer;
+    QMutex spare_lock;
+    std::thread spare_builder;
+    std::atomic<bool> spare_building;
+    
+    // Эндпоинтер и время до окончательного результата; создается при запуске обработки
+    std::unique_ptr<EndpointTuner> endpoint_tuner;
+    
+    // Модель проверки подозрительных окон (обычно крупнее потоковой); пустой путь - потоковая модель
+    std::shared_ptr<VoskModel> verify_model;
+    std::string loaded_verify_model_path;
     
     // Динамические параметры аудио
     int current_sample_rate;
@@ -184,19 +560,67 @@ private:
     
     // Буферы и счетчики
     std::deque<short> audio_buffer;
-    int buffer_size_in_chunks;
-    std::vector<std::tuple<int, int, bool>> censored_regions;
+    int buffer_size_in_chunks;          // Задается в начале run() и не меняется до остановки
+    int chunk_size;                     // Чанк захвата; задается в начале run() вместе с буфером
+    uint64_t applied_config_version;    // Версия снимка, по которой посчитаны настройки и бипы
+    ProcessingSettings settings;        // Разобранный снимок; читается только потоком обработки
     QMutex buffer_lock;
     QMutex regions_lock;
     double program_start_time;
     int chunks_processed;
     
+    // Временная шкала в сэмплах захвата: регионы цензуры хранятся как
+    // [первый сэмпл, последний сэмпл, обработан], а не как номера чанков
+    std::vector<std::tuple<int64_t, int64_t, bool>> censored_regions;
+    int64_t captured_samples;      // Индекс захвата следующего сэмпла в буфере задержки
+    int64_t recognizer_offset;     // Индекс захвата минус время распознавателя в сэмплах
+    int64_t input_samples_read;    // Сэмплы, полученные от входного потока с его запуска
+    double input_stream_start;     // Время входного потока (Pa_GetStreamTime) при запуске
+    
+    // Сбои аудио потоков и адаптивная задержка
+    XrunStats xrun_stats;
+    mutable QMutex xrun_lock;
+    std::deque<std::chrono::steady_clock::time_point> recent_xruns;
+    std::chrono::steady_clock::time_point last_xrun_publish;
+    bool xrun_stats_changed;
+    bool latency_increase_requested;
+    
+    // Компенсация расхождения часов входа и выхода; создается при запуске обработки
+    std::unique_ptr<DriftCompensator> drift_compensator;
+    
+    // Уточнение границ слов; окно аудио вокруг границы переиспользуется
+    std::unique_ptr<BoundaryRefiner> boundary_refiner;
+    std::vector<short> boundary_window;
+    
+    // Последние секунды захвата и повторное распознавание подозрительных слов по ним
+    std::unique_ptr<LookbackRing> lookback_ring;
+    std::unique_ptr<RedecodeWorker> redecode_worker;
+    
+    // Отключение устройств: флаг ставится при ошибках потоков, снимается после переподключения
+    bool device_lost;
+    int consecutive_read_errors;
+    int consecutive_write_errors;
+    
+    // Детектор живет всю сессию, чтобы его кэш проверок работал между результатами
+    std::unique_ptr<WordDetector> detector;
+    
+    // Сборка словарей: поток берет последний запрос, пока они поступают
+    std::thread dictionary_builder;
+    QMutex dictionary_lock;
+    std::unique_ptr<DictionaryRequest> pending_dictionary;
+    bool dictionary_building;
+    
+    // Разбор результатов распознавания; используется только потоком обработки
+    RecognitionResultParser result_parser;
+    
     // Кэш для бипов
     std::unordered_map<double, std::vector<short>> beep_cache;
     
-    // Индексы устройств
+    // Индексы устройств и их ключи в каталоге (индексы меняются после пересканирования)
     int input_device_index;
     int output_device_index;
+    std::string input_device_key;
+    std::string output_device_key;
 };
 
 } // namespace audiocensor
@@ -0,0 +1,106 @@
+#ifndef AUDIOCENSOR_BOUNDARY_REFINER_H
+#define AUDIOCENSOR_BOUNDARY_REFINER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "audiocensor/config_snapshot.h"
+
+namespace audiocensor {
+
+/**
+ * @brief Уточнение границ слова по задержанному аудио
+ *
+ * Время слов Vosk грубое (шаг кадров распознавателя и выравнивание по
+ * фонемам), поэтому без уточнения регион цензуры расширяется на safety_margin
+ * чанков. Пока результат приходит, аудио слова еще лежит в буфере задержки:
+ * вокруг каждой границы считаются кратковременная энергия и спектральный поток
+ * в кадрах по 10 мс с шагом 5 мс, и граница переносится на край звучания.
+ *
+ * Кадр считается звучащим, если его энергия выше минимума окна на
+ * boundary_threshold_db. Начало слова переносится назад до тишины перед ним,
+ * конец - вперед до тишины после слова. Если тишины в окне нет (слова идут
+ * слитно), граница ставится на самый резкий рост (для начала) или спад (для
+ * конца) спектра в стороне от слова. Внутрь отчета распознавателя граница не
+ * переносится никогда: тихий глухой согласный на краю слова может не пройти
+ * порог, и регион только расширяется. К найденной границе добавляется
+ * boundary_guard_ms.
+ *
+ * Спектр считается по 16 частотам от 150 Гц до 4 кГц по заранее вычисленным
+ * таблицам, без БПФ. Объект используется только потоком обработки.
+ */
+class BoundaryRefiner {
+public:
+    /**
+     * @brief Конструктор
+     * @param config Снимок конфигурации (ключи boundary_*)
+     * @param sample_rate Частота дискретизации
+     */
+    BoundaryRefiner(const ConfigSnapshot& config, int sample_rate);
+
+    /**
+     * @brief Проверяет, включено ли уточнение в конфигурации
+     * @return true если уточнение включено
+     */
+    bool is_enabled() const { return enabled; }
+
+    /**
+     * @brief Возвращает, на сколько сэмплов в каждую сторону от границы нужно аудио
+     * @return Количество сэмплов
+     */
+    size_t search_samples() const { return search_size; }
+
+    /**
+     * @brief Уточняет начало слова
+     * @param samples Аудио вокруг границы
+     * @param count Количество сэмплов
+     * @param origin Индекс захвата первого сэмпла
+     * @param boundary Граница (индекс захвата); заменяется уточненной
+     * @return true если граница уточнена
+     */
+    bool refine_start(const short* samples, size_t count, int64_t origin, int64_t& boundary);
+
+    /**
+     * @brief Уточняет конец слова
+     * @param samples Аудио вокруг границы
+     * @param count Количество сэмплов
+     * @param origin Индекс захвата первого сэмпла
+     * @param boundary Граница (индекс захвата последнего сэмпла); заменяется уточненной
+     * @return true если граница уточнена
+     */
+    bool refine_end(const short* samples, size_t count, int64_t origin, int64_t& boundary);
+
+private:
+    /**
+     * @brief Считает энергию, спектр и поток по кадрам окна и отмечает звучащие кадры
+     * @param samples Аудио окна
+     * @param count Количество сэмплов
+     * @return Количество кадров (0 - окно короче трех кадров)
+     */
+    size_t _analyze(const short* samples, size_t count);
+
+private:
+    bool enabled;
+    size_t frame_size;
+    size_t hop_size;
+    size_t search_size;
+    size_t guard_size;
+    double threshold_db;
+
+    // Таблицы DFT: для каждой частоты frame_size значений cos и sin с окном Ханна
+    size_t band_count;
+    std::vector<float> cos_table;
+    std::vector<float> sin_table;
+
+    // Результаты анализа окна; емкость переиспользуется
+    std::vector<double> energy_db;
+    std::vector<float> spectrum;
+    std::vector<double> onset_flux;
+    std::vector<double> offset_flux;
+    std::vector<char> voiced;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_BOUNDARY_REFINER_H
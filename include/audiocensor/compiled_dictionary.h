@@ -0,0 +1,166 @@
+#ifndef AUDIOCENSOR_COMPILED_DICTIONARY_H
+#define AUDIOCENSOR_COMPILED_DICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "audiocensor/fuzzy_matcher.h"
+#include "audiocensor/morph_index.h"
+
+namespace audiocensor {
+
+/**
+ * @brief Скомпилированный словарь в формате, готовом к использованию без разбора
+ *
+ * Образ словаря - один непрерывный блок: заголовок с таблицей секций, затем
+ * нормализованные слова, исходные паттерны, индекс нечеткого поиска и узлы
+ * морфологического индекса. Все секции выровнены по 8 байт и содержат
+ * массивы POD-структур, поэтому индексы работают прямо поверх образа:
+ * загрузка не требует разбора и построения индексов.
+ *
+ * Образ строится один раз после загрузки списков (build) и сохраняется
+ * на диск (save); при следующем запуске файл подключается через open.
+ * Списки слов не хранятся на диске в открытом виде: файл обфусцируется так же,
+ * как кэш списков и настройки, и восстанавливается в памяти при чтении.
+ * Формат использует порядок байт платформы и при несовпадении отвергается.
+ */
+class CompiledDictionary {
+public:
+    /**
+     * @brief Строит образ словаря в памяти
+     * @param target_words Запрещенные слова (допускается порог вида "слово~N")
+     * @param patterns Регулярные выражения
+     * @param version Версия словаря (например, с сервера)
+     * @param fuzzy_max_distance Общий максимум расстояния для нечеткого поиска
+     * @return Словарь или nullptr при ошибке
+     */
+    static std::shared_ptr<CompiledDictionary> build(
+        const std::vector<std::string>& target_words,
+        const std::vector<std::string>& patterns,
+        uint64_t version,
+        int fuzzy_max_distance
+    );
+
+    /**
+     * @brief Читает сохраненный образ словаря и восстанавливает его в памяти
+     * @param path Путь к файлу
+     * @return Словарь или nullptr, если файла нет или он поврежден
+     */
+    static std::shared_ptr<CompiledDictionary> open(const std::string& path);
+
+    CompiledDictionary(const CompiledDictionary&) = delete;
+    CompiledDictionary& operator=(const CompiledDictionary&) = delete;
+
+    /**
+     * @brief Сохраняет обфусцированный образ словаря в файл (через временный файл и переименование)
+     * @param path Путь к файлу
+     * @return true если образ сохранен, false в противном случае
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Возвращает версию словаря
+     * @return Версия
+     */
+    uint64_t get_version() const;
+
+    /**
+     * @brief Возвращает отпечаток содержимого словаря
+     * @return Отпечаток
+     */
+    uint64_t get_fingerprint() const;
+
+    /**
+     * @brief Возвращает количество слов
+     * @return Количество слов
+     */
+    size_t word_count() const { return word_total; }
+
+    /**
+     * @brief Возвращает нормализованное слово словаря
+     * @param index Индекс слова
+     * @return Слово (пустое, если индекс вне диапазона)
+     */
+    std::string_view word(size_t index) const;
+
+    /**
+     * @brief Возвращает количество паттернов
+     * @return Количество паттернов
+     */
+    size_t pattern_count() const { return pattern_total; }
+
+    /**
+     * @brief Возвращает исходный текст паттерна
+     * @param index Индекс паттерна
+     * @return Паттерн (пустой, если индекс вне диапазона)
+     */
+    std::string_view pattern(size_t index) const;
+
+    /**
+     * @brief Возвращает индекс нечеткого поиска
+     * @return Индекс поверх образа словаря
+     */
+    const FuzzyMatcher& fuzzy() const { return fuzzy_matcher; }
+
+    /**
+     * @brief Возвращает морфологический индекс
+     * @return Индекс поверх образа словаря
+     */
+    const MorphIndex& morph() const { return morph_index; }
+
+    /**
+     * @brief Вычисляет отпечаток содержимого списков
+     * @param target_words Запрещенные слова
+     * @param patterns Регулярные выражения
+     * @return Отпечаток
+     */
+    static uint64_t fingerprint(const std::vector<std::string>& target_words,
+                                const std::vector<std::string>& patterns);
+
+private:
+    CompiledDictionary();
+
+    /**
+     * @brief Проверяет заголовок и подключает индексы к секциям образа
+     * @return true если образ корректен, false в противном случае
+     */
+    bool _attach();
+
+    /**
+     * @brief Возвращает элемент таблицы смещений строк с проверкой границ
+     * @param offsets Таблица смещений
+     * @param count Количество строк
+     * @param bytes Байты строк
+     * @param bytes_size Размер байтов строк
+     * @param index Индекс строки
+     * @return Строка
+     */
+    static std::string_view _string_at(const uint32_t* offsets, size_t count,
+                                       const char* bytes, size_t bytes_size, size_t index);
+
+private:
+    // Образ в собственном буфере: uint64_t гарантирует выравнивание секций
+    std::vector<uint64_t> buffer;
+    const unsigned char* data;
+    size_t size;
+
+    const uint32_t* word_offsets;
+    const char* word_bytes;
+    size_t word_total;
+    size_t word_bytes_size;
+
+    const uint32_t* pattern_offsets;
+    const char* pattern_bytes;
+    size_t pattern_total;
+    size_t pattern_bytes_size;
+
+    FuzzyMatcher fuzzy_matcher;
+    MorphIndex morph_index;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_COMPILED_DICTIONARY_H
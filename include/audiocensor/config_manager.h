@@ -4,12 +4,29 @@
 #include <QSettings>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <memory>
+#include <functional>
+#include <map>
+
+#include "audiocensor/config_snapshot.h"
+
+class QTimer;
 
 namespace audiocensor {
 
 /**
  * @brief Класс для управления конфигурацией приложения
+ *
+ * Изменения записываются не сразу: измененные ключи помечаются и сохраняются
+ * одной пачкой по таймеру после паузы в обновлениях. Неизменившиеся значения
+ * не перезаписываются и не шифруются повторно. Несохраненные изменения
+ * записываются в деструкторе.
+ *
+ * Текущая конфигурация хранится как неизменяемый снимок: потребители получают
+ * общий экземпляр без копирования и узнают об изменениях по номеру версии
+ * или через подписку.
  */
 class ConfigManager {
 public:
@@ -19,27 +36,66 @@ public:
     ConfigManager();
     
     /**
-     * @brief Деструктор
+     * @brief Деструктор, сохраняет несохраненные изменения
      */
     ~ConfigManager();
     
+    ConfigManager(const ConfigManager&) = delete;
+    ConfigManager& operator=(const ConfigManager&) = delete;
+    
+    /**
+     * @brief Обработчик изменения конфигурации
+     */
+    using ChangeCallback = std::function<void(const ConfigSnapshotPtr&)>;
+    
     /**
-     * @brief Возвращает текущую конфигурацию
+     * @brief Возвращает текущую конфигурацию для редактирования
      * @return Копия текущей конфигурации
      */
     std::unordered_map<std::string, std::string> get_config() const;
     
+    /**
+     * @brief Возвращает текущий снимок конфигурации без копирования
+     *
+     * Можно вызывать из любого потока.
+     *
+     * @return Неизменяемый снимок
+     */
+    ConfigSnapshotPtr get_snapshot() const;
+    
+    /**
+     * @brief Возвращает версию текущей конфигурации
+     * @return Номер версии
+     */
+    uint64_t get_version() const;
+    
     /**
      * @brief Возвращает текущий список целевых слов
-     * @return Список целевых слов
+     * @return Общий неизменяемый список (разобран при публикации снимка)
      */
-    std::vector<std::string> get_target_words() const;
+    std::shared_ptr<const std::vector<std::string>> get_target_words() const;
     
     /**
      * @brief Возвращает текущий список целевых паттернов
-     * @return Список целевых паттернов
+     * @return Общий неизменяемый список (разобран при публикации снимка)
+     */
+    std::shared_ptr<const std::vector<std::string>> get_target_patterns() const;
+    
+    /**
+     * @brief Подписывает обработчик на изменения конфигурации
+     *
+     * Обработчик вызывается в потоке, изменившем конфигурацию, с новым снимком.
+     *
+     * @param callback Обработчик
+     * @return Идентификатор подписки
      */
-    std::vector<std::string> get_target_patterns() const;
+    int subscribe(ChangeCallback callback);
+    
+    /**
+     * @brief Отменяет подписку
+     * @param subscription_id Идентификатор подписки
+     */
+    void unsubscribe(int subscription_id);
     
     /**
      * @brief Обновляет конфигурацию
@@ -64,6 +120,11 @@ public:
      */
     void reset_config();
     
+    /**
+     * @brief Немедленно сохраняет измененные ключи, не дожидаясь таймера
+     */
+    void flush();
+    
 private:
     /**
      * @brief Загружает конфигурацию по умолчанию
@@ -73,19 +134,62 @@ private:
     
     /**
      * @brief Загружает сохраненную конфигурацию
+     * @param config Конфигурация, в которую подставляются сохраненные значения
      */
-    void _load_saved_config();
+    void _load_saved_config(std::unordered_map<std::string, std::string>& config);
     
     /**
-     * @brief Сохраняет текущую конфигурацию
+     * @brief Сохраняет измененные ключи одним вызовом sync
      */
     void _save_config();
     
+    /**
+     * @brief Задает значение ключа в новом снимке и помечает ключ измененным, если значение отличается
+     * @param next Новый снимок (создается копированием текущего при первом изменении)
+     * @param key Ключ
+     * @param value Новое значение
+     */
+    void _set_value(std::shared_ptr<ConfigSnapshot>& next, const std::string& key, const std::string& value);
+    
+    /**
+     * @brief Публикует новый снимок и уведомляет подписчиков
+     * @param next Новый снимок
+     */
+    void _publish(std::shared_ptr<ConfigSnapshot> next);
+    
+    /**
+     * @brief Перезапускает таймер отложенного сохранения
+     */
+    void _schedule_save();
+    
+    /**
+     * @brief Разбирает JSON-список из значений снимка
+     * @param values Значения снимка
+     * @param key Ключ списка
+     * @return Элементы списка (пустой список при ошибке)
+     */
+    static std::vector<std::string> _parse_list(const std::unordered_map<std::string, std::string>& values,
+                                                const std::string& key);
+    
+    /**
+     * @brief Разбирает списки снимка, сброшенные при изменении их ключей
+     * @param snapshot Снимок до публикации
+     */
+    static void _parse_lists(ConfigSnapshot& snapshot);
+    
 private:
     QSettings* settings;
-    std::unordered_map<std::string, std::string> _config;
-    std::vector<std::string> _target_words;
-    std::vector<std::string> _target_patterns;
+    
+    // Текущий снимок: читается и подменяется через std::atomic_load/atomic_store
+    ConfigSnapshotPtr _snapshot;
+    
+    // Подписчики на изменения
+    std::map<int, ChangeCallback> _subscribers;
+    int _next_subscription_id;
+    
+    // Ключи, измененные после последнего сохранения
+    std::unordered_set<std::string> _dirty_keys;
+    QTimer* _save_timer;
 };
 
 } // namespace audiocensor
@@ -0,0 +1,57 @@
+#ifndef AUDIOCENSOR_CONFIG_SNAPSHOT_H
+#define AUDIOCENSOR_CONFIG_SNAPSHOT_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace audiocensor {
+
+/**
+ * @brief Неизменяемый снимок конфигурации
+ *
+ * Снимок не меняется после публикации, поэтому его можно передавать между
+ * потоками без копирования. Номер версии растет при каждом изменении
+ * конфигурации: по нему потребители определяют, что снимок устарел.
+ * Списки target_words и target_patterns разбираются до публикации снимка
+ * (и переиспользуются следующим снимком, если ключ не менялся).
+ */
+struct ConfigSnapshot {
+    uint64_t version = 0;
+    std::unordered_map<std::string, std::string> values;
+    std::shared_ptr<const std::vector<std::string>> target_words;
+    std::shared_ptr<const std::vector<std::string>> target_patterns;
+
+    /**
+     * @brief Возвращает значение ключа
+     * @param key Ключ
+     * @return Значение (std::out_of_range, если ключа нет)
+     */
+    const std::string& at(const std::string& key) const { return values.at(key); }
+
+    /**
+     * @brief Проверяет наличие ключа
+     * @param key Ключ
+     * @return true если ключ есть
+     */
+    bool contains(const std::string& key) const { return values.find(key) != values.end(); }
+
+    /**
+     * @brief Возвращает значение ключа или значение по умолчанию
+     * @param key Ключ
+     * @param default_value Значение, если ключа нет
+     * @return Значение
+     */
+    std::string get(const std::string& key, const std::string& default_value = "") const {
+        auto it = values.find(key);
+        return it != values.end() ? it->second : default_value;
+    }
+};
+
+using ConfigSnapshotPtr = std::shared_ptr<const ConfigSnapshot>;
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_CONFIG_SNAPSHOT_H
@@ -19,6 +19,84 @@ namespace audiocensor {
     constexpr int DEFAULT_BEEP_FREQUENCY = 1000;
     constexpr int DEFAULT_SAFETY_MARGIN = 3;
 
+    // Профиль реального времени для потока обработки (Linux)
+    constexpr int DEFAULT_REALTIME_PRIORITY = 20;
+
+    // Сбои аудио потоков: порог сбоев в окне для увеличения задержки устройств
+    constexpr int DEFAULT_XRUN_THRESHOLD = 5;
+    constexpr int DEFAULT_XRUN_WINDOW_MS = 10000;
+    constexpr int DEFAULT_XRUN_MAX_LATENCY_MS = 250;
+
+    // Отключение устройств: ошибок подряд до переподключения, интервалы переподключения и проверки
+    // списка, интервал пересканирования там, где набор звуковых карт системы не узнать
+    constexpr int DEFAULT_DEVICE_ERROR_THRESHOLD = 5;
+    constexpr int DEFAULT_DEVICE_RECONNECT_INTERVAL_MS = 1000;
+    constexpr int DEFAULT_DEVICE_REFRESH_INTERVAL_MS = 3000;
+    constexpr int DEFAULT_DEVICE_RESCAN_INTERVAL_MS = 15000;
+
+    // Компенсация расхождения часов устройств: коэффициенты ПИ-регулятора (ppm на мс ошибки
+    // и ppm на мс ошибки за секунду), предел коэффициента и время измерения цели
+    constexpr double DEFAULT_DRIFT_KP = 10.0;
+    constexpr double DEFAULT_DRIFT_KI = 0.02;
+    constexpr double DEFAULT_DRIFT_MAX_PPM = 500.0;
+    constexpr int DEFAULT_DRIFT_SETTLE_MS = 5000;
+
+    // Возврат задержки к цели: порог тишины, минимальное превышение и доля чанка, которую можно выбросить
+    constexpr int DEFAULT_CATCHUP_SILENCE_DB = -40;
+    constexpr int DEFAULT_CATCHUP_MIN_EXCESS_MS = 20;
+    constexpr int DEFAULT_CATCHUP_MAX_DROP_PERCENT = 50;
+
+    // Уточнение границ слова: окно поиска вокруг границы, превышение энергии над минимумом окна и запас
+    constexpr int DEFAULT_BOUNDARY_SEARCH_MS = 150;
+    constexpr int DEFAULT_BOUNDARY_THRESHOLD_DB = 12;
+    constexpr int DEFAULT_BOUNDARY_GUARD_MS = 15;
+
+    // Повторное распознавание: порог уверенности, запас окна по краям, глубина кольцевого буфера,
+    // максимальная длина окна и очередь заданий
+    constexpr double DEFAULT_REDECODE_CONFIDENCE = 0.6;
+    constexpr int DEFAULT_REDECODE_PADDING_MS = 250;
+    constexpr int DEFAULT_REDECODE_LOOKBACK_MS = 5000;
+    constexpr int DEFAULT_REDECODE_MAX_WINDOW_MS = 3000;
+    constexpr int DEFAULT_REDECODE_QUEUE_SIZE = 4;
+
+    // Проверка окон моделью проверки: потоки пула и допуск расстояния для почти совпадений
+    constexpr int DEFAULT_VERIFY_WORKERS = 2;
+    constexpr int DEFAULT_VERIFY_NEAR_MISS_DISTANCE = 1;
+
+    // Смена распознавателя на паузе речи после стольких секунд аудио (0 - не менять)
+    constexpr int DEFAULT_RECOGNIZER_CYCLE_S = 900;
+
+    // Эндпоинтер: задержки Vosk (тишина до речи, пауза конца фразы, максимум фразы), нижняя граница
+    // паузы при подстройке, порог речи своей проверки тишины и доля buffer_delay для времени до результата
+    constexpr double DEFAULT_ENDPOINTER_START_MAX_S = 5.0;
+    constexpr int DEFAULT_ENDPOINTER_END_MS = 500;
+    constexpr double DEFAULT_ENDPOINTER_MAX_S = 20.0;
+    constexpr int DEFAULT_ENDPOINTER_MIN_END_MS = 200;
+    constexpr int DEFAULT_ENDPOINTER_SPEECH_DB = -45;
+    constexpr int DEFAULT_ENDPOINTER_BUDGET_PERCENT = 50;
+
+    // Настройки детектора
+    constexpr size_t DEFAULT_DETECTION_CACHE_SIZE = 4096;
+    constexpr int DEFAULT_FUZZY_MAX_DISTANCE = 2;
+
+    // Настройки синхронизации списков слов
+    constexpr long DEFAULT_SYNC_TIMEOUT_MS = 10000;
+    constexpr long DEFAULT_SYNC_CONNECT_TIMEOUT_MS = 3000;
+    constexpr int DEFAULT_SYNC_RETRIES = 3;
+    constexpr long DEFAULT_SYNC_RETRY_DELAY_MS = 500;
+
+    // Задержка сохранения настроек после последнего изменения
+    constexpr int DEFAULT_CONFIG_SAVE_DELAY_MS = 500;
+
+    // Лог событий: записей в памяти, строк в окне и обновлений окна в секунду
+    constexpr size_t DEFAULT_LOG_BUFFER_SIZE = 10000;
+    constexpr int DEFAULT_LOG_VIEW_MAX_LINES = 2000;
+    constexpr int DEFAULT_LOG_FLUSH_FPS = 20;
+
+    // Пределы настроек лога: буфер выделяется целиком при запуске
+    constexpr size_t MAX_LOG_BUFFER_SIZE = 1000000;
+    constexpr int MAX_LOG_FLUSH_FPS = 60;
+
     // Настройки интерфейса
     const std::string APPLICATION_NAME = "Фильтр ненормативной лексики для стриминга";
     constexpr int APPLICATION_WIDTH = 800;
@@ -27,10 +105,16 @@ namespace audiocensor {
     // Настройки лицензии
     const std::string LICENSE_COMPANY = "AudioCensor";
     const std::string LICENSE_APP = "License";
+    constexpr int DEFAULT_LICENSE_OFFLINE_GRACE_DAYS = 7;
+    constexpr int DEFAULT_LICENSE_REVERIFY_HOURS = 24;
+    constexpr long DEFAULT_LICENSE_TIMEOUT_MS = 10000;
+    constexpr long DEFAULT_LICENSE_CONNECT_TIMEOUT_MS = 3000;
 
     // Пути к файлам
     const std::string DEFAULT_MODEL_PATH = "../vosk-model-small-ru-0.22";
     const std::string DEFAULT_LOG_FILE = "censorship_log.txt";
+    const std::string DEFAULT_DICTIONARY_FILE = "dictionary.acd";
+    const std::string DEFAULT_WORD_LIST_CACHE_FILE = "word_lists.cache";
 
     // Список слов по умолчанию (использовать только для тестирования)
     const std::vector<std::string> DEFAULT_TARGET_WORDS = {};
@@ -0,0 +1,117 @@
+#ifndef AUDIOCENSOR_DETECTION_CACHE_H
+#define AUDIOCENSOR_DETECTION_CACHE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <tuple>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace audiocensor {
+
+/**
+ * @brief LRU-кэш результатов проверки слов фиксированного размера
+ *
+ * Ключ - 64-битный хеш нормализованного слова, смешанный с номером
+ * поколения словаря, поэтому при смене словаря старые записи просто
+ * перестают находиться и вытесняются. Все методы потокобезопасны.
+ */
+class DetectionCache {
+public:
+    /**
+     * @brief Конструктор
+     * @param capacity Максимальное количество записей
+     */
+    explicit DetectionCache(size_t capacity = 4096);
+
+    /**
+     * @brief Ищет результат в кэше и помечает запись как недавно использованную
+     * @param key Ключ записи
+     * @param result Найденный результат (заполняется при попадании)
+     * @return true если запись найдена, false в противном случае
+     */
+    bool lookup(uint64_t key, std::tuple<bool, std::string>& result);
+
+    /**
+     * @brief Добавляет результат в кэш, вытесняя самую старую запись при переполнении
+     * @param key Ключ записи
+     * @param result Результат проверки
+     */
+    void insert(uint64_t key, const std::tuple<bool, std::string>& result);
+
+    /**
+     * @brief Очищает кэш и счетчики
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает текущее количество записей
+     * @return Количество записей
+     */
+    size_t size() const;
+
+    /**
+     * @brief Возвращает максимальное количество записей
+     * @return Емкость кэша
+     */
+    size_t capacity() const { return entries.size(); }
+
+    /**
+     * @brief Возвращает количество попаданий
+     * @return Количество попаданий
+     */
+    uint64_t hits() const { return hit_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает количество промахов
+     * @return Количество промахов
+     */
+    uint64_t misses() const { return miss_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Вычисляет ключ кэша
+     * @param normalized_word Нормализованное слово
+     * @param dictionary_generation Номер поколения словаря
+     * @return 64-битный ключ
+     */
+    static uint64_t make_key(const std::string& normalized_word, uint64_t dictionary_generation);
+
+    /**
+     * @brief Быстрый некриптографический хеш строки (FNV-1a, 64 бита)
+     * @param data Исходная строка
+     * @param seed Начальное значение хеша
+     * @return Хеш строки
+     */
+    static uint64_t hash_string(const std::string& data, uint64_t seed = 0xcbf29ce484222325ULL);
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Entry {
+        uint64_t key = 0;
+        bool is_prohibited = false;
+        std::string reason;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+    };
+
+    void _unlink(uint32_t idx);
+    void _push_front(uint32_t idx);
+
+private:
+    std::vector<Entry> entries;
+    std::unordered_map<uint64_t, uint32_t> index;
+    uint32_t head;  // Самая свежая запись
+    uint32_t tail;  // Самая старая запись
+    uint32_t used;
+
+    mutable std::mutex mutex;
+    std::atomic<uint64_t> hit_count;
+    std::atomic<uint64_t> miss_count;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_DETECTION_CACHE_H
@@ -0,0 +1,175 @@
+#ifndef AUDIOCENSOR_DEVICE_CATALOG_H
+#define AUDIOCENSOR_DEVICE_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+namespace audiocensor {
+
+/**
+ * @brief Характеристики аудио устройства
+ */
+struct AudioDeviceInfo {
+    int index = -1;                        // Индекс PortAudio (меняется после пересканирования)
+    std::string name;
+    std::string host_api;
+    int max_input_channels = 0;
+    int max_output_channels = 0;
+    double default_sample_rate = 0.0;
+    double default_low_input_latency = 0.0;
+    double default_low_output_latency = 0.0;
+
+    /**
+     * @brief Возвращает ключ устройства, не зависящий от его индекса
+     * @return Ключ вида "хост-API/имя"
+     */
+    std::string key() const { return host_api + "/" + name; }
+};
+
+/**
+ * @brief Кэш аудио устройств PortAudio с отслеживанием подключения и отключения
+ *
+ * PortAudio составляет список устройств при инициализации, поэтому новые и
+ * отключенные устройства видны только после ее повтора. Повтор закрывает все
+ * потоки, и вызывающий код должен сам закрыть их перед rescan(). Чтобы не
+ * пересканировать впустую, каталог хранит подпись набора звуковых карт
+ * системы (на Linux - /proc/asound/cards) и сообщает, когда она изменилась.
+ * На других платформах подписи нет: пересканирование нужно просто раз в
+ * заданный интервал (см. rescan_due()).
+ *
+ * Устройства между пересканированиями сопоставляются по ключу key(), а не по
+ * индексу. Методы чтения кэша потокобезопасны; initialize(), rescan() и
+ * terminate() вызываются только потоком, которому принадлежат аудио потоки.
+ */
+class DeviceCatalog {
+public:
+    /**
+     * @brief Изменения списка устройств после пересканирования
+     */
+    struct Changes {
+        std::vector<AudioDeviceInfo> added;
+        std::vector<AudioDeviceInfo> removed;
+
+        /**
+         * @brief Проверяет, изменился ли список
+         * @return true если устройства добавлены или удалены
+         */
+        bool any() const { return !added.empty() || !removed.empty(); }
+    };
+
+    /**
+     * @brief Конструктор
+     */
+    DeviceCatalog();
+
+    /**
+     * @brief Деструктор, завершает PortAudio
+     */
+    ~DeviceCatalog();
+
+    DeviceCatalog(const DeviceCatalog&) = delete;
+    DeviceCatalog& operator=(const DeviceCatalog&) = delete;
+
+    /**
+     * @brief Инициализирует PortAudio (если еще не инициализирован) и заполняет кэш
+     * @return true если список устройств получен, false в противном случае (см. error())
+     */
+    bool initialize();
+
+    /**
+     * @brief Повторно инициализирует PortAudio и обновляет кэш
+     *
+     * Все потоки PortAudio должны быть закрыты до вызова.
+     *
+     * @param changes Добавленные и удаленные устройства (может быть nullptr)
+     * @return true если список устройств получен, false в противном случае (см. error())
+     */
+    bool rescan(Changes* changes = nullptr);
+
+    /**
+     * @brief Завершает PortAudio и очищает кэш
+     */
+    void terminate();
+
+    /**
+     * @brief Проверяет, инициализирован ли PortAudio
+     * @return true если инициализирован
+     */
+    bool is_initialized() const;
+
+    /**
+     * @brief Проверяет, пора ли пересканировать устройства
+     *
+     * С подписью набора звуковых карт - когда она изменилась. Без подписи
+     * изменение не обнаружить, поэтому пересканирование нужно, когда с
+     * прошлого сканирования прошло fallback_interval_ms.
+     *
+     * @param fallback_interval_ms Интервал без подписи, мс (0 - не пересканировать)
+     * @return true если пора пересканировать
+     */
+    bool rescan_due(int fallback_interval_ms) const;
+
+    /**
+     * @brief Возвращает номер версии списка; растет при каждом изменении
+     * @return Версия списка
+     */
+    uint64_t generation() const;
+
+    /**
+     * @brief Возвращает копию списка устройств
+     * @return Устройства в порядке индексов
+     */
+    std::vector<AudioDeviceInfo> devices() const;
+
+    /**
+     * @brief Возвращает характеристики устройства по индексу
+     * @param index Индекс PortAudio
+     * @param info Характеристики устройства
+     * @return true если устройство есть в кэше
+     */
+    bool get(int index, AudioDeviceInfo& info) const;
+
+    /**
+     * @brief Ищет устройство по ключу
+     * @param key Ключ устройства (AudioDeviceInfo::key())
+     * @param input true - нужен ввод, false - вывод
+     * @return Индекс PortAudio или -1, если устройство не найдено
+     */
+    int find(const std::string& key, bool input) const;
+
+    /**
+     * @brief Возвращает описание последней ошибки
+     * @return Описание ошибки или пустая строка
+     */
+    std::string error() const;
+
+private:
+    /**
+     * @brief Заполняет кэш из PortAudio и сравнивает его с предыдущим
+     * @param changes Добавленные и удаленные устройства (может быть nullptr)
+     * @return true если список устройств получен
+     */
+    bool _scan(Changes* changes);
+
+    /**
+     * @brief Считывает подпись набора звуковых карт системы
+     * @return Подпись или пустая строка, если она недоступна
+     */
+    static std::string _read_system_signature();
+
+private:
+    mutable std::mutex mutex;
+    std::vector<AudioDeviceInfo> entries;
+    bool initialized;
+    uint64_t generation_value;
+    std::string system_signature;
+    std::chrono::steady_clock::time_point scanned_at;  // Время последнего сканирования
+    std::string error_message;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_DEVICE_CATALOG_H
@@ -0,0 +1,124 @@
+#ifndef AUDIOCENSOR_DRIFT_COMPENSATOR_H
+#define AUDIOCENSOR_DRIFT_COMPENSATOR_H
+
+#include <vector>
+#include <cstddef>
+
+#include "audiocensor/config_snapshot.h"
+
+namespace audiocensor {
+
+/**
+ * @brief Компенсация расхождения часов входного и выходного устройств
+ *
+ * Вход и выход тактируются разными кварцами, поэтому за чанк захвата выход
+ * проигрывает не ровно чанк. Расхождение копится в очередях устройств:
+ * медленный выход заставляет входные сэмплы ждать чтения, быстрый -
+ * опустошает свою очередь. Уровень заполнения конвейера (ожидающий чтения
+ * вход минус свободное место выхода) сглаживается и удерживается на значении,
+ * измеренном после запуска, ПИ-регулятором. Его выход - коэффициент
+ * передискретизации: сколько входных сэмплов приходится на сэмпл выхода.
+ *
+ * Передискретизация - кубическая интерполяция Катмулла-Рома с дробной фазой,
+ * переносимой между чанками; при коэффициенте 1 сигнал передается без
+ * искажений с задержкой в два сэмпла. Коэффициент ограничен drift_max_ppm.
+ *
+ * Объект используется только потоком обработки.
+ */
+class DriftCompensator {
+public:
+    /**
+     * @brief Конструктор
+     * @param config Снимок конфигурации (ключи drift_*)
+     * @param sample_rate Частота дискретизации
+     * @param chunk_size Размер чанка захвата
+     */
+    DriftCompensator(const ConfigSnapshot& config, int sample_rate, int chunk_size);
+
+    /**
+     * @brief Проверяет, включена ли компенсация в конфигурации
+     * @return true если компенсация включена
+     */
+    bool is_enabled() const { return enabled; }
+
+    /**
+     * @brief Сбрасывает регулятор и передискретизацию, включая оценку расхождения
+     */
+    void reset();
+
+    /**
+     * @brief Начинает заново измерение целевого заполнения, сохраняя оценку расхождения
+     *
+     * Вызывается после перезапуска потоков: их очереди начинаются с нуля,
+     * а часы устройств остались прежними.
+     */
+    void restart();
+
+    /**
+     * @brief Учитывает заполнение конвейера после очередного чанка
+     * @param fill_samples Ожидающий чтения вход минус свободное место выхода, сэмплы
+     */
+    void update(double fill_samples);
+
+    /**
+     * @brief Передискретизирует чанк с текущим коэффициентом
+     * @param input Сэмплы входа
+     * @param count Количество сэмплов входа
+     * @param output Сэмплы выхода (перезаписывается, емкость переиспользуется)
+     */
+    void process(const short* input, size_t count, std::vector<short>& output);
+
+    /**
+     * @brief Возвращает текущий коэффициент (входных сэмплов на сэмпл выхода)
+     * @return Коэффициент
+     */
+    double ratio() const { return current_ratio; }
+
+    /**
+     * @brief Возвращает оценку расхождения часов выхода относительно входа
+     * @return Расхождение, ppm (положительное - выход медленнее)
+     */
+    double drift_ppm() const { return integral_ppm; }
+
+    /**
+     * @brief Проверяет, измерено ли целевое заполнение
+     * @return true если регулятор работает
+     */
+    bool is_locked() const { return locked; }
+
+private:
+    /**
+     * @brief Ограничивает значение пределом коэффициента
+     * @param ppm Значение, ppm
+     * @return Ограниченное значение
+     */
+    double _clamp(double ppm) const;
+
+private:
+    // Параметры
+    bool enabled;
+    int sample_rate;
+    double update_interval;   // Длительность чанка, с
+    double kp;                // ppm на мс ошибки
+    double ki;                // ppm на мс ошибки за секунду
+    double max_ppm;
+    size_t settle_updates;
+
+    // Регулятор
+    bool locked;
+    size_t settle_count;
+    double settle_sum;
+    double target_fill;
+    double smoothed_fill;
+    bool has_fill;
+    double integral_ppm;
+    double current_ratio;
+
+    // Передискретизация: необработанный вход и дробная позиция в нем
+    std::vector<float> history;
+    double position;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_DRIFT_COMPENSATOR_H
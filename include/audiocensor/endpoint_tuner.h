@@ -0,0 +1,142 @@
+#ifndef AUDIOCENSOR_ENDPOINT_TUNER_H
+#define AUDIOCENSOR_ENDPOINT_TUNER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "audiocensor/config_snapshot.h"
+
+struct VoskRecognizer;
+
+namespace audiocensor {
+
+/**
+ * @brief Ускорение окончательных результатов распознавания
+ *
+ * Запрещенное слово можно заглушить, только если окончательный результат
+ * с ним пришел раньше, чем слово прозвучит: время до окончательного
+ * результата определяет необходимую buffer_delay.
+ *
+ * Три механизма:
+ * - режим и задержки эндпоинтера Vosk из конфигурации (если библиотека
+ *   их поддерживает, см. HAVE_VOSK_ENDPOINTER);
+ * - своя проверка тишины по уровню чанков: после речи и endpointer_end_ms
+ *   тишины результат запрашивается принудительно, не дожидаясь Vosk;
+ * - подстройка: время от конца последнего слова до окончательного
+ *   результата измеряется, и если 95-й процентиль не укладывается в долю
+ *   buffer_delay, пауза конца фразы сокращается (до endpointer_min_end_ms);
+ *   при большом запасе она возвращается к настроенной.
+ */
+class EndpointTuner {
+public:
+    /**
+     * @brief Конструктор
+     * @param config Снимок конфигурации (ключи endpointer_*, buffer_delay)
+     * @param sample_rate Частота дискретизации
+     */
+    EndpointTuner(const ConfigSnapshot& config, int sample_rate);
+
+    /**
+     * @brief Применяет режим и задержки эндпоинтера к распознавателю
+     * @param recognizer Распознаватель Vosk
+     * @return true если библиотека поддерживает настройку эндпоинтера
+     */
+    bool apply(VoskRecognizer* recognizer) const;
+
+    /**
+     * @brief Учитывает чанк, поданный распознавателю
+     * @param samples Сэмплы чанка
+     * @param count Количество сэмплов
+     * @return true если после речи набралась пауза и результат нужно запросить принудительно
+     */
+    bool process_chunk(const short* samples, size_t count);
+
+    /**
+     * @brief Учитывает окончательный результат
+     * @param latency_samples Сэмплы от конца последнего слова до получения результата (отрицательное - слов нет)
+     * @param forced Результат запрошен принудительно
+     * @return true если подстройка изменила задержки (их нужно применить к распознавателю)
+     */
+    bool on_final(int64_t latency_samples, bool forced);
+
+    /**
+     * @brief Возвращает среднее время до окончательного результата (с последнего изменения паузы)
+     * @return Время, мс (0 - измерений нет)
+     */
+    double mean_ms() const;
+
+    /**
+     * @brief Возвращает медиану времени до окончательного результата
+     * @return Время, мс (0 - измерений нет)
+     */
+    double p50_ms() const { return _percentile_ms(50); }
+
+    /**
+     * @brief Возвращает 95-й процентиль времени до окончательного результата
+     * @return Время, мс (0 - измерений нет)
+     */
+    double p95_ms() const { return _percentile_ms(95); }
+
+    /**
+     * @brief Возвращает текущую паузу конца фразы
+     * @return Пауза, мс
+     */
+    int end_ms() const { return end_silence_ms; }
+
+    /**
+     * @brief Возвращает количество окончательных результатов с создания
+     * @return Количество результатов
+     */
+    uint64_t finals() const { return final_count; }
+
+    /**
+     * @brief Возвращает количество принудительных результатов с создания
+     * @return Количество результатов
+     */
+    uint64_t forced_finals() const { return forced_count; }
+
+private:
+    /**
+     * @brief Вычисляет процентиль по последним измерениям (ближайший ранг)
+     * @param percent Процентиль, 1-100
+     * @return Время, мс (0 - измерений нет)
+     */
+    double _percentile_ms(int percent) const;
+
+    /**
+     * @brief Пересматривает паузу конца фразы по накопленным измерениям
+     * @return true если пауза изменилась
+     */
+    bool _tune();
+
+private:
+    int sample_rate;
+    int mode;                   // Режим эндпоинтера Vosk (0 - по умолчанию)
+    double start_max_s;         // Максимальная тишина до начала речи, с
+    double max_s;               // Максимальная длина фразы, с
+    int configured_end_ms;      // Пауза конца фразы из конфигурации
+    int min_end_ms;
+    int end_silence_ms;         // Текущая пауза (после подстройки)
+    bool force_final;
+    bool auto_tune;
+    double budget_ms;           // Цель для 95-го процентиля
+
+    // Проверка тишины
+    double speech_power;        // Порог уровня речи (средний квадрат сэмпла)
+    bool speech_seen;           // Речь с последнего окончательного результата
+    int64_t silence_samples;    // Тишина после последней речи
+
+    // Последние измерения, кольцевой массив
+    std::vector<double> latencies_ms;
+    size_t latency_next;
+    size_t latency_count;
+    size_t since_tune;
+    mutable std::vector<double> sorted;
+    uint64_t final_count;
+    uint64_t forced_count;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_ENDPOINT_TUNER_H
@@ -0,0 +1,176 @@
+#ifndef AUDIOCENSOR_FUZZY_MATCHER_H
+#define AUDIOCENSOR_FUZZY_MATCHER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace audiocensor {
+
+/**
+ * @brief Нечеткий поиск слов словаря с ограничением на расстояние Левенштейна
+ *
+ * Расстояние считается битово-параллельным алгоритмом Майерса (вариант Хюрё
+ * для полного расстояния между словами): одна итерация на букву словарного
+ * слова, до 64 букв в распознанном слове. Словарь индексируется по длине
+ * и первой букве, поэтому для каждого слова проверяется лишь небольшая
+ * группа кандидатов. Предполагается, что ASR почти не ошибается в первой букве.
+ *
+ * Порог задается для каждого слова суффиксом "~N" (например, "слово~2"),
+ * иначе выбирается по длине слова и ограничивается общим максимумом.
+ */
+class FuzzyMatcher {
+public:
+    /**
+     * @brief Максимальная длина слова в буквах, поддерживаемая алгоритмом
+     */
+    static constexpr size_t MAX_WORD_LENGTH = 64;
+
+    /**
+     * @brief Запись индекса
+     */
+    struct Entry {
+        uint32_t offset;        // Смещение в массиве символов
+        uint8_t length;         // Длина в символах алфавита
+        uint8_t first_symbol;
+        uint8_t max_distance;
+        uint8_t reserved;
+        uint32_t word_index;    // Индекс слова в исходном списке
+    };
+
+    /**
+     * @brief Конструктор
+     */
+    FuzzyMatcher();
+
+    FuzzyMatcher(const FuzzyMatcher&) = delete;
+    FuzzyMatcher& operator=(const FuzzyMatcher&) = delete;
+
+    /**
+     * @brief Строит индекс по списку нормализованных слов
+     * @param normalized_words Нормализованные слова словаря
+     * @param thresholds Пороги для каждого слова (-1 - выбрать по длине)
+     * @param max_distance Общий максимум расстояния
+     */
+    void build(const std::vector<std::string>& normalized_words,
+               const std::vector<int>& thresholds,
+               int max_distance);
+
+    /**
+     * @brief Подключает готовый индекс из внешней памяти (например, отображенного файла)
+     * @param symbol_data Символы всех слов
+     * @param symbol_total Количество символов
+     * @param entry_data Записи индекса, отсортированные как при build()
+     * @param entry_total Количество записей
+     * @param length_offset_data Массив из MAX_WORD_LENGTH + 2 начал групп по длине
+     * @param threshold Максимальный порог среди записей
+     */
+    void attach(const uint8_t* symbol_data, size_t symbol_total,
+                const Entry* entry_data, size_t entry_total,
+                const uint32_t* length_offset_data, int threshold);
+
+    /**
+     * @brief Ищет ближайшее слово словаря в пределах его порога
+     * @param normalized_word Нормализованное проверяемое слово
+     * @param word_index Индекс найденного слова в исходном списке
+     * @param distance Расстояние до найденного слова
+     * @param slack Допуск сверх порога каждого слова (для поиска почти совпадений)
+     * @return true если найдено слово в пределах порога, false в противном случае
+     */
+    bool find(const std::string& normalized_word, uint32_t& word_index, int& distance, int slack = 0) const;
+
+    /**
+     * @brief Очищает индекс
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает количество слов в индексе
+     * @return Количество слов
+     */
+    size_t size() const { return entry_count; }
+
+    /**
+     * @brief Возвращает символы всех слов индекса
+     * @return Указатель на символы
+     */
+    const uint8_t* symbols_data() const { return symbols; }
+
+    /**
+     * @brief Возвращает количество символов
+     * @return Количество символов
+     */
+    size_t symbols_size() const { return symbol_count; }
+
+    /**
+     * @brief Возвращает записи индекса
+     * @return Указатель на записи
+     */
+    const Entry* entries_data() const { return entries; }
+
+    /**
+     * @brief Возвращает начала групп записей по длине (MAX_WORD_LENGTH + 2 значений)
+     * @return Указатель на массив смещений
+     */
+    const uint32_t* length_offsets_data() const { return length_offsets; }
+
+    /**
+     * @brief Возвращает максимальный порог среди записей
+     * @return Порог
+     */
+    int get_max_threshold() const { return max_threshold; }
+
+    /**
+     * @brief Отделяет от записи словаря порог вида "слово~N"
+     * @param entry Запись словаря
+     * @param word Слово без порога
+     * @return Порог или -1, если он не указан
+     */
+    static int parse_threshold(const std::string& entry, std::string& word);
+
+    /**
+     * @brief Порог по умолчанию для слова заданной длины
+     * @param letters Длина слова в буквах
+     * @return Допустимое расстояние
+     */
+    static int default_threshold(size_t letters);
+
+private:
+    /**
+     * @brief Переводит нормализованное слово в строку символов компактного алфавита
+     * @param word Нормализованное слово
+     * @param output Символы алфавита
+     * @return true если длина слова не превышает MAX_WORD_LENGTH
+     */
+    static bool _encode(const std::string& word, std::vector<uint8_t>& output);
+
+    /**
+     * @brief Расстояние Левенштейна между запросом и словом словаря с отсечением
+     * @param peq Битовые маски вхождений символов в запрос
+     * @param query_length Длина запроса
+     * @param text Символы слова словаря
+     * @param text_length Длина слова словаря
+     * @param limit Порог, после которого расчет прерывается
+     * @return Расстояние или limit + 1, если оно больше порога
+     */
+    static int _distance(const uint64_t* peq, size_t query_length,
+                         const uint8_t* text, size_t text_length, int limit);
+
+private:
+    // Собственные данные, если индекс построен через build()
+    std::vector<uint8_t> symbol_storage;
+    std::vector<Entry> entry_storage;           // Отсортированы по (длина, первый символ)
+    std::vector<uint32_t> length_offset_storage; // Начало группы каждой длины в entries
+
+    // Рабочие указатели: на собственные данные или на внешнюю память
+    const uint8_t* symbols;
+    size_t symbol_count;
+    const Entry* entries;
+    size_t entry_count;
+    const uint32_t* length_offsets;
+    int max_threshold;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_FUZZY_MATCHER_H
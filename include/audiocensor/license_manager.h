@@ -4,6 +4,9 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <cstdint>
 
 #include <QObject>
 #include <QSettings>
@@ -12,6 +15,11 @@ namespace audiocensor {
 
 /**
  * @brief Менеджер лицензий для приложения аудиоцензора с улучшенной защитой
+ *
+ * Состояние лицензии при запуске берется из локального кэша, подписанного
+ * HMAC с ключом, привязанным к устройству, поэтому запуск не ждет сети.
+ * Онлайн-проверка выполняется в фоне; без связи с сервером лицензия остается
+ * действительной в течение offline_grace_days с последней успешной проверки.
  */
 class LicenseManager : public QObject {
     Q_OBJECT
@@ -28,6 +36,13 @@ public:
      */
     ~LicenseManager();
     
+    /**
+     * @brief Применяет настройки проверки лицензии
+     * @param config Конфигурация (license_api_url, license_offline_grace_days,
+     *               license_reverify_hours, license_timeout_ms, license_connect_timeout_ms)
+     */
+    void apply_config(const std::unordered_map<std::string, std::string>& config);
+    
     /**
      * @brief Полностью очищает все данные о лицензии
      */
@@ -66,12 +81,40 @@ public:
     bool has_valid_license();
     
     /**
-     * @brief Проверяет лицензионный ключ онлайн через API
+     * @brief Проверяет лицензионный ключ онлайн через API (блокирующий запрос)
      * @param key Лицензионный ключ для проверки
      * @return true если ключ действителен, false в противном случае
      */
     bool verify_license_online(const std::string& key);
     
+    /**
+     * @brief Запускает онлайн-проверку текущей лицензии в фоновом потоке
+     *
+     * Результат применяется в потоке объекта и сообщается сигналом licenseVerified.
+     *
+     * @return true если проверка запущена, false если ключа нет или проверка уже идет
+     */
+    bool start_background_verification();
+    
+    /**
+     * @brief Проверяет, идет ли фоновая онлайн-проверка лицензии
+     * @return true если результат еще придет сигналом licenseVerified
+     */
+    bool is_verification_running() const { return verification_running; }
+    
+    /**
+     * @brief Проверяет, пора ли подтвердить лицензию на сервере
+     * @return true если кэша нет, его подпись не совпала или с последней успешной
+     *         проверки прошло больше license_reverify_hours
+     */
+    bool needs_online_verification() const;
+    
+    /**
+     * @brief Проверяет, что лицензия подтверждена сервером не раньше, чем offline_grace_days назад
+     * @return true если локальному состоянию лицензии можно доверять без сети
+     */
+    bool is_within_offline_grace() const;
+    
     /**
      * @brief Очищает сохраненную лицензию
      */
@@ -109,7 +152,67 @@ public:
      */
     std::string get_telegram_contact() const { return telegram_contact; }
     
+signals:
+    /**
+     * @brief Сигнал о завершении фоновой онлайн-проверки
+     * @param valid Лицензия действительна (в том числе по кэшу, если сервер недоступен)
+     * @param message Описание результата
+     */
+    void licenseVerified(bool valid, const QString& message);
+    
 private:
+    /**
+     * @brief Результат запроса к серверу проверки
+     */
+    struct VerificationResponse {
+        bool received = false;   // Ответ получен (нет сетевой ошибки)
+        long http_code = 0;
+        std::string body;
+        std::string error;
+    };
+    
+    /**
+     * @brief Формирует тело запроса проверки лицензии
+     * @param key Лицензионный ключ
+     * @return JSON-строка запроса
+     */
+    std::string _build_verification_payload(const std::string& key);
+    
+    /**
+     * @brief Отправляет JSON POST-запрос (безопасно вызывать из фонового потока)
+     * @param url Адрес запроса
+     * @param payload Тело запроса
+     * @return Ответ сервера или описание сетевой ошибки
+     */
+    VerificationResponse _post_json(const std::string& url, const std::string& payload) const;
+    
+    /**
+     * @brief Применяет ответ сервера проверки к локальному состоянию
+     * @param key Проверяемый ключ
+     * @param response Ответ сервера
+     * @param message Описание результата
+     * @return true если лицензия действительна
+     */
+    bool _apply_verification(const std::string& key, const VerificationResponse& response,
+                             std::string& message);
+    
+    /**
+     * @brief Загружает подписанный кэш состояния лицензии
+     */
+    void _load_cache();
+    
+    /**
+     * @brief Сохраняет подписанный кэш состояния лицензии
+     */
+    void _save_cache();
+    
+    /**
+     * @brief Вычисляет подпись кэша
+     * @param payload Содержимое кэша
+     * @return Подпись HMAC-SHA256
+     */
+    std::string _cache_signature(const std::string& payload) const;
+    
     /**
      * @brief Проверяет окружение запуска приложения
      */
@@ -152,6 +255,22 @@ private:
     std::string trial_url;
     std::string words_api_url;
     std::string telegram_contact;
+    
+    // Подписанный кэш: время последней успешной онлайн-проверки
+    std::string machine_id;
+    int64_t verified_at;
+    bool cache_trusted;
+    
+    // Настройки онлайн-проверки
+    int offline_grace_days;
+    int reverify_hours;
+    long timeout_ms;
+    long connect_timeout_ms;
+    
+    // Фоновая проверка
+    std::thread verification_worker;
+    std::atomic<bool> verification_running;
+    std::atomic<bool> shutting_down;
 };
 
 } // namespace audiocensor
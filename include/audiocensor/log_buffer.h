@@ -0,0 +1,109 @@
+#ifndef AUDIOCENSOR_LOG_BUFFER_H
+#define AUDIOCENSOR_LOG_BUFFER_H
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+
+namespace audiocensor {
+
+/**
+ * @brief Кольцевой буфер записей лога фиксированного размера
+ *
+ * При переполнении самая старая запись вытесняется, а ее строка
+ * переиспользуется для новой, поэтому память буфера ограничена емкостью
+ * и в установившемся режиме не растет. Каждая запись получает сквозной
+ * номер: по нему потребитель (например, окно лога) забирает только
+ * записи, добавленные после предыдущего чтения.
+ *
+ * Время хранится числом и форматируется только при выводе.
+ * Класс не потокобезопасен.
+ */
+class LogBuffer {
+public:
+    /**
+     * @brief Запись лога
+     */
+    struct Entry {
+        uint64_t sequence = 0;
+        std::time_t timestamp = 0;
+        std::string message;
+    };
+
+    /**
+     * @brief Конструктор
+     * @param capacity Максимальное количество хранимых записей
+     */
+    explicit LogBuffer(size_t capacity);
+
+    /**
+     * @brief Добавляет запись, вытесняя самую старую при переполнении
+     * @param timestamp Время записи
+     * @param message Текст сообщения
+     * @return Номер добавленной записи
+     */
+    uint64_t append(std::time_t timestamp, const std::string& message);
+
+    /**
+     * @brief Удаляет все записи (нумерация продолжается)
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает количество хранимых записей
+     * @return Количество записей
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Возвращает максимальное количество записей
+     * @return Емкость буфера
+     */
+    size_t capacity() const { return entries.size(); }
+
+    /**
+     * @brief Возвращает номер, который получит следующая запись
+     * @return Номер следующей записи
+     */
+    uint64_t next_sequence() const { return next; }
+
+    /**
+     * @brief Возвращает номер самой старой хранимой записи
+     * @return Номер записи (равен next_sequence(), если буфер пуст)
+     */
+    uint64_t first_sequence() const { return next - count; }
+
+    /**
+     * @brief Обходит хранимые записи с номером не меньше заданного, от старых к новым
+     * @param sequence Номер первой нужной записи
+     * @param callback Обработчик, принимающий const Entry&
+     */
+    template <typename Callback>
+    void for_each_since(uint64_t sequence, Callback&& callback) const {
+        uint64_t first = first_sequence();
+        if (sequence < first) {
+            sequence = first;
+        }
+        for (uint64_t current = sequence; current < next; ++current) {
+            callback(entries[current % entries.size()]);
+        }
+    }
+
+    /**
+     * @brief Форматирует запись в строку вида "[чч:мм:сс] сообщение"
+     * @param entry Запись
+     * @param output Буфер результата (строка дописывается в конец)
+     */
+    static void format_entry(const Entry& entry, std::string& output);
+
+private:
+    std::vector<Entry> entries;
+    size_t count;
+    uint64_t next;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_LOG_BUFFER_H
@@ -0,0 +1,79 @@
+#ifndef AUDIOCENSOR_LOOKBACK_RING_H
+#define AUDIOCENSOR_LOOKBACK_RING_H
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace audiocensor {
+
+/**
+ * @brief Кольцевой буфер последних сэмплов захвата для повторного распознавания
+ *
+ * Память выделяется один раз в конструкторе. Сэмплы адресуются индексами
+ * захвата (та же шкала, что у буфера задержки и регионов цензуры), поэтому
+ * окно слова читается по индексам из результата распознавания. Запись
+ * вытесняет самые старые сэмплы.
+ *
+ * Пишет поток обработки, читает поток повторного распознавания: обе операции
+ * копируют сэмплы под внутренней блокировкой.
+ */
+class LookbackRing {
+public:
+    /**
+     * @brief Конструктор
+     * @param capacity Емкость, сэмплы
+     */
+    explicit LookbackRing(size_t capacity);
+
+    /**
+     * @brief Очищает буфер
+     * @param first_index Индекс захвата следующего записанного сэмпла
+     */
+    void reset(int64_t first_index);
+
+    /**
+     * @brief Добавляет сэмплы
+     * @param samples Сэмплы (nullptr - тишина)
+     * @param count Количество сэмплов
+     */
+    void write(const short* samples, size_t count);
+
+    /**
+     * @brief Копирует сэмплы по индексам захвата
+     * @param first_index Индекс захвата первого сэмпла
+     * @param count Количество сэмплов
+     * @param output Буфер для сэмплов (не меньше count)
+     * @return true если все сэмплы еще в буфере
+     */
+    bool read(int64_t first_index, size_t count, short* output) const;
+
+    /**
+     * @brief Возвращает индекс захвата самого старого сэмпла в буфере
+     * @return Индекс захвата
+     */
+    int64_t first_index() const;
+
+    /**
+     * @brief Возвращает индекс захвата следующего записываемого сэмпла
+     * @return Индекс захвата
+     */
+    int64_t end_index() const;
+
+    /**
+     * @brief Возвращает емкость буфера
+     * @return Емкость, сэмплы
+     */
+    size_t capacity() const { return data.size(); }
+
+private:
+    mutable std::mutex mutex;
+    std::vector<short> data;
+    int64_t end;     // Индекс захвата следующего сэмпла
+    size_t filled;   // Сколько сэмплов до end хранится в буфере
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_LOOKBACK_RING_H
@@ -0,0 +1,149 @@
+#ifndef AUDIOCENSOR_MORPH_INDEX_H
+#define AUDIOCENSOR_MORPH_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace audiocensor {
+
+/**
+ * @brief Морфологический индекс для поиска словоформ без регулярных выражений
+ *
+ * Из каждого слова словаря отбрасывается самое длинное окончание из таблицы
+ * русских окончаний, оставшаяся основа помещается в префиксное дерево.
+ * Проверяемое слово сопоставляется за один проход по дереву основ (для каждого
+ * варианта приставки): после найденной основы остаток должен состоять из
+ * суффикса и/или окончания из таблицы. Так одна запись "слово" покрывает
+ * падежные, глагольные и приставочные формы, которые раньше требовали паттернов.
+ *
+ * Все три дерева (основы, окончания, приставки) хранятся в одном плоском
+ * массиве узлов, чтобы индекс можно было сериализовать как есть.
+ */
+class MorphIndex {
+public:
+    /**
+     * @brief Узел префиксного дерева (левый ребенок - правый брат)
+     */
+    struct Node {
+        uint32_t first_child;
+        uint32_t next_sibling;
+        uint32_t word_index;    // Индекс слова словаря для терминальной основы
+        uint8_t byte;
+        uint8_t terminal;
+        uint16_t reserved;
+    };
+
+    /**
+     * @brief Минимальная длина основы в буквах
+     *
+     * Трехбуквенные основы совпадают с началами слишком многих обычных слов
+     * (сук-а и сук, суков), поэтому короткие слова проверяются без словоформ.
+     */
+    static constexpr size_t MIN_STEM_LETTERS = 4;
+
+    /**
+     * @brief Конструктор
+     */
+    MorphIndex();
+
+    MorphIndex(const MorphIndex&) = delete;
+    MorphIndex& operator=(const MorphIndex&) = delete;
+
+    /**
+     * @brief Строит индекс по списку нормализованных слов
+     * @param normalized_words Нормализованные слова словаря
+     */
+    void build(const std::vector<std::string>& normalized_words);
+
+    /**
+     * @brief Подключает готовые узлы из внешней памяти (например, отображенного файла)
+     * @param node_data Узлы, сохраненные из get_nodes()
+     * @param nodes_total Количество узлов
+     * @param stems Количество основ
+     * @return true если массив содержит корни всех трех деревьев
+     */
+    bool attach(const Node* node_data, size_t nodes_total, size_t stems);
+
+    /**
+     * @brief Ищет слово словаря, формой которого является проверяемое слово
+     * @param normalized_word Нормализованное проверяемое слово
+     * @param word_index Индекс найденного слова словаря
+     * @return true если слово является формой слова словаря, false в противном случае
+     */
+    bool find(const std::string& normalized_word, uint32_t& word_index) const;
+
+    /**
+     * @brief Очищает индекс
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает количество основ в индексе
+     * @return Количество основ
+     */
+    size_t size() const { return stem_count; }
+
+    /**
+     * @brief Возвращает узлы всех деревьев индекса
+     * @return Указатель на узлы
+     */
+    const Node* get_nodes() const { return nodes; }
+
+    /**
+     * @brief Возвращает количество узлов
+     * @return Количество узлов
+     */
+    size_t get_node_count() const { return node_count; }
+
+private:
+    // Корни деревьев в массиве nodes
+    static constexpr uint32_t STEMS_ROOT = 0;
+    static constexpr uint32_t ENDINGS_ROOT = 1;
+    static constexpr uint32_t PREFIXES_ROOT = 2;
+    static constexpr size_t ROOT_COUNT = 3;
+    static constexpr uint32_t NO_NODE = 0xFFFFFFFFu;
+
+    /**
+     * @brief Добавляет строку в дерево
+     * @param root Корень дерева
+     * @param value Строка
+     * @param word_index Индекс слова для терминального узла
+     * @return true если строка добавлена впервые
+     */
+    bool _insert(uint32_t root, const std::string& value, uint32_t word_index);
+
+    /**
+     * @brief Находит ребенка узла с заданным байтом
+     * @param node Узел
+     * @param byte Байт
+     * @return Индекс ребенка или NO_NODE
+     */
+    uint32_t _child(uint32_t node, uint8_t byte) const;
+
+    /**
+     * @brief Проверяет, что остаток слова состоит не более чем из двух аффиксов
+     * @param data Начало остатка
+     * @param end Конец слова
+     * @param depth Сколько аффиксов еще можно отбросить
+     * @return true если остаток допустим
+     */
+    bool _accepts_tail(const char* data, const char* end, int depth) const;
+
+    /**
+     * @brief Отбрасывает самое длинное окончание, сохраняя основу не короче MIN_STEM_LETTERS
+     * @param word Нормализованное слово
+     * @return Основа слова
+     */
+    std::string _stem(const std::string& word) const;
+
+private:
+    std::vector<Node> node_storage;     // Собственные узлы, если индекс построен через build()
+    const Node* nodes;                  // Рабочие узлы: собственные или во внешней памяти
+    size_t node_count;
+    size_t stem_count;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_MORPH_INDEX_H
@@ -0,0 +1,114 @@
+#ifndef AUDIOCENSOR_REALTIME_PROFILE_H
+#define AUDIOCENSOR_REALTIME_PROFILE_H
+
+#include <string>
+#include <vector>
+
+#include "audiocensor/config_snapshot.h"
+
+namespace audiocensor {
+
+/**
+ * @brief Профиль реального времени для потока обработки аудио (Linux)
+ *
+ * По настройкам конфигурации переводит текущий поток в планировщик
+ * SCHED_FIFO или SCHED_RR, закрепляет его за выбранными ядрами и блокирует
+ * в памяти уже загруженные страницы (модель распознавания, буфер задержки),
+ * чтобы они не вытеснялись в своп.
+ *
+ * Каждый шаг выполняется независимо: если для него не хватает прав
+ * (CAP_SYS_NICE, CAP_IPC_LOCK, ulimit -r / -l), шаг пропускается, поток
+ * продолжает работать с обычными настройками, а в отчете указывается причина.
+ * На других платформах профиль не применяется.
+ */
+class RealtimeProfile {
+public:
+    /**
+     * @brief Результат одного шага профиля
+     */
+    struct Step {
+        bool applied = false;
+        std::string message;
+    };
+
+    /**
+     * @brief Конструктор
+     * @param config Снимок конфигурации (ключи realtime_*)
+     */
+    explicit RealtimeProfile(const ConfigSnapshot& config);
+
+    /**
+     * @brief Деструктор, снимает блокировку памяти
+     */
+    ~RealtimeProfile();
+
+    RealtimeProfile(const RealtimeProfile&) = delete;
+    RealtimeProfile& operator=(const RealtimeProfile&) = delete;
+
+    /**
+     * @brief Проверяет, включен ли профиль в конфигурации
+     * @return true если профиль включен
+     */
+    bool is_enabled() const { return enabled; }
+
+    /**
+     * @brief Применяет профиль к вызывающему потоку
+     * @param steps Отчет по каждому шагу
+     * @return true если все запрошенные шаги применены
+     */
+    bool apply_to_current_thread(std::vector<Step>& steps);
+
+    /**
+     * @brief Переводит вызывающий поток в обычный планировщик без привязки к ядрам
+     *
+     * Потоки, созданные из потока с профилем, наследуют его политику и ядра.
+     * Фоновые потоки (повторное распознавание, сборка запасного распознавателя)
+     * вызывают этот метод при запуске, чтобы не вытеснять обработку аудио.
+     * Блокировка памяти действует на весь процесс и не снимается.
+     */
+    static void apply_background_to_current_thread();
+
+    /**
+     * @brief Снимает блокировку памяти, если она была установлена
+     */
+    void release();
+
+private:
+    /**
+     * @brief Устанавливает политику и приоритет планировщика
+     * @return Результат шага
+     */
+    Step _apply_scheduling();
+
+    /**
+     * @brief Закрепляет поток за выбранными ядрами
+     * @return Результат шага
+     */
+    Step _apply_affinity();
+
+    /**
+     * @brief Блокирует страницы процесса в памяти
+     * @return Результат шага
+     */
+    Step _lock_memory();
+
+    /**
+     * @brief Разбирает список ядер вида "2,3" или "2-5,7"
+     * @param spec Строка со списком
+     * @param cpus Номера ядер
+     * @return true если строка корректна
+     */
+    static bool _parse_cpu_list(const std::string& spec, std::vector<int>& cpus);
+
+private:
+    bool enabled;
+    std::string policy;
+    int priority;
+    std::string cpu_spec;
+    bool lock_memory;
+    bool memory_locked;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_REALTIME_PROFILE_H
@@ -0,0 +1,185 @@
+#ifndef AUDIOCENSOR_RECOGNITION_RESULT_H
+#define AUDIOCENSOR_RECOGNITION_RESULT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace audiocensor {
+
+/**
+ * @brief Слово из результата распознавания
+ */
+struct RecognizedWord {
+    std::string word;
+    double start = 0.0;
+    double end = 0.0;
+    double conf = 0.0;
+};
+
+/**
+ * @brief Потоковый разбор итогового результата Vosk
+ *
+ * Разбирает JSON вида
+ *   {"result": [{"conf": 1.0, "end": 1.11, "start": 0.87, "word": "..."}, ...],
+ *    "text": "..."}
+ * за один проход без построения дерева документа. Слова записываются в
+ * массив, который переиспользуется между вызовами вместе с буферами строк,
+ * поэтому в установившемся режиме разбор не выделяет память.
+ *
+ * Неизвестные поля пропускаются. Элементы "result" без строкового поля "word"
+ * отбрасываются, нечисловые "start", "end" и "conf" считаются равными 0.
+ * Числа разбираются без учета локали.
+ *
+ * Объект не потокобезопасен: у каждого потока должен быть свой экземпляр.
+ */
+class RecognitionResultParser {
+public:
+    /**
+     * @brief Конструктор
+     * @param reserve_words Количество слов, под которое заранее выделяется память
+     */
+    explicit RecognitionResultParser(size_t reserve_words = 64);
+
+    /**
+     * @brief Разбирает результат распознавания
+     * @param data Текст JSON
+     * @param size Длина текста
+     * @return true если документ корректен, false в противном случае (см. error())
+     */
+    bool parse(const char* data, size_t size);
+
+    /**
+     * @brief Разбирает результат распознавания
+     * @param json Текст JSON
+     * @return true если документ корректен, false в противном случае (см. error())
+     */
+    bool parse(const std::string& json) { return parse(json.data(), json.size()); }
+
+    /**
+     * @brief Возвращает количество слов последнего разобранного результата
+     * @return Количество слов
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Проверяет, есть ли слова в последнем разобранном результате
+     * @return true если слов нет
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Возвращает слово по индексу
+     * @param index Индекс слова (меньше size())
+     * @return Слово
+     */
+    const RecognizedWord& operator[](size_t index) const { return words[index]; }
+
+    /**
+     * @brief Итераторы по словам последнего разобранного результата
+     */
+    const RecognizedWord* begin() const { return words.data(); }
+    const RecognizedWord* end() const { return words.data() + count; }
+
+    /**
+     * @brief Проверяет, было ли в результате поле "result"
+     * @return true если поле было и содержало массив
+     */
+    bool has_result() const { return result_found; }
+
+    /**
+     * @brief Возвращает полный текст результата (поле "text")
+     * @return Текст или пустая строка
+     */
+    const std::string& text() const { return text_value; }
+
+    /**
+     * @brief Возвращает описание ошибки последнего разбора
+     * @return Описание ошибки или пустая строка
+     */
+    const std::string& error() const { return error_message; }
+
+private:
+    /**
+     * @brief Разбирает объект верхнего уровня
+     * @return true если документ корректен
+     */
+    bool _parse_document();
+
+    /**
+     * @brief Разбирает массив "result" в массив слов
+     * @return true если массив корректен
+     */
+    bool _parse_result_array();
+
+    /**
+     * @brief Разбирает описание одного слова
+     * @param word Запись для заполнения
+     * @param has_word Устанавливается, если найдено строковое поле "word"
+     * @return true если объект корректен
+     */
+    bool _parse_word_object(RecognizedWord& word, bool& has_word);
+
+    /**
+     * @brief Разбирает строку с раскрытием escape-последовательностей
+     * @param output Буфер результата (переиспользуется)
+     * @return true если строка корректна
+     */
+    bool _parse_string(std::string& output);
+
+    /**
+     * @brief Разбирает число без учета локали
+     * @param value Результат
+     * @return true если число корректно
+     */
+    bool _parse_number(double& value);
+
+    /**
+     * @brief Пропускает значение любого типа, не сохраняя его
+     * @return true если значение корректно
+     */
+    bool _skip_value();
+
+    /**
+     * @brief Пропускает строку без раскрытия escape-последовательностей
+     * @return true если строка корректна
+     */
+    bool _skip_string();
+
+    /**
+     * @brief Пропускает ожидаемый символ
+     * @param c Символ
+     * @return true если текущий символ совпал
+     */
+    bool _expect(char c);
+
+    /**
+     * @brief Пропускает пробельные символы
+     */
+    void _skip_whitespace();
+
+    /**
+     * @brief Запоминает описание ошибки с позицией
+     * @param message Описание ошибки
+     * @return Всегда false
+     */
+    bool _fail(const char* message);
+
+private:
+    // Массив слов растет только вверх; count - число слов текущего результата
+    std::vector<RecognizedWord> words;
+    size_t count;
+    std::string text_value;
+    std::string key_buffer;
+    bool result_found;
+    std::string error_message;
+
+    // Состояние текущего разбора
+    const char* cursor;
+    const char* limit;
+    const char* origin;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_RECOGNITION_RESULT_H
@@ -0,0 +1,213 @@
+#ifndef AUDIOCENSOR_REDECODE_WORKER_H
+#define AUDIOCENSOR_REDECODE_WORKER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "audiocensor/recognition_result.h"
+
+struct VoskModel;
+struct VoskRecognizer;
+
+namespace audiocensor {
+
+class LookbackRing;
+
+/**
+ * @brief Повторное распознавание подозрительных окон вторым распознавателем
+ *
+ * Основной распознаватель выдает слова с низкой уверенностью или "[unk]"
+ * там, где слово могло быть запрещенным. Такое окно (слово с запасом по
+ * краям) ставится в очередь; пул потоков читает его из кольцевого буфера
+ * и распознает заново. Модель может быть больше и точнее потоковой: она
+ * тратит процессор только на подозрительные окна, а не на весь поток.
+ *
+ * У каждого потока свой распознаватель на общей модели. Окно должно быть
+ * распознано до того, как оно прозвучит: задания выбираются по ближайшему
+ * сроку, опоздавшие отбрасываются без распознавания.
+ *
+ * Результаты забирает поток обработки через take_result(): проверка слов
+ * детектором и добавление регионов цензуры остаются в нем. Очереди заданий
+ * и результатов ограничены, лишние задания отбрасываются.
+ */
+class RedecodeWorker {
+public:
+    /**
+     * @brief Окно для повторного распознавания
+     */
+    struct Job {
+        int64_t first_sample = 0;   // Индекс захвата начала окна
+        size_t count = 0;           // Длина окна, сэмплы
+        std::string word;           // Слово основного распознавателя
+        std::chrono::steady_clock::time_point deadline;  // Когда окно начнет звучать на выходе
+    };
+
+    /**
+     * @brief Слово повторного распознавания на шкале захвата
+     */
+    struct Word {
+        std::string word;
+        int64_t first_sample = 0;
+        int64_t last_sample = 0;
+        double conf = 0.0;
+    };
+
+    /**
+     * @brief Результат повторного распознавания окна
+     */
+    struct Result {
+        Job job;
+        std::vector<Word> words;
+    };
+
+    /**
+     * @brief Конструктор
+     * @param model Модель Vosk (основная или отдельная модель проверки)
+     * @param sample_rate Частота дискретизации
+     * @param ring Кольцевой буфер с аудио (должен пережить объект)
+     * @param max_window Максимальная длина окна, сэмплы
+     * @param queue_limit Максимальная длина очередей заданий и результатов
+     * @param thread_count Количество потоков (распознавателей)
+     * @param cycle_samples Распознаватель потока пересоздается после стольких сэмплов (0 - никогда)
+     */
+    RedecodeWorker(std::shared_ptr<VoskModel> model, int sample_rate, const LookbackRing& ring,
+                   size_t max_window, size_t queue_limit, size_t thread_count, int64_t cycle_samples);
+
+    /**
+     * @brief Деструктор, останавливает поток
+     */
+    ~RedecodeWorker();
+
+    RedecodeWorker(const RedecodeWorker&) = delete;
+    RedecodeWorker& operator=(const RedecodeWorker&) = delete;
+
+    /**
+     * @brief Создает распознаватели и запускает потоки
+     * @return true если запущен хотя бы один поток
+     */
+    bool start();
+
+    /**
+     * @brief Останавливает потоки и очищает очереди
+     */
+    void stop();
+
+    /**
+     * @brief Ставит окно в очередь
+     * @param job Окно
+     * @return false если очередь заполнена или окно длиннее max_window
+     */
+    bool submit(const Job& job);
+
+    /**
+     * @brief Забирает готовый результат, не блокируя поток
+     * @param result Результат
+     * @return true если результат был
+     */
+    bool take_result(Result& result);
+
+    /**
+     * @brief Возвращает количество отброшенных заданий (очередь полна или аудио уже вытеснено)
+     * @return Количество заданий
+     */
+    uint64_t dropped() const { return dropped_jobs; }
+
+    /**
+     * @brief Возвращает количество заданий, не начатых до своего срока
+     * @return Количество заданий
+     */
+    uint64_t expired() const { return expired_jobs; }
+
+    /**
+     * @brief Возвращает количество распознанных окон
+     * @return Количество окон
+     */
+    uint64_t decoded() const { return decoded_jobs; }
+
+    /**
+     * @brief Возвращает суммарную длину распознанных окон
+     * @return Количество сэмплов
+     */
+    uint64_t decoded_samples() const { return decoded_sample_count; }
+
+    /**
+     * @brief Возвращает количество запущенных потоков
+     * @return Количество потоков
+     */
+    size_t thread_count() const { return decoders.size(); }
+
+private:
+    /**
+     * @brief Распознаватель одного потока с переиспользуемыми буферами
+     */
+    struct Decoder {
+        std::shared_ptr<VoskRecognizer> recognizer;
+        int64_t samples_fed = 0;   // Время распознавателя продолжается между окнами
+        std::vector<short> window;
+        RecognitionResultParser parser;
+    };
+
+    /**
+     * @brief Основной цикл потока
+     * @param decoder Распознаватель потока
+     */
+    void _run(Decoder& decoder);
+
+    /**
+     * @brief Извлекает из очереди задание с ближайшим сроком
+     * @return Задание
+     */
+    Job _take_earliest_job();
+
+    /**
+     * @brief Распознает окно
+     * @param decoder Распознаватель потока
+     * @param job Окно
+     * @param result Результат
+     * @return true если окно распознано
+     */
+    bool _decode(Decoder& decoder, const Job& job, Result& result);
+
+    /**
+     * @brief Создает распознаватель потока заново
+     * @param decoder Распознаватель потока
+     * @return true если распознаватель создан
+     */
+    bool _create_recognizer(Decoder& decoder);
+
+private:
+    std::shared_ptr<VoskModel> model;
+    int sample_rate;
+    const LookbackRing& ring;
+    size_t max_window;
+    size_t queue_limit;
+    size_t requested_threads;
+    int64_t cycle_samples;
+
+    // Распознаватели создаются в start(); адреса не меняются, пока работают потоки
+    std::vector<std::unique_ptr<Decoder>> decoders;
+
+    // Очереди и потоки
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Job> jobs;
+    std::deque<Result> results;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> dropped_jobs;
+    std::atomic<uint64_t> expired_jobs;
+    std::atomic<uint64_t> decoded_jobs;
+    std::atomic<uint64_t> decoded_sample_count;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_REDECODE_WORKER_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <chrono>
+#include <cstddef>
 
 namespace audiocensor {
 namespace security {
@@ -21,6 +22,13 @@ std::string obscure_str(const std::string& s);
  */
 std::string deobscure_str(const std::string& s);
 
+/**
+ * @brief Обфусцирует или восстанавливает байты на месте (тем же способом, что obscure_str)
+ * @param data Байты
+ * @param size Количество байт
+ */
+void obscure_bytes(char* data, size_t size);
+
 /**
  * @brief Обфусцирует числовое значение
  * @param n Исходное число
@@ -63,20 +71,35 @@ bool is_running_as_executable();
 
 /**
  * @brief Вычисляет хеш файла
+ *
+ * Файл отображается в память и хешируется целиком; результат запоминается
+ * по устройству, inode, размеру и времени изменения файла, поэтому повторный
+ * вызов для неизменного файла стоит одного stat.
+ *
  * @param file_path Путь к файлу
- * @param block_size Размер блока для чтения
- * @return Хеш в формате SHA-256
+ * @param block_size Размер блока для чтения, если файл не удалось отобразить
+ * @return Хеш в формате SHA-256 (пустая строка при ошибке)
  */
 std::string calculate_file_hash(const std::string& file_path, size_t block_size = 65536);
 
+/**
+ * @brief Возвращает путь к исполняемому файлу (определяется один раз)
+ * @return Путь в UTF-8 или пустая строка при ошибке
+ */
+std::string get_executable_path();
+
 /**
  * @brief Проверяет целостность исполняемого файла
+ *
+ * Не блокирует вызывающий поток: хеш считается в фоновом потоке, пока он не
+ * готов, используется последний результат.
+ *
  * @return true если файл не модифицирован, false в противном случае
  */
 bool check_executable_integrity();
 
 /**
- * @brief Создает уникальный идентификатор устройства
+ * @brief Создает уникальный идентификатор устройства (вычисляется один раз)
  * @return Уникальный ID устройства
  */
 std::string get_machine_id();
@@ -87,6 +110,14 @@ std::string get_machine_id();
  */
 std::string get_hardware_salt();
 
+/**
+ * @brief Вычисляет HMAC-SHA256
+ * @param key Ключ
+ * @param data Подписываемые данные
+ * @return Подпись в шестнадцатеричном формате (пустая строка при ошибке)
+ */
+std::string hmac_sha256(const std::string& key, const std::string& data);
+
 /**
  * @brief Комплексная проверка окружения
  * @return true если окружение безопасно, false в противном случае
@@ -0,0 +1,93 @@
+#ifndef AUDIOCENSOR_SILENCE_COMPRESSOR_H
+#define AUDIOCENSOR_SILENCE_COMPRESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "audiocensor/config_snapshot.h"
+
+namespace audiocensor {
+
+/**
+ * @brief Возврат задержки к цели за счет пауз в задержанном аудио
+ *
+ * После сбоев, переподключения устройств или увеличения их задержки буфер
+ * задержки хранит больше цели, и лишнее остается в нем навсегда: за чанк
+ * захвата воспроизводится ровно чанк. Пока есть превышение, из очередного
+ * чанка выхода выбрасываются тихие кадры (среднеквадратичный уровень ниже
+ * catchup_silence_db), вместо них на выход идут следующие сэмплы буфера.
+ * Кадр выбрасывается, только если соседние кадры тоже тихие, чтобы не
+ * задеть начало и конец слов; стык сглаживается коротким переходом.
+ *
+ * Объект используется только потоком обработки.
+ */
+class SilenceCompressor {
+public:
+    /**
+     * @brief Конструктор
+     * @param config Снимок конфигурации (ключи catchup_*)
+     * @param sample_rate Частота дискретизации
+     */
+    SilenceCompressor(const ConfigSnapshot& config, int sample_rate);
+
+    /**
+     * @brief Проверяет, включено ли сокращение задержки в конфигурации
+     * @return true если сокращение включено
+     */
+    bool is_enabled() const { return enabled; }
+
+    /**
+     * @brief Сбрасывает состояние между запусками
+     */
+    void reset();
+
+    /**
+     * @brief Возвращает, сколько сэмплов можно выбросить из очередного чанка
+     * @param buffered Сэмплов в буфере задержки перед извлечением чанка
+     * @param target Целевое количество сэмплов перед извлечением чанка
+     * @param chunk_size Размер чанка выхода
+     * @return Количество сэмплов (0 - превышения нет или сокращение выключено)
+     */
+    size_t drop_budget(size_t buffered, size_t target, size_t chunk_size) const;
+
+    /**
+     * @brief Формирует чанк выхода, пропуская тихие кадры
+     * @param input Начало буфера задержки
+     * @param count Доступно сэмплов (не меньше output_count + max_drop)
+     * @param output Чанк выхода
+     * @param output_count Размер чанка выхода
+     * @param max_drop Сколько сэмплов можно выбросить
+     * @return Сколько сэмплов буфера использовано (output_count плюс выброшенные)
+     */
+    size_t compress(const short* input, size_t count, short* output, size_t output_count, size_t max_drop);
+
+    /**
+     * @brief Возвращает общее число выброшенных сэмплов с последнего сброса
+     * @return Количество сэмплов
+     */
+    uint64_t samples_dropped() const { return dropped_total; }
+
+private:
+    /**
+     * @brief Проверяет, тихий ли кадр
+     * @param frame Сэмплы кадра
+     * @param length Длина кадра
+     * @return true если уровень кадра ниже порога
+     */
+    bool _is_silent(const short* frame, size_t length) const;
+
+private:
+    bool enabled;
+    size_t frame_size;          // Кадр анализа, сэмплы
+    size_t crossfade_size;      // Переход на стыке, сэмплы
+    size_t min_excess;          // Превышение, с которого начинается сокращение
+    int max_drop_percent;       // Доля чанка, которую можно выбросить
+    double silence_power;       // Порог среднего квадрата сэмпла
+
+    bool previous_silent;       // Последний кадр предыдущего чанка был тихим
+    uint64_t dropped_total;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_SILENCE_COMPRESSOR_H
@@ -0,0 +1,68 @@
+#ifndef AUDIOCENSOR_TEXT_NORMALIZER_H
+#define AUDIOCENSOR_TEXT_NORMALIZER_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace audiocensor {
+namespace text {
+
+/**
+ * @brief Нормализует слово в UTF-8 для сравнения со словарем
+ *
+ * Убирает пробелы по краям, приводит латиницу и кириллицу к нижнему регистру,
+ * заменяет ё на е, латинские буквы-двойники (a, c, e, o, p, x, y, k, m, t, h, b)
+ * на кириллические и схлопывает повторы одной и той же буквы ("приииивет" -> "привет").
+ * Результат записывается в output без выделения памяти, если его емкости достаточно.
+ *
+ * @param data Указатель на исходные байты
+ * @param size Размер исходных данных в байтах
+ * @param output Буфер для результата (очищается перед записью)
+ * @return Количество кодовых точек в результате
+ */
+size_t normalize_word(const char* data, size_t size, std::string& output);
+
+/**
+ * @brief Нормализует слово в UTF-8 для сравнения со словарем
+ * @param word Исходное слово
+ * @param output Буфер для результата (очищается перед записью)
+ * @return Количество кодовых точек в результате
+ */
+size_t normalize_word(const std::string& word, std::string& output);
+
+/**
+ * @brief Приводит текст в UTF-8 к нижнему регистру (латиница и кириллица)
+ * @param word Исходный текст
+ * @param output Буфер для результата (очищается перед записью)
+ * @return Количество кодовых точек в результате
+ */
+size_t fold_case(const std::string& word, std::string& output);
+
+/**
+ * @brief Считает количество кодовых точек в строке UTF-8
+ * @param word Исходная строка
+ * @return Количество кодовых точек
+ */
+size_t utf8_length(const std::string& word);
+
+/**
+ * @brief Декодирует одну кодовую точку UTF-8
+ * @param data Указатель на текущую позицию
+ * @param end Указатель на конец данных
+ * @param code_point Декодированная кодовая точка (байт как есть для некорректных последовательностей)
+ * @return Количество прочитанных байт (не меньше 1)
+ */
+size_t decode_utf8(const unsigned char* data, const unsigned char* end, uint32_t& code_point);
+
+/**
+ * @brief Дописывает кодовую точку в строку в кодировке UTF-8
+ * @param code_point Кодовая точка
+ * @param output Строка для записи
+ */
+void append_utf8(uint32_t code_point, std::string& output);
+
+} // namespace text
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_TEXT_NORMALIZER_H
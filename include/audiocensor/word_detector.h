@@ -7,6 +7,14 @@
 #include <tuple>
 #include <regex>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "audiocensor/detection_cache.h"
+#include "audiocensor/compiled_dictionary.h"
+#include "audiocensor/recognition_result.h"
 
 namespace audiocensor {
 
@@ -21,11 +29,29 @@ public:
      */
     explicit WordDetector(const std::unordered_map<std::string, std::string>& config = {});
     
+    /**
+     * @brief Публикует новый словарь для проверок
+     *
+     * Регулярные выражения компилируются в вызывающем потоке, затем готовый
+     * снимок атомарно подменяет текущий. Проверки, начатые до подмены,
+     * дорабатывают со старым снимком; он освобождается после их завершения.
+     * Можно вызывать из фонового потока во время проверок.
+     *
+     * @param dictionary Словарь (например, прочитанный из файла)
+     */
+    void set_dictionary(std::shared_ptr<const CompiledDictionary> dictionary);
+    
+    /**
+     * @brief Возвращает текущий словарь
+     * @return Словарь или nullptr, если он не задан
+     */
+    std::shared_ptr<const CompiledDictionary> get_dictionary() const;
+    
     /**
      * @brief Проверяет, является ли слово запрещенным
      * @param word_text Проверяемое слово
-     * @param patterns Список регулярных выражений для проверки
-     * @param target_words Список запрещенных слов
+     * @param patterns Список регулярных выражений для проверки (пустой - использовать текущий словарь)
+     * @param target_words Список запрещенных слов (пустой - использовать текущий словарь)
      * @return Пара (bool, string) - результат проверки и причина
      */
     std::tuple<bool, std::string> is_prohibited_word(
@@ -34,6 +60,18 @@ public:
         const std::vector<std::string>& target_words = {}
     );
     
+    /**
+     * @brief Проверяет, похоже ли слово на слово словаря сильнее обычного порога
+     *
+     * Используется для слов, не признанных запрещенными: такое слово могло быть
+     * запрещенным, распознанным с ошибкой, и его стоит перепроверить.
+     *
+     * @param word_text Проверяемое слово
+     * @param slack Допуск расстояния сверх порога слова словаря
+     * @return true если слово словаря найдено в пределах порога с допуском
+     */
+    bool is_near_miss(const std::string& word_text, int slack);
+    
     /**
      * @brief Обрабатывает результаты распознавания и возвращает регионы для цензуры
      * @param result Результаты распознавания в формате JSON
@@ -64,23 +102,58 @@ public:
      */
     int get_detection_count() const { return detection_count; }
     
+    /**
+     * @brief Возвращает количество попаданий в кэш проверок
+     * @return Количество попаданий
+     */
+    uint64_t get_cache_hits() const { return cache.hits(); }
+    
+    /**
+     * @brief Возвращает количество промахов кэша проверок
+     * @return Количество промахов
+     */
+    uint64_t get_cache_misses() const { return cache.misses(); }
+    
 private:
     /**
      * @brief Нормализует слово для сравнения
      * @param word Исходное слово
-     * @return Нормализованное слово
+     * @param output Буфер для нормализованного слова (переиспользуется между вызовами)
+     * @return Количество букв (кодовых точек) в нормализованном слове
      */
-    std::string _normalize_word(const std::string& word);
+    size_t _normalize_word(const std::string& word, std::string& output);
+    
+    /**
+     * @brief Готовит слово для регулярных выражений: нижний регистр без пробелов по краям
+     * @param word Исходное слово
+     * @param output Буфер для результата (переиспользуется между вызовами)
+     */
+    static void _folded_word(const std::string& word, std::string& output);
+    
+    /**
+     * @brief Неизменяемый снимок словаря вместе со скомпилированными регулярными выражениями
+     */
+    struct DictionarySnapshot {
+        std::shared_ptr<const CompiledDictionary> dictionary;
+        std::vector<std::regex> patterns;
+        std::vector<std::string> pattern_sources;
+        uint64_t generation;
+    };
     
     /**
      * @brief Генерирует ключ для кэширования результатов проверки
-     * @param word_text Проверяемое слово
-     * @param patterns Список регулярных выражений
-     * @param target_words Список запрещенных слов
+     * @param word_text Слово в нижнем регистре
+     * @param generation Поколение словаря
      * @return Ключ для кэша
      */
-    std::string _generate_cache_key(
-        const std::string& word_text,
+    uint64_t _generate_cache_key(const std::string& word_text, uint64_t generation) const;
+    
+    /**
+     * @brief Пересобирает словарь, если переданные списки отличаются от текущего словаря
+     * @param patterns Список регулярных выражений
+     * @param target_words Список запрещенных слов (допускается порог вида "слово~N")
+     */
+    void _update_dictionary(
         const std::vector<std::string>& patterns,
         const std::vector<std::string>& target_words
     );
@@ -110,16 +183,39 @@ private:
     
 private:
     std::unordered_map<std::string, std::string> config;
-    std::unordered_map<std::string, std::tuple<bool, std::string>> cache;
+    DetectionCache cache;
     int detection_count;
+    
+    // Текущий снимок словаря: читается и подменяется через std::atomic_load/atomic_store
+    std::shared_ptr<const DictionarySnapshot> _snapshot;
+    
+    // Предыдущий снимок держит публикующий поток, чтобы его освобождение
+    // (в том числе освобождение образа словаря) не происходило в потоке проверок
+    std::shared_ptr<const DictionarySnapshot> _retired_snapshot;
+    std::mutex _publish_mutex;
+    
+    // Поколение словаря: меняется при каждой смене словаря
+    std::atomic<uint64_t> _dictionary_generation;
+    
+    // Нечеткое сравнение для ошибок распознавания
+    bool _fuzzy_enabled;
+    int _fuzzy_max_distance;
+    
+    // Поиск словоформ по основам
+    bool _morphology_enabled;
+    
+    // Переиспользуемый разбор результатов распознавания
+    RecognitionResultParser _result_parser;
+    
+    // Переиспользуемые буферы нормализации
+    std::string _normalized_buffer;
+    std::string _folded_buffer;
+    std::string _pattern_buffer;
     std::chrono::system_clock::time_point _last_check_time;
     
     // Защита от быстрого перебора
     int _throttle_attempts;
     std::chrono::system_clock::time_point _throttle_start_time;
-    
-    // Регулярные выражения
-    std::vector<std::regex> compiled_patterns;
 };
 
 } // namespace audiocensor
@@ -0,0 +1,210 @@
+#ifndef AUDIOCENSOR_WORD_LIST_SYNC_H
+#define AUDIOCENSOR_WORD_LIST_SYNC_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace audiocensor {
+
+/**
+ * @brief Фоновая синхронизация списков запрещенных слов и паттернов с API
+ *
+ * Запрос выполняется в отдельном потоке и не блокирует интерфейс. Последний
+ * полученный список хранится в локальном кэше на диске вместе с версией и ETag:
+ * запрос отправляется с If-None-Match и since_version, поэтому неизменившийся
+ * список стоит одного ответа 304 без тела.
+ *
+ * Сервер может вернуть полный список:
+ *   {"version": N, "words": [...], "patterns": [...]}
+ * или изменения относительно версии клиента:
+ *   {"version": N, "delta": true, "base_version": M,
+ *    "added_words": [...], "removed_words": [...],
+ *    "added_patterns": [...], "removed_patterns": [...]}
+ * Изменения применяются, только если base_version совпадает с версией кэша;
+ * иначе в том же проходе запрашивается полный список (без since_version и ETag).
+ *
+ * Сетевые ошибки и ответы 5xx повторяются с экспоненциальной задержкой.
+ */
+class WordListSync {
+public:
+    /**
+     * @brief Результат синхронизации
+     */
+    struct Result {
+        bool success = false;       // Списки актуальны (получены или подтверждены ответом 304)
+        bool changed = false;       // Списки отличаются от кэша до синхронизации
+        bool not_modified = false;  // Сервер ответил 304
+        bool delta = false;         // Применены изменения, а не полный список
+        bool full_refetch = false;  // Изменения не подошли к кэшу, полный список запрошен повторно
+        long http_code = 0;
+        int attempts = 0;
+        std::string error;
+    };
+
+    /**
+     * @brief Обработчик завершения; вызывается в потоке синхронизации
+     */
+    using FinishedCallback = std::function<void(const Result&)>;
+
+    /**
+     * @brief Проверка подлинности тела ответа
+     */
+    using ResponseVerifier = std::function<bool(const std::string&)>;
+
+    /**
+     * @brief Конструктор
+     * @param api_url Адрес API списков
+     * @param cache_path Путь к файлу локального кэша
+     * @param config Конфигурация (таймауты и количество повторов)
+     */
+    WordListSync(const std::string& api_url,
+                 const std::string& cache_path,
+                 const std::unordered_map<std::string, std::string>& config = {});
+
+    /**
+     * @brief Деструктор, прерывает синхронизацию и дожидается потока
+     */
+    ~WordListSync();
+
+    WordListSync(const WordListSync&) = delete;
+    WordListSync& operator=(const WordListSync&) = delete;
+
+    /**
+     * @brief Загружает списки из локального кэша
+     * @return true если кэш найден и прочитан, false в противном случае
+     */
+    bool load_cache();
+
+    /**
+     * @brief Проверяет, есть ли списки (из кэша или с сервера)
+     * @return true если списки есть, false в противном случае
+     */
+    bool has_data() const;
+
+    /**
+     * @brief Возвращает текущие списки
+     * @param target_words Запрещенные слова
+     * @param target_patterns Регулярные выражения
+     * @param version Версия списков
+     */
+    void get_lists(std::vector<std::string>& target_words,
+                   std::vector<std::string>& target_patterns,
+                   uint64_t& version) const;
+
+    /**
+     * @brief Задает параметры запроса (без since_version, он добавляется автоматически)
+     * @param params Строка параметров вида "key=value&key2=value2"
+     */
+    void set_query_params(const std::string& params);
+
+    /**
+     * @brief Задает проверку подлинности ответа
+     * @param verifier Функция проверки тела ответа
+     */
+    void set_response_verifier(ResponseVerifier verifier);
+
+    /**
+     * @brief Запускает синхронизацию в фоновом потоке
+     * @param on_finished Обработчик завершения
+     * @return true если синхронизация запущена, false если она уже выполняется
+     */
+    bool start(FinishedCallback on_finished);
+
+    /**
+     * @brief Прерывает синхронизацию (текущий запрос и ожидание повтора)
+     */
+    void cancel();
+
+    /**
+     * @brief Проверяет, выполняется ли синхронизация
+     * @return true если синхронизация выполняется
+     */
+    bool is_running() const { return running; }
+
+private:
+    /**
+     * @brief Выполняет синхронизацию с повторами
+     * @return Результат синхронизации
+     */
+    Result _sync();
+
+    /**
+     * @brief Составляет адрес запроса и ETag для If-None-Match
+     * @param full Запросить полный список (без since_version и ETag)
+     * @param url Полный адрес запроса
+     * @param cached_etag ETag кэша (пустой для полного списка)
+     */
+    void _build_request(bool full, std::string& url, std::string& cached_etag) const;
+
+    /**
+     * @brief Выполняет один HTTP-запрос
+     * @param url Полный адрес запроса
+     * @param cached_etag ETag кэша для If-None-Match
+     * @param http_code Код ответа
+     * @param body Тело ответа
+     * @param etag ETag ответа
+     * @param error Описание ошибки
+     * @return true если ответ получен, false при сетевой ошибке
+     */
+    bool _request(const std::string& url, const std::string& cached_etag,
+                  long& http_code, std::string& body, std::string& etag, std::string& error);
+
+    /**
+     * @brief Применяет тело ответа 200 к спискам
+     * @param body Тело ответа
+     * @param etag ETag ответа
+     * @param result Результат синхронизации
+     * @param base_mismatch Изменения посчитаны не от версии кэша
+     * @return true если ответ корректен и применен
+     */
+    bool _apply_response(const std::string& body, const std::string& etag, Result& result, bool& base_mismatch);
+
+    /**
+     * @brief Сохраняет списки в локальный кэш
+     * @return true если кэш сохранен
+     */
+    bool _save_cache() const;
+
+    /**
+     * @brief Ждет перед повтором запроса
+     * @param attempt Номер неудачной попытки
+     * @return false если синхронизация прервана
+     */
+    bool _wait_before_retry(int attempt);
+
+private:
+    std::string api_url;
+    std::string cache_path;
+    long timeout_ms;
+    long connect_timeout_ms;
+    int max_retries;
+    long retry_delay_ms;
+
+    // Списки и состояние кэша
+    mutable std::mutex mutex;
+    std::vector<std::string> words;
+    std::vector<std::string> patterns;
+    uint64_t version;
+    std::string etag;
+    bool has_lists;
+    std::string query_params;
+    ResponseVerifier verifier;
+
+    // Фоновый поток
+    std::thread worker;
+    std::atomic<bool> running;
+    std::atomic<bool> cancelled;
+    std::mutex cancel_mutex;
+    std::condition_variable cancel_condition;
+};
+
+} // namespace audiocensor
+
+#endif // AUDIOCENSOR_WORD_LIST_SYNC_H
@@ -5,14 +5,20 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QComboBox>
-#include <QTextEdit>
+#include <QPlainTextEdit>
 #include <QTimer>
 #include <QMenu>
 #include <QAction>
 #include <QString>
 #include <QMenuBar>
+#include <QElapsedTimer>
+#include <QVariantMap>
 
 #include <memory>
+#include <string>
+#include <cstdint>
+
+#include "audiocensor/word_list_sync.h"
 
 namespace audiocensor {
 
@@ -22,6 +28,7 @@ class ConfigManager;
 class AudioProcessor;
 class WordDetector;
 class OBSIntegration;
+class LogBuffer;
 
 /**
  * @brief Главное окно приложения
@@ -66,6 +73,13 @@ private slots:
      */
     void show_license_info(bool show_dialog = false);
     
+    /**
+     * @brief Обрабатывает результат фоновой проверки лицензии
+     * @param valid Лицензия действительна
+     * @param message Описание результата
+     */
+    void license_verified(bool valid, const QString& message);
+    
     /**
      * @brief Открывает ссылку для покупки лицензии
      */
@@ -97,8 +111,8 @@ private slots:
     void save_log();
     
     /**
-     * @brief Загружает список запрещённых слов из API
-     * @return true если загрузка прошла успешно, false в противном случае
+     * @brief Запускает фоновую синхронизацию списка запрещённых слов с API
+     * @return true если синхронизация запущена, false в противном случае
      */
     bool load_words_from_api();
     
@@ -122,6 +136,12 @@ private slots:
      */
     void update_buffer_status(int current, int maximum);
     
+    /**
+     * @brief Обновляет счетчики сбоев аудио потоков
+     * @param stats Счетчики сбоев
+     */
+    void update_xrun_status(const QVariantMap& stats);
+    
     /**
      * @brief Показывает диалог настройки интеграции с OBS
      */
@@ -155,6 +175,32 @@ private:
      */
     void init_audio();
     
+    /**
+     * @brief Обновляет список устройств по таймеру, пока обработка остановлена
+     */
+    void refresh_devices();
+    
+    /**
+     * @brief Продолжает запуск после проверки лицензии: загружает списки слов и запускает обработку
+     */
+    void start_with_word_lists();
+    
+    /**
+     * @brief Запускает аудио потоки на выбранных устройствах (списки слов уже загружены)
+     */
+    void begin_processing();
+    
+    /**
+     * @brief Обрабатывает результат синхронизации списка слов в потоке интерфейса
+     * @param result Результат синхронизации
+     */
+    void word_lists_synced(const WordListSync::Result& result);
+    
+    /**
+     * @brief Выводит в окно лога записи, накопленные с предыдущего вывода
+     */
+    void flush_log();
+    
     /**
      * @brief Настройка меню для управления лицензией
      */
@@ -176,12 +222,17 @@ private:
     std::unique_ptr<ConfigManager> config_manager;
     std::unique_ptr<AudioProcessor> audio_processor;
     std::unique_ptr<OBSIntegration> obs_integration;
+    std::unique_ptr<WordListSync> word_list_sync;
     
     // Состояние приложения
     bool running;
     int input_device_index;
     int output_device_index;
     int detections_count;
+    bool start_pending;     // Запуск ждет первой загрузки списка слов
+    bool license_pending;   // Решение о диалоге активации ждет онлайн-проверки лицензии
+    bool start_license_pending;   // Запуск ждет онлайн-проверки лицензии
+    QElapsedTimer startup_timer;
     
     // UI элементы
     QPushButton* activate_license_button;
@@ -190,7 +241,7 @@ private:
     QPushButton* pause_button;
     QComboBox* input_device_combo;
     QComboBox* output_device_combo;
-    QTextEdit* log_text;
+    QPlainTextEdit* log_text;
     QPushButton* clear_log_button;
     QPushButton* save_log_button;
     
@@ -198,9 +249,19 @@ private:
     QLabel* license_status_label;
     QLabel* buffer_label;
     QLabel* detections_label;
+    QLabel* xruns_label;
     
     // Таймер обновления статуса
     QTimer* status_timer;
+    
+    // Таймер проверки подключения и отключения устройств
+    QTimer* device_refresh_timer;
+    
+    // Лог событий: записи хранятся в кольцевом буфере и выводятся в окно пачками
+    std::unique_ptr<LogBuffer> log_buffer;
+    uint64_t log_flushed_sequence;
+    std::string log_batch;
+    QTimer* log_flush_timer;
 };
 
 } // namespace audiocensor
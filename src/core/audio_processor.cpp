@@ -1,6 +1,15 @@
 #include "audiocensor/audio_processor.h"
 #include "audiocensor/word_detector.h"
+#include "audiocensor/compiled_dictionary.h"
 #include "audiocensor/constants.h"
+#include "audiocensor/text_normalizer.h"
+#include "audiocensor/realtime_profile.h"
+#include "audiocensor/drift_compensator.h"
+#include "audiocensor/silence_compressor.h"
+#include "audiocensor/boundary_refiner.h"
+#include "audiocensor/lookback_ring.h"
+#include "audiocensor/redecode_worker.h"
+#include "audiocensor/endpoint_tuner.h"
 
 #include <QDebug>
 #include <QMutexLocker>
@@ -15,6 +24,8 @@
 #include <cmath>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <sstream>
 #include <vector>
 #include <algorithm>
 #include <functional>
@@ -23,6 +34,26 @@ namespace audiocensor {
 
 using json = nlohmann::json;
 
+// Переход на краях региона цензуры, мс: глушение без щелчков
+static constexpr int CENSOR_FADE_MS = 3;
+
+// Читают числовую настройку; некорректное значение заменяется значением по умолчанию
+static int _config_int(const ConfigSnapshot& config, const std::string& key, int default_value) {
+    try {
+        return std::stoi(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+static double _config_double(const ConfigSnapshot& config, const std::string& key, double default_value) {
+    try {
+        return std::stod(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
 // Callback-функция для получения данных с микрофона
 static int inputCallback(const void* inputBuffer, void* outputBuffer,
                          unsigned long framesPerBuffer,
@@ -45,80 +76,68 @@ static int outputCallback(const void* inputBuffer, void* outputBuffer,
     return paContinue;
 }
 
-AudioProcessor::AudioProcessor(const std::unordered_map<std::string, std::string>& config, QObject* parent)
-    : QThread(parent), config(config), running(false), paused(false),
-      audio(nullptr), input_stream(nullptr), output_stream(nullptr),
-      model(nullptr), recognizer(nullptr),
+AudioProcessor::AudioProcessor(ConfigSnapshotPtr config, QObject* parent)
+    : QThread(parent), config_snapshot(config), running(false), paused(false),
+      input_stream(nullptr), output_stream(nullptr),
+      model(nullptr), recognizer(nullptr), recognizer_samples_fed(0), recognizer_cycles(0),
+      spare_building(false), dictionary_building(false),
       current_sample_rate(DEFAULT_SAMPLE_RATE), current_channels(1),
-      buffer_size_in_chunks(0), program_start_time(0), chunks_processed(0),
+      buffer_size_in_chunks(0), chunk_size(DEFAULT_CHUNK_SIZE), applied_config_version(0), program_start_time(0), chunks_processed(0),
+      captured_samples(0), recognizer_offset(0), input_samples_read(0), input_stream_start(0),
+      xrun_stats_changed(false), latency_increase_requested(false),
+      device_lost(false), consecutive_read_errors(0), consecutive_write_errors(0),
       input_device_index(-1), output_device_index(-1) {
     
+    // Списки слов попадают к детектору только в виде скомпилированного словаря
+    std::unordered_map<std::string, std::string> detector_config = config->values;
+    detector_config.erase("target_words");
+    detector_config.erase("target_patterns");
+    detector = std::make_unique<WordDetector>(detector_config);
+    load_dictionary();
+    
     // Инициализация буфера
     buffer_size_in_chunks = static_cast<int>(
-        std::stod(config.at("buffer_delay")) * DEFAULT_SAMPLE_RATE / DEFAULT_CHUNK_SIZE) + 2;
+        std::stod(config->at("buffer_delay")) * DEFAULT_SAMPLE_RATE / DEFAULT_CHUNK_SIZE) + 2;
     audio_buffer.resize(buffer_size_in_chunks * DEFAULT_CHUNK_SIZE);
 }
 
 AudioProcessor::~AudioProcessor() {
-    // Останавливаем поток и освобождаем ресурсы
-    if (running) {
+    // Останавливаем поток и освобождаем ресурсы. Флаг running снимается раньше,
+    // чем run() завершается, поэтому проверяется сам поток
+    if (running || isRunning()) {
         stop_processing();
     }
+
+    // Сборка словаря обращается к детектору, дожидаемся ее; очередной запрос уже не нужен
+    {
+        QMutexLocker locker(&dictionary_lock);
+        pending_dictionary.reset();
+    }
+    if (dictionary_builder.joinable()) {
+        dictionary_builder.join();
+    }
+    discard_spare_recognizer();
+
+    // Сессия движка заканчивается вместе с процессором
+    cleanup_resources();
 }
 
 bool AudioProcessor::initialize_audio() {
     try {
-        // Инициализация PortAudio
-        PaError err = Pa_Initialize();
-        if (err != paNoError) {
+        // PortAudio инициализируется один раз за сессию и остается активным между запусками
+        bool first_initialization = !device_catalog.is_initialized();
+        if (!device_catalog.initialize()) {
             emit logMessage(QString("Ошибка инициализации PortAudio: %1").
-                          arg(Pa_GetErrorText(err)));
+                          arg(QString::fromStdString(device_catalog.error())));
             return false;
         }
         
-        audio = nullptr; // PortAudio не требует хранения состояния, используем Pa_ функции напрямую
-        emit logMessage("✅ Аудио система инициализирована");
-        
-        // Получаем список устройств с информацией о них
-        QList<QPair<int, QString>> devices_info;
-        
-        int numDevices = Pa_GetDeviceCount();
-        if (numDevices < 0) {
-            emit logMessage(QString("Ошибка при получении списка устройств: %1").
-                          arg(Pa_GetErrorText(numDevices)));
-            return false;
-        }
-        
-        for (int i = 0; i < numDevices; i++) {
-            const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
-            if (!deviceInfo) continue;
-            
-            // Добавляем только устройства, которые поддерживают ввод или вывод
-            if (deviceInfo->maxInputChannels > 0 || deviceInfo->maxOutputChannels > 0) {
-                QString name = QString("%1").arg(deviceInfo->name);
-                if (deviceInfo->maxInputChannels > 0 && deviceInfo->maxOutputChannels > 0) {
-                    name += " (In/Out)";
-                } else if (deviceInfo->maxInputChannels > 0) {
-                    name += " (In)";
-                } else {
-                    name += " (Out)";
-                }
-                
-                devices_info.append(QPair<int, QString>(i, name));
-                
-                // Улучшенное форматирование лога устройства
-                QString device_log = QString("📱 Устройство [%1]: %2").arg(i).arg(deviceInfo->name);
-                device_log += QString("\n   Каналы: Вход %1, Выход %2").
-                            arg(deviceInfo->maxInputChannels).
-                            arg(deviceInfo->maxOutputChannels);
-                device_log += QString("\n   Частота: %1 Гц").arg(deviceInfo->defaultSampleRate);
-                emit logMessage(device_log);
-            }
+        if (first_initialization) {
+            emit logMessage("✅ Аудио система инициализирована");
         }
         
-        // Отправляем информацию об устройствах в UI
-        emit deviceListUpdate(devices_info);
-        emit logMessage(QString("📊 Обнаружено %1 аудио устройств").arg(devices_info.size()));
+        // Подробности об устройствах выводятся только при первом сканировании
+        publish_device_list(first_initialization);
         return true;
         
     } catch (const std::exception& e) {
@@ -127,64 +146,123 @@ bool AudioProcessor::initialize_audio() {
     }
 }
 
+bool AudioProcessor::refresh_devices() {
+    // Во время обработки отключение устройств обнаруживает и обрабатывает поток обработки
+    if (running || isRunning() || !device_catalog.is_initialized()) {
+        return false;
+    }
+
+    // Без изменения набора звуковых карт PortAudio не переинициализируется;
+    // где набор не узнать (Windows, macOS), список обновляется по интервалу
+    int rescan_interval_ms = _config_int(*current_config(), "device_rescan_interval_ms",
+                                         DEFAULT_DEVICE_RESCAN_INTERVAL_MS);
+    if (!device_catalog.rescan_due(rescan_interval_ms)) {
+        return false;
+    }
+
+    // Повторная инициализация PortAudio требует закрытых потоков; при
+    // следующем запуске setup_streams() откроет их заново
+    close_streams();
+
+    DeviceCatalog::Changes changes;
+    if (!device_catalog.rescan(&changes)) {
+        emit logMessage(QString("❌ Ошибка обновления списка устройств: %1").
+                      arg(QString::fromStdString(device_catalog.error())));
+        return false;
+    }
+
+    // Индексы выбранных устройств могли сдвинуться
+    input_device_index = device_catalog.find(input_device_key, true);
+    output_device_index = device_catalog.find(output_device_key, false);
+
+    log_device_changes(changes);
+    publish_device_list(false);
+    return changes.any();
+}
+
+void AudioProcessor::publish_device_list(bool detailed) {
+    QList<QPair<int, QString>> devices_info;
+
+    for (const auto& device : device_catalog.devices()) {
+        QString name = QString::fromStdString(device.name);
+        if (device.max_input_channels > 0 && device.max_output_channels > 0) {
+            name += " (In/Out)";
+        } else if (device.max_input_channels > 0) {
+            name += " (In)";
+        } else {
+            name += " (Out)";
+        }
+        
+        devices_info.append(QPair<int, QString>(device.index, name));
+        
+        if (detailed) {
+            // Улучшенное форматирование лога устройства
+            QString device_log = QString("📱 Устройство [%1]: %2").arg(device.index).
+                               arg(QString::fromStdString(device.name));
+            device_log += QString("\n   Каналы: Вход %1, Выход %2").
+                        arg(device.max_input_channels).
+                        arg(device.max_output_channels);
+            device_log += QString("\n   Частота: %1 Гц").arg(device.default_sample_rate);
+            emit logMessage(device_log);
+        }
+    }
+
+    // Отправляем информацию об устройствах в UI
+    emit deviceListUpdate(devices_info);
+    emit logMessage(QString("📊 Обнаружено %1 аудио устройств").arg(devices_info.size()));
+}
+
+void AudioProcessor::log_device_changes(const DeviceCatalog::Changes& changes) {
+    for (const auto& device : changes.added) {
+        emit logMessage(QString("🔌 Подключено устройство: %1").arg(QString::fromStdString(device.name)));
+    }
+    for (const auto& device : changes.removed) {
+        emit logMessage(QString("🔌 Отключено устройство: %1").arg(QString::fromStdString(device.name)));
+    }
+}
+
 bool AudioProcessor::setup_streams(int input_index, int output_index) {
+    // Снимок конфигурации не меняется до конца вызова
+    auto config = current_config();
+
     try {
+        // Прежние параметры: открытые потоки на тех же устройствах и частоте переиспользуются
+        int previous_input_index = input_device_index;
+        int previous_output_index = output_device_index;
+        int previous_sample_rate = current_sample_rate;
+        
         // Сохраняем индексы устройств
         input_device_index = input_index;
         output_device_index = output_index;
         
-        // Проверяем валидность индексов устройств
-        int numDevices = Pa_GetDeviceCount();
-        if (input_index >= numDevices || output_index >= numDevices) {
+        // Получаем информацию об устройствах из каталога
+        AudioDeviceInfo input_device_info;
+        AudioDeviceInfo output_device_info;
+        if (!device_catalog.get(input_index, input_device_info) ||
+            !device_catalog.get(output_index, output_device_info)) {
             emit logMessage(QString("❌ Неверные индексы устройств: вход=%1, выход=%2").
                           arg(input_index).arg(output_index));
             return false;
         }
         
-        // Закрытие предыдущих потоков, если они есть
-        if (input_stream) {
-            try {
-                Pa_StopStream(input_stream);
-                Pa_CloseStream(input_stream);
-                input_stream = nullptr;
-            } catch (const std::exception& e) {
-                emit logMessage(QString("Предупреждение: не удалось закрыть входной поток: %1").arg(e.what()));
-            }
-        }
-        
-        if (output_stream) {
-            try {
-                Pa_StopStream(output_stream);
-                Pa_CloseStream(output_stream);
-                output_stream = nullptr;
-            } catch (const std::exception& e) {
-                emit logMessage(QString("Предупреждение: не удалось закрыть выходной поток: %1").arg(e.what()));
-            }
-        }
-        
-        // Получаем информацию об устройствах
-        const PaDeviceInfo* input_device_info = Pa_GetDeviceInfo(input_index);
-        const PaDeviceInfo* output_device_info = Pa_GetDeviceInfo(output_index);
-        
-        if (!input_device_info || !output_device_info) {
-            emit logMessage("❌ Не удалось получить информацию об устройствах");
-            return false;
-        }
+        // Ключи позволяют найти устройства после переподключения, когда индексы меняются
+        input_device_key = input_device_info.key();
+        output_device_key = output_device_info.key();
         
         // Проверяем, что устройства имеют нужные каналы
-        if (input_device_info->maxInputChannels <= 0) {
+        if (input_device_info.max_input_channels <= 0) {
             emit logMessage("❌ Выбранное устройство ввода не поддерживает ввод");
             return false;
         }
         
-        if (output_device_info->maxOutputChannels <= 0) {
+        if (output_device_info.max_output_channels <= 0) {
             emit logMessage("❌ Выбранное устройство вывода не поддерживает вывод");
             return false;
         }
         
         // Определяем рабочую частоту дискретизации
-        int input_rate = static_cast<int>(input_device_info->defaultSampleRate);
-        int output_rate = static_cast<int>(output_device_info->defaultSampleRate);
+        int input_rate = static_cast<int>(input_device_info.default_sample_rate);
+        int output_rate = static_cast<int>(output_device_info.default_sample_rate);
         
         // Стандартные частоты дискретизации от низкой к высокой
         std::vector<int> standard_rates = {8000, 16000, 22050, 32000, 44100, 48000};
@@ -215,25 +293,63 @@ bool AudioProcessor::setup_streams(int input_index, int output_index) {
         // Определяем количество каналов (всегда используем моно для обработки)
         current_channels = 1;
         
+        bool sample_rate_changed = current_sample_rate != previous_sample_rate;
+        
         // Создаем распознаватель с учетом выбранной частоты дискретизации
         try {
-            model = std::shared_ptr<VoskModel>(vosk_model_new(config.at("model_path").c_str()),
-                                              vosk_model_free);
-            if (!model) {
-                emit logMessage("❌ Ошибка создания модели Vosk");
-                return false;
+            // Модель загружается один раз и остается в памяти между запусками
+            const std::string& model_path = config->at("model_path");
+            if (!model || model_path != loaded_model_path) {
+                discard_spare_recognizer();
+                recognizer.reset();
+                model = std::shared_ptr<VoskModel>(vosk_model_new(model_path.c_str()),
+                                                  vosk_model_free);
+                if (!model) {
+                    loaded_model_path.clear();
+                    emit logMessage("❌ Ошибка создания модели Vosk");
+                    return false;
+                }
+                loaded_model_path = model_path;
             }
             
-            recognizer = std::shared_ptr<VoskRecognizer>(
-                vosk_recognizer_new(model.get(), current_sample_rate),
-                vosk_recognizer_free
-            );
-            if (!recognizer) {
-                emit logMessage("❌ Ошибка создания распознавателя Vosk");
-                return false;
+            // Модель проверки тоже остается в памяти; без нее окна проверяет потоковая модель
+            std::string verify_model_path = config->get("verify_model_path", "");
+            if (verify_model_path.empty() || verify_model_path == model_path) {
+                verify_model.reset();
+                loaded_verify_model_path.clear();
+            } else if (!verify_model || verify_model_path != loaded_verify_model_path) {
+                verify_model = std::shared_ptr<VoskModel>(vosk_model_new(verify_model_path.c_str()),
+                                                         vosk_model_free);
+                if (verify_model) {
+                    loaded_verify_model_path = verify_model_path;
+                    emit logMessage(QString("✅ Модель проверки загружена: %1")
+                                    .arg(QString::fromStdString(verify_model_path)));
+                } else {
+                    loaded_verify_model_path.clear();
+                    emit logMessage("⚠️ Не удалось загрузить модель проверки, окна проверяет основная модель");
+                }
             }
             
-            vosk_recognizer_set_words(recognizer.get(), 1);
+            // Распознаватель пересоздается только при смене модели или частоты
+            if (!recognizer || sample_rate_changed) {
+                recognizer = std::shared_ptr<VoskRecognizer>(
+                    vosk_recognizer_new(model.get(), current_sample_rate),
+                    vosk_recognizer_free
+                );
+                if (!recognizer) {
+                    emit logMessage("❌ Ошибка создания распознавателя Vosk");
+                    return false;
+                }
+                
+                vosk_recognizer_set_words(recognizer.get(), 1);
+                
+                // Нулевой сэмпл нового распознавателя - следующий сэмпл захвата
+                recognizer_offset = captured_samples;
+                recognizer_samples_fed = 0;
+                
+                // Запасной распознаватель создан для прежней частоты
+                discard_spare_recognizer();
+            }
             
         } catch (const std::exception& e) {
             emit logMessage(QString("❌ Ошибка создания распознавателя: %1").arg(e.what()));
@@ -241,66 +357,45 @@ bool AudioProcessor::setup_streams(int input_index, int output_index) {
         }
         
         // Обновляем размер буфера с учетом новой частоты дискретизации
-        buffer_size_in_chunks = static_cast<int>(std::stod(config.at("buffer_delay")) * current_sample_rate / 
-                                              std::stoi(config.at("chunk_size"))) + 2;
+        buffer_size_in_chunks = static_cast<int>(std::stod(config->at("buffer_delay")) * current_sample_rate / 
+                                              std::stoi(config->at("chunk_size"))) + 2;
         
         // Очищаем и ресайзим буфер
         audio_buffer.clear();
-        audio_buffer.resize(buffer_size_in_chunks * std::stoi(config.at("chunk_size")));
+        audio_buffer.resize(buffer_size_in_chunks * std::stoi(config->at("chunk_size")));
         
         // Отправляем информацию о выбранной конфигурации
         QVariantMap device_config;
         device_config["sample_rate"] = current_sample_rate;
         device_config["channels"] = current_channels;
-        device_config["input_device"] = input_device_info->name;
-        device_config["output_device"] = output_device_info->name;
+        device_config["input_device"] = QString::fromStdString(input_device_info.name);
+        device_config["output_device"] = QString::fromStdString(output_device_info.name);
         device_config["buffer_size"] = buffer_size_in_chunks;
         emit deviceInfoUpdate(device_config);
         
-        // Открытие входного потока
-        PaStreamParameters inputParameters;
-        inputParameters.device = input_index;
-        inputParameters.channelCount = current_channels;
-        inputParameters.sampleFormat = paInt16;
-        inputParameters.suggestedLatency = input_device_info->defaultLowInputLatency;
-        inputParameters.hostApiSpecificStreamInfo = nullptr;
-        
-        PaError err = Pa_OpenStream(&input_stream, &inputParameters, nullptr,
-                                   current_sample_rate, std::stoi(config.at("chunk_size")),
-                                   paNoFlag, nullptr, nullptr);
+        // Переоткрываются только потоки, у которых сменилось устройство или частота;
+        // задержка устройств минимальная, при частых сбоях она увеличивается
+        bool reopen_input = !input_stream || input_index != previous_input_index || sample_rate_changed;
+        bool reopen_output = !output_stream || output_index != previous_output_index || sample_rate_changed;
         
-        if (err != paNoError) {
-            emit logMessage(QString("❌ Ошибка открытия входного потока: %1").arg(Pa_GetErrorText(err)));
-            return false;
+        if (reopen_input) {
+            close_input_stream();
+            if (!open_input_stream(input_device_info.default_low_input_latency)) {
+                return false;
+            }
         }
         
-        emit logMessage(QString("✅ Входной поток открыт (устройство %1)").arg(input_index));
-        
-        // Открытие выходного потока
-        PaStreamParameters outputParameters;
-        outputParameters.device = output_index;
-        outputParameters.channelCount = current_channels;
-        outputParameters.sampleFormat = paInt16;
-        outputParameters.suggestedLatency = output_device_info->defaultLowOutputLatency;
-        outputParameters.hostApiSpecificStreamInfo = nullptr;
-        
-        err = Pa_OpenStream(&output_stream, nullptr, &outputParameters,
-                           current_sample_rate, std::stoi(config.at("chunk_size")),
-                           paNoFlag, nullptr, nullptr);
-        
-        if (err != paNoError) {
-            emit logMessage(QString("❌ Ошибка открытия выходного потока: %1").arg(Pa_GetErrorText(err)));
-            
-            // Закрываем входной поток, если выходной не удалось открыть
-            if (input_stream) {
-                Pa_CloseStream(input_stream);
-                input_stream = nullptr;
+        if (reopen_output) {
+            close_output_stream();
+            if (!open_output_stream(output_device_info.default_low_output_latency)) {
+                return false;
             }
-            
-            return false;
         }
         
-        emit logMessage(QString("✅ Выходной поток открыт (устройство %1)").arg(output_index));
+        if (!reopen_input && !reopen_output) {
+            emit logMessage("♻️ Аудио потоки уже открыты на выбранных устройствах");
+        }
+        
         emit logMessage(QString("✅ Аудио потоки настроены (вход: %1, выход: %2)").
                       arg(input_index).arg(output_index));
         emit logMessage(QString("📊 Частота дискретизации: %1 Гц, Каналов: %2").
@@ -314,7 +409,121 @@ bool AudioProcessor::setup_streams(int input_index, int output_index) {
     }
 }
 
+bool AudioProcessor::open_streams(double input_latency, double output_latency) {
+    if (!open_input_stream(input_latency)) {
+        return false;
+    }
+
+    if (!open_output_stream(output_latency)) {
+        // Закрываем входной поток, если выходной не удалось открыть
+        close_input_stream();
+        return false;
+    }
+
+    return true;
+}
+
+bool AudioProcessor::open_input_stream(double latency) {
+    // Снимок конфигурации не меняется до конца вызова
+    auto config = current_config();
+
+    PaStreamParameters inputParameters;
+    inputParameters.device = input_device_index;
+    inputParameters.channelCount = current_channels;
+    inputParameters.sampleFormat = paInt16;
+    inputParameters.suggestedLatency = latency;
+    inputParameters.hostApiSpecificStreamInfo = nullptr;
+
+    PaError err = Pa_OpenStream(&input_stream, &inputParameters, nullptr,
+                               current_sample_rate, std::stoi(config->at("chunk_size")),
+                               paNoFlag, nullptr, nullptr);
+
+    if (err != paNoError) {
+        input_stream = nullptr;
+        emit logMessage(QString("❌ Ошибка открытия входного потока: %1").arg(Pa_GetErrorText(err)));
+        return false;
+    }
+
+    // Фактическая задержка может отличаться от запрошенной
+    const PaStreamInfo* info = Pa_GetStreamInfo(input_stream);
+    {
+        QMutexLocker locker(&xrun_lock);
+        xrun_stats.input_latency = info ? info->inputLatency : latency;
+        xrun_stats_changed = true;
+    }
+
+    emit logMessage(QString("✅ Входной поток открыт (устройство %1)").arg(input_device_index));
+    return true;
+}
+
+bool AudioProcessor::open_output_stream(double latency) {
+    // Снимок конфигурации не меняется до конца вызова
+    auto config = current_config();
+
+    PaStreamParameters outputParameters;
+    outputParameters.device = output_device_index;
+    outputParameters.channelCount = current_channels;
+    outputParameters.sampleFormat = paInt16;
+    outputParameters.suggestedLatency = latency;
+    outputParameters.hostApiSpecificStreamInfo = nullptr;
+
+    PaError err = Pa_OpenStream(&output_stream, nullptr, &outputParameters,
+                               current_sample_rate, std::stoi(config->at("chunk_size")),
+                               paNoFlag, nullptr, nullptr);
+
+    if (err != paNoError) {
+        output_stream = nullptr;
+        emit logMessage(QString("❌ Ошибка открытия выходного потока: %1").arg(Pa_GetErrorText(err)));
+        return false;
+    }
+
+    // Фактическая задержка может отличаться от запрошенной
+    const PaStreamInfo* info = Pa_GetStreamInfo(output_stream);
+    {
+        QMutexLocker locker(&xrun_lock);
+        xrun_stats.output_latency = info ? info->outputLatency : latency;
+        xrun_stats_changed = true;
+    }
+
+    emit logMessage(QString("✅ Выходной поток открыт (устройство %1)").arg(output_device_index));
+    return true;
+}
+
+void AudioProcessor::close_streams() {
+    close_input_stream();
+    close_output_stream();
+}
+
+void AudioProcessor::close_input_stream() {
+    if (input_stream) {
+        Pa_StopStream(input_stream);
+        Pa_CloseStream(input_stream);
+        input_stream = nullptr;
+    }
+}
+
+void AudioProcessor::close_output_stream() {
+    if (output_stream) {
+        Pa_StopStream(output_stream);
+        Pa_CloseStream(output_stream);
+        output_stream = nullptr;
+    }
+}
+
+void AudioProcessor::stop_streams() {
+    // Потоки остаются открытыми: следующий запуск только стартует их
+    if (input_stream) {
+        Pa_StopStream(input_stream);
+    }
+    if (output_stream) {
+        Pa_StopStream(output_stream);
+    }
+}
+
 std::vector<short> AudioProcessor::generate_beep(double duration) {
+    // Снимок конфигурации не меняется до конца вызова
+    auto config = current_config();
+
     // Проверяем, есть ли бип такой длительности в кэше
     if (beep_cache.find(duration) != beep_cache.end()) {
         return beep_cache[duration];
@@ -324,7 +533,7 @@ std::vector<short> AudioProcessor::generate_beep(double duration) {
     int samples = static_cast<int>(current_sample_rate * duration);
     std::vector<short> beep_data(samples);
 
-    double beep_frequency = std::stod(config.at("beep_frequency"));
+    double beep_frequency = std::stod(config->at("beep_frequency"));
     double beep_volume = 0.5; // Громкость бипа (0.0 - 1.0)
 
     for (int i = 0; i < samples; i++) {
@@ -340,6 +549,20 @@ std::vector<short> AudioProcessor::generate_beep(double duration) {
 }
 
 void AudioProcessor::run() {
+    // Снимок конфигурации на момент запуска определяет размеры буферов;
+    // частота могла смениться в setup_streams, поэтому пересчет обязателен
+    auto config = current_config();
+    applied_config_version = 0;
+    apply_config_snapshot(config);
+
+    // Емкость буфера задержки и цель наполнения считаются из одного снимка
+    // и до остановки не меняются: иначе уменьшение задержки выбрасывало бы
+    // непроигранный звук, а увеличение съедалось бы сокращением тишины
+    double buffer_delay = std::stod(config->at("buffer_delay"));
+    int64_t preroll_samples = static_cast<int64_t>(buffer_delay * current_sample_rate);
+    chunk_size = std::stoi(config->at("chunk_size"));
+    buffer_size_in_chunks = static_cast<int>(buffer_delay * current_sample_rate / chunk_size) + 2;
+
     running = true;
     program_start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()
@@ -347,76 +570,174 @@ void AudioProcessor::run() {
 
     chunks_processed = 0;
 
-    // Очистка буферов
+    // Очистка буферов; начальная тишина буфера лежит на шкале захвата до нуля,
+    // нулевой сэмпл захвата совпадает с нулевым сэмплом распознавателя
     {
         QMutexLocker locker(&buffer_lock);
         audio_buffer.clear();
-        audio_buffer.resize(buffer_size_in_chunks * std::stoi(config.at("chunk_size")));
+        audio_buffer.resize(static_cast<size_t>(buffer_size_in_chunks) * chunk_size);
+
+        // Распознаватель переживает запуски, его время продолжается: сдвиг
+        // пересчитывается к новому началу шкалы захвата
+        recognizer_offset -= captured_samples;
+        captured_samples = 0;
     }
+    recent_xruns.clear();
+    latency_increase_requested = false;
+    device_lost = false;
+    consecutive_read_errors = 0;
+    consecutive_write_errors = 0;
 
     {
         QMutexLocker locker(&regions_lock);
         censored_regions.clear();
     }
 
+    // Незаконченная фраза прошлого запуска не должна попасть в новый результат
+    if (recognizer) {
+        vosk_recognizer_reset(recognizer.get());
+    }
+    prepare_spare_recognizer();
+
+    // Эндпоинтер: задержки Vosk, своя проверка тишины и измерение времени до результата
+    endpoint_tuner = std::make_unique<EndpointTuner>(*config, current_sample_rate);
+    if (!endpoint_tuner->apply(recognizer.get())) {
+        emit logMessage("ℹ️ Vosk без настройки эндпоинтера: конец фразы определяется и своей проверкой тишины");
+    }
+
     emit logMessage("🎤 Запись и обработка аудио начаты");
-    double buffer_delay_sec = std::stod(config.at("buffer_delay"));
     emit logMessage(QString("📊 Буферизация: воспроизведение начнется через %1 секунд...").
-                  arg(buffer_delay_sec, 0, 'f', 1));
+                  arg(buffer_delay, 0, 'f', 1));
+
+    // Профиль реального времени применяется после выделения буферов, чтобы
+    // блокировка памяти захватила буфер задержки и модель; снимается при выходе из run()
+    RealtimeProfile realtime_profile(*config);
+    if (realtime_profile.is_enabled()) {
+        std::vector<RealtimeProfile::Step> steps;
+        bool applied = realtime_profile.apply_to_current_thread(steps);
+        for (const auto& step : steps) {
+            emit logMessage(QString("%1 Реальное время: %2")
+                            .arg(step.applied ? "⚡" : "⚠️")
+                            .arg(QString::fromStdString(step.message)));
+        }
+        if (!applied) {
+            emit logMessage("⚠️ Профиль реального времени применен не полностью, обработка продолжается");
+        }
+    }
 
     // Запускаем стримы
-    Pa_StartStream(input_stream);
-    Pa_StartStream(output_stream);
+    PaError start_error = Pa_StartStream(input_stream);
+    if (start_error == paNoError) {
+        start_error = Pa_StartStream(output_stream);
+    }
+    if (start_error != paNoError) {
+        emit logMessage(QString("❌ Ошибка запуска аудио потоков: %1").arg(Pa_GetErrorText(start_error)));
+        // Устройство могло пропасть после настройки потоков
+        device_lost = true;
+    }
+
+    // Отсчет для оценки потерь входа при переполнении
+    input_stream_start = Pa_GetStreamTime(input_stream);
+    input_samples_read = 0;
+    publish_xrun_stats(true);
 
     // Подготавливаем буфер для чтения данных
-    int chunk_size = std::stoi(config.at("chunk_size"));
     std::vector<short> input_chunk(chunk_size);
     std::vector<short> output_chunk(chunk_size);
 
+    // Выход подстраивается под часы входа; чанк выхода может быть на сэмпл
+    // длиннее или короче чанка захвата
+    drift_compensator = std::make_unique<DriftCompensator>(*config, current_sample_rate, chunk_size);
+    std::vector<short> resampled_chunk;
+    resampled_chunk.reserve(chunk_size * 2);
+
+    // Границы запрещенных слов уточняются по аудио в буфере задержки
+    boundary_refiner = std::make_unique<BoundaryRefiner>(*config, current_sample_rate);
+    boundary_window.reserve(boundary_refiner->search_samples() * 2);
+
+    // Задержка сверх цели сокращается за счет пауз; блок - чанк выхода плюс
+    // сэмплы, которые можно выбросить (не больше чанка)
+    SilenceCompressor silence_compressor(*config, current_sample_rate);
+    std::vector<short> catchup_block(chunk_size * 2);
+
+    // Последние секунды захвата для повторного распознавания подозрительных слов;
+    // пул распознавателей работает в своих потоках на модели проверки
+    int lookback_ms = std::stoi(config->get("redecode_lookback_ms", std::to_string(DEFAULT_REDECODE_LOOKBACK_MS)));
+    lookback_ring = std::make_unique<LookbackRing>(static_cast<size_t>(current_sample_rate) * lookback_ms / 1000);
+    lookback_ring->reset(captured_samples);
+    redecode_worker.reset();
+    if (config->get("redecode_enabled", "true") == "true" && model) {
+        int max_window_ms = std::stoi(config->get("redecode_max_window_ms",
+                                                  std::to_string(DEFAULT_REDECODE_MAX_WINDOW_MS)));
+        size_t queue_limit = std::stoul(config->get("redecode_queue_size",
+                                                    std::to_string(DEFAULT_REDECODE_QUEUE_SIZE)));
+        size_t workers = std::stoul(config->get("verify_workers", std::to_string(DEFAULT_VERIFY_WORKERS)));
+        int cycle_s = std::stoi(config->get("recognizer_cycle_s", std::to_string(DEFAULT_RECOGNIZER_CYCLE_S)));
+        redecode_worker = std::make_unique<RedecodeWorker>(
+            verify_model ? verify_model : model, current_sample_rate, *lookback_ring,
+            static_cast<size_t>(current_sample_rate) * max_window_ms / 1000, queue_limit, workers,
+            static_cast<int64_t>(std::max(cycle_s, 0)) * current_sample_rate);
+        if (!redecode_worker->start()) {
+            emit logMessage("⚠️ Повторное распознавание недоступно");
+            redecode_worker.reset();
+        } else if (verify_model) {
+            emit logMessage(QString("🔁 Проверка окон моделью проверки: потоков %1")
+                            .arg(redecode_worker->thread_count()));
+        }
+    }
+
     // Переменные для распознавания
-    std::string audio_data_for_recognition;
     bool recognition_active = true;
 
-    // Ждем, пока буфер наполнится
-    auto recording_start = std::chrono::system_clock::now();
-    double buffer_delay = std::stod(config.at("buffer_delay"));
+    // Ждем, пока буфер наполнится; считаем по захваченным сэмплам, а не по часам,
+    // чтобы пауза во время наполнения не сокращала задержку
+    while (captured_samples < preroll_samples && running) {
+        // Флаги берутся из нового снимка сразу, задержка буфера - при следующем запуске
+        config = current_config();
+        apply_config_snapshot(config);
+
+        // На паузе поток спит до resume() или остановки
+        if (paused) {
+            wait_while_paused();
+            continue;
+        }
+
+        // Устройство отключено: ждем его возвращения и переоткрываем потоки
+        if (device_lost) {
+            reconnect_devices();
+            continue;
+        }
 
-    while (std::chrono::duration<double>(std::chrono::system_clock::now() - recording_start).count() < buffer_delay && running) {
         if (!paused) {
             try {
                 // Чтение данных с микрофона
-                Pa_ReadStream(input_stream, input_chunk.data(), chunk_size);
+                if (!read_input_chunk(input_chunk)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    continue;
+                }
 
                 // Добавляем в буфер
-                {
-                    QMutexLocker locker(&buffer_lock);
-                    for (short sample : input_chunk) {
-                        audio_buffer.push_back(sample);
-                        if (audio_buffer.size() > buffer_size_in_chunks * chunk_size) {
-                            audio_buffer.pop_front();
-                        }
-                    }
-                }
+                append_to_buffer(input_chunk.data(), input_chunk.size());
 
                 // Обновляем информацию о буфере в UI
                 emit bufferUpdate(static_cast<int>(audio_buffer.size()),
                                 buffer_size_in_chunks * chunk_size);
 
                 // Накапливаем данные для распознавания
-                if (recognition_active && config.at("enable_censoring") == "true") {
-                    // Копируем в строку для распознавания
-                    const char* input_data = reinterpret_cast<const char*>(input_chunk.data());
-                    audio_data_for_recognition.append(input_data, chunk_size * sizeof(short));
-
+                if (recognition_active && settings.censoring_enabled) {
                     // Отправляем на распознавание речи
-                    if (vosk_recognizer_accept_waveform(recognizer.get(),
-                                                      input_data,
-                                                      chunk_size * sizeof(short))) {
-                        const char* result_json = vosk_recognizer_result(recognizer.get());
-                        process_recognition_result(result_json);
-                    }
+                    recognize_chunk(input_chunk);
+                } else {
+                    // Чанк не попал к распознавателю: его время отстает от шкалы захвата
+                    recognizer_offset += chunk_size;
                 }
 
+                // Результаты повторного распознавания проверяются здесь же, чтобы
+                // детектор и регионы цензуры обслуживал один поток
+                collect_redecode_results();
+
+                publish_xrun_stats();
+
             } catch (const std::exception& e) {
                 emit logMessage(QString("❌ Ошибка при записи аудио: %1").arg(e.what()));
             }
@@ -430,85 +751,113 @@ void AudioProcessor::run() {
 
     // Основной цикл обработки
     while (running) {
+        // Флаги берутся из нового снимка сразу, задержка буфера - при следующем запуске
+        config = current_config();
+        apply_config_snapshot(config);
+
+        // На паузе поток спит до resume() или остановки
+        if (paused) {
+            wait_while_paused();
+            continue;
+        }
+
+        // Устройство отключено: ждем его возвращения и переоткрываем потоки
+        if (device_lost) {
+            reconnect_devices();
+            continue;
+        }
+
         if (!paused) {
             try {
                 // Запись с микрофона
-                Pa_ReadStream(input_stream, input_chunk.data(), chunk_size);
+                if (!read_input_chunk(input_chunk)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    continue;
+                }
 
                 // Добавляем в буфер
-                {
-                    QMutexLocker locker(&buffer_lock);
-                    for (short sample : input_chunk) {
-                        audio_buffer.push_back(sample);
-                        if (audio_buffer.size() > buffer_size_in_chunks * chunk_size) {
-                            audio_buffer.pop_front();
-                        }
-                    }
-                }
+                append_to_buffer(input_chunk.data(), input_chunk.size());
 
                 // Накапливаем данные для распознавания
-                if (recognition_active && config.at("enable_censoring") == "true") {
-                    // Копируем в строку для распознавания
-                    const char* input_data = reinterpret_cast<const char*>(input_chunk.data());
-                    audio_data_for_recognition.append(input_data, chunk_size * sizeof(short));
-
-                    // Ограничиваем размер данных для распознавания
-                    size_t max_recognition_bytes = current_sample_rate * sizeof(short) * 2; // ~2 секунды аудио
-                    if (audio_data_for_recognition.size() > max_recognition_bytes) {
-                        audio_data_for_recognition = audio_data_for_recognition.substr(
-                            audio_data_for_recognition.size() - max_recognition_bytes
-                        );
-                    }
-
+                if (recognition_active && settings.censoring_enabled) {
                     // Отправляем на распознавание речи
-                    if (vosk_recognizer_accept_waveform(recognizer.get(),
-                                                      input_data,
-                                                      chunk_size * sizeof(short))) {
-                        const char* result_json = vosk_recognizer_result(recognizer.get());
-                        process_recognition_result(result_json);
-                    }
+                    recognize_chunk(input_chunk);
+                } else {
+                    // Чанк не попал к распознавателю: его время отстает от шкалы захвата
+                    recognizer_offset += chunk_size;
                 }
 
-                // Воспроизведение с задержкой
-                std::fill(output_chunk.begin(), output_chunk.end(), 0); // Заполняем нулями
+                // Результаты повторного распознавания проверяются здесь же, чтобы
+                // детектор и регионы цензуры обслуживал один поток
+                collect_redecode_results();
 
-                // Извлекаем чанк из буфера
+                // Воспроизведение с задержкой: блок - чанк выхода плюс сэмплы, которые
+                // можно выбросить при сокращении задержки
                 size_t samples_available;
+                int64_t chunk_first_sample;
+                size_t budget;
+                size_t block;
                 {
                     QMutexLocker locker(&buffer_lock);
                     samples_available = audio_buffer.size();
+                    chunk_first_sample = captured_samples - static_cast<int64_t>(samples_available);
 
-                    if (samples_available >= chunk_size) {
-                        for (int i = 0; i < chunk_size; i++) {
-                            if (!audio_buffer.empty()) {
-                                output_chunk[i] = audio_buffer.front();
-                                audio_buffer.pop_front();
-                            }
-                        }
-                    } else {
+                    if (samples_available < static_cast<size_t>(chunk_size)) {
                         // Если недостаточно данных, продолжаем цикл
                         continue;
                     }
+
+                    // Цель - задержка после наполнения плюс только что добавленный чанк
+                    budget = silence_compressor.drop_budget(
+                        samples_available, static_cast<size_t>(preroll_samples) + chunk_size, chunk_size);
+                    block = chunk_size + budget;
+                    std::copy(audio_buffer.begin(), audio_buffer.begin() + block, catchup_block.begin());
+                }
+
+                // Цензура до сокращения тишины: заглушенные сэмплы тоже могут быть выброшены.
+                // Регионы и блок сравниваются по индексам захвата, поэтому потери входа их не сдвигают
+                bool censoring_enabled = settings.censoring_enabled;
+                if (censoring_enabled) {
+                    apply_censorship(catchup_block.data(), block, chunk_first_sample);
+                }
+
+                // При сокращении задержки из буфера уходит больше сэмплов, чем в чанк
+                size_t samples_consumed = chunk_size;
+                if (budget > 0) {
+                    samples_consumed = silence_compressor.compress(catchup_block.data(), block,
+                                                                   output_chunk.data(), chunk_size, budget);
+                } else {
+                    std::copy(catchup_block.begin(), catchup_block.begin() + chunk_size, output_chunk.begin());
+                }
+                {
+                    QMutexLocker locker(&buffer_lock);
+                    audio_buffer.erase(audio_buffer.begin(), audio_buffer.begin() + samples_consumed);
                 }
 
-                // Проверяем, нужно ли цензурировать этот чанк
-                if (config.at("enable_censoring") == "true") {
+                if (samples_consumed > static_cast<size_t>(chunk_size)) {
+                    QMutexLocker locker(&xrun_lock);
+                    xrun_stats.samples_compressed += samples_consumed - chunk_size;
+                    xrun_stats_changed = true;
+                }
+
+                // Отмечаем регионы, попавшие в этот чанк, и удаляем пройденные
+                if (censoring_enabled) {
+                    int64_t chunk_last_sample = chunk_first_sample + static_cast<int64_t>(samples_consumed) - 1;
                     QMutexLocker locker(&regions_lock);
                     for (size_t i = 0; i < censored_regions.size(); i++) {
                         auto& region = censored_regions[i];
-                        int start_idx = std::get<0>(region);
-                        int end_idx = std::get<1>(region);
-                        bool processed = std::get<2>(region);
-
-                        if (start_idx <= chunks_processed && chunks_processed <= end_idx) {
-                            // Применяем цензуру - заменяем чанк на тишину или бип
-                            std::fill(output_chunk.begin(), output_chunk.end(), 0);
-                            emit censorApplied(chunks_processed, start_idx, end_idx);
-
-                            // Если достигли конца интервала, отмечаем его как обработанный
-                            if (chunks_processed == end_idx) {
-                                std::get<2>(region) = true;
-                            }
+                        int64_t first_sample = std::get<0>(region);
+                        int64_t last_sample = std::get<1>(region);
+
+                        if (first_sample <= chunk_last_sample && chunk_first_sample <= last_sample) {
+                            emit censorApplied(chunks_processed,
+                                               static_cast<int>(first_sample / chunk_size),
+                                               static_cast<int>(last_sample / chunk_size));
+                        }
+
+                        // Регион вместе с переходом закончился на этом чанке или раньше
+                        if (last_sample + censor_fade_samples() <= chunk_last_sample) {
+                            std::get<2>(region) = true;
                         }
                     }
 
@@ -520,8 +869,19 @@ void AudioProcessor::run() {
                     );
                 }
 
+                // Заполнение конвейера (вход, ждущий чтения, минус свободное место
+                // выхода) растет или падает только из-за расхождения часов устройств
+                if (drift_compensator->is_enabled()) {
+                    long read_available = Pa_GetStreamReadAvailable(input_stream);
+                    long write_available = Pa_GetStreamWriteAvailable(output_stream);
+                    if (read_available >= 0 && write_available >= 0) {
+                        drift_compensator->update(static_cast<double>(read_available - write_available));
+                    }
+                }
+
                 // Отправляем на выход
-                Pa_WriteStream(output_stream, output_chunk.data(), chunk_size);
+                drift_compensator->process(output_chunk.data(), output_chunk.size(), resampled_chunk);
+                write_output_chunk(resampled_chunk);
 
                 // Увеличиваем счетчик обработанных чанков
                 chunks_processed++;
@@ -530,6 +890,12 @@ void AudioProcessor::run() {
                 emit bufferUpdate(static_cast<int>(audio_buffer.size()),
                                 buffer_size_in_chunks * chunk_size);
 
+                // Частые сбои: увеличиваем задержку устройств, если это разрешено
+                if (latency_increase_requested) {
+                    increase_latency();
+                }
+                publish_xrun_stats();
+
             } catch (const std::exception& e) {
                 emit logMessage(QString("❌ Ошибка при обработке аудио: %1").arg(e.what()));
             }
@@ -539,119 +905,424 @@ void AudioProcessor::run() {
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
-    // Очистка ресурсов
-    cleanup_resources();
+    publish_xrun_stats(true);
+
+    if (endpoint_tuner && endpoint_tuner->finals() > 0) {
+        emit logMessage(QString("⏱️ Окончательных результатов: %1 (принудительно %2), до результата "
+                                "в среднем %3 мс, 50% - %4 мс, 95% - %5 мс, пауза конца фразы %6 мс")
+                        .arg(endpoint_tuner->finals())
+                        .arg(endpoint_tuner->forced_finals())
+                        .arg(endpoint_tuner->mean_ms(), 0, 'f', 0)
+                        .arg(endpoint_tuner->p50_ms(), 0, 'f', 0)
+                        .arg(endpoint_tuner->p95_ms(), 0, 'f', 0)
+                        .arg(endpoint_tuner->end_ms()));
+    }
+
+    // Потоки повторного распознавания читают кольцевой буфер: останавливаются первыми
+    if (redecode_worker) {
+        redecode_worker->stop();
+        double share = captured_samples > 0
+            ? 100.0 * static_cast<double>(redecode_worker->decoded_samples()) / static_cast<double>(captured_samples)
+            : 0.0;
+        emit logMessage(QString("📊 Проверено окон: %1 (%2% аудио), опоздали: %3, отброшено: %4")
+                        .arg(redecode_worker->decoded())
+                        .arg(share, 0, 'f', 1)
+                        .arg(redecode_worker->expired())
+                        .arg(redecode_worker->dropped()));
+        redecode_worker.reset();
+    }
+
+    // Потоки, модель и распознаватель остаются готовыми к следующему запуску
+    stop_streams();
+    {
+        QMutexLocker locker(&buffer_lock);
+        audio_buffer.clear();
+    }
+    {
+        QMutexLocker locker(&regions_lock);
+        censored_regions.clear();
+    }
     emit logMessage("✅ Обработка аудио завершена");
 }
 
-void AudioProcessor::process_recognition_result(const std::string& result_json) {
-    try {
-        // Парсим JSON
-        json result = json::parse(result_json);
+bool AudioProcessor::read_input_chunk(std::vector<short>& chunk) {
+    PaError err = Pa_ReadStream(input_stream, chunk.data(), chunk.size());
+
+    if (err == paInputOverflowed) {
+        // Данные чанка корректны, но часть сэмплов до него потеряна. Их количество
+        // оценивается по времени потока: ожидаемое число сэмплов минус полученные
+        // и еще не прочитанные
+        int64_t lost = 0;
+        double stream_time = Pa_GetStreamTime(input_stream);
+        if (stream_time > 0.0 && input_stream_start > 0.0) {
+            int64_t expected = static_cast<int64_t>((stream_time - input_stream_start) * current_sample_rate);
+            long available = Pa_GetStreamReadAvailable(input_stream);
+            lost = expected - (input_samples_read + static_cast<int64_t>(chunk.size()) +
+                               std::max<long>(available, 0));
+            lost = std::max<int64_t>(0, std::min<int64_t>(lost, current_sample_rate));
+        }
 
-        // Проверяем наличие результатов
-        if (!result.contains("result") || !result["result"].is_array()) {
-            return;
+        // Тишина на месте потерь сохраняет задержку воспроизведения, а сдвиг
+        // распознавателя - соответствие его времени индексам захвата
+        if (lost > 0) {
+            append_to_buffer(nullptr, static_cast<size_t>(lost));
+            recognizer_offset += lost;
+            input_samples_read += lost;
         }
 
-        auto words = result["result"];
-        if (words.empty()) {
-            return;
+        {
+            QMutexLocker locker(&xrun_lock);
+            xrun_stats.input_overflows++;
+            xrun_stats.samples_realigned += static_cast<uint64_t>(lost);
+            xrun_stats_changed = true;
+        }
+        record_xrun();
+    } else if (err != paNoError) {
+        {
+            QMutexLocker locker(&xrun_lock);
+            xrun_stats.read_errors++;
+            xrun_stats_changed = true;
         }
+        emit logMessage(QString("❌ Ошибка чтения входного потока: %1").arg(Pa_GetErrorText(err)));
+        note_stream_error(err, consecutive_read_errors);
+        return false;
+    }
 
-        // Выводим все распознанные слова для отладки, если включено
-        if (config.at("debug_mode") == "true") {
-            QStringList all_words;
-            for (const auto& word : words) {
-                all_words.append(QString::fromStdString(word["word"].get<std::string>()).toLower());
-            }
-            emit logMessage(QString("🔍 Распознано: %1").arg(all_words.join(", ")));
+    consecutive_read_errors = 0;
+    input_samples_read += static_cast<int64_t>(chunk.size());
+    return true;
+}
+
+void AudioProcessor::write_output_chunk(const std::vector<short>& chunk) {
+    PaError err = Pa_WriteStream(output_stream, chunk.data(), chunk.size());
+
+    if (err == paOutputUnderflowed) {
+        // Устройство успело доиграть все до записи: слышен пропуск, данные чанка приняты
+        {
+            QMutexLocker locker(&xrun_lock);
+            xrun_stats.output_underflows++;
+            xrun_stats_changed = true;
         }
+        record_xrun();
+    } else if (err != paNoError) {
+        {
+            QMutexLocker locker(&xrun_lock);
+            xrun_stats.write_errors++;
+            xrun_stats_changed = true;
+        }
+        emit logMessage(QString("❌ Ошибка записи в выходной поток: %1").arg(Pa_GetErrorText(err)));
+        note_stream_error(err, consecutive_write_errors);
+        return;
+    }
+
+    consecutive_write_errors = 0;
+}
 
-        // Текущее время от начала программы
-        double elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()
-        ).count() / 1000.0 - program_start_time;
+void AudioProcessor::note_stream_error(int error, int& consecutive_errors) {
+    // Отключение устройства PortAudio сообщает по-разному в зависимости от
+    // хост-API: явными кодами или повторяющимися ошибками подряд
+    if (error == paDeviceUnavailable || error == paBadStreamPtr) {
+        device_lost = true;
+        return;
+    }
 
-        // Создаем детектор слов
-        WordDetector detector(std::unordered_map<std::string, std::string>());
+    if (++consecutive_errors >= settings.device_error_threshold) {
+        device_lost = true;
+    }
+}
 
-        // Подготавливаем списки целевых слов и паттернов
-        std::vector<std::string> target_patterns;
-        std::vector<std::string> target_words;
+bool AudioProcessor::reconnect_devices() {
+    auto config = current_config();
+    int retry_interval_ms = std::stoi(config->get("device_reconnect_interval_ms",
+                                                  std::to_string(DEFAULT_DEVICE_RECONNECT_INTERVAL_MS)));
 
-        // Разбор строки с паттернами
-        if (config.find("target_patterns") != config.end()) {
-            try {
-                // Предполагаем, что это JSON-строка с массивом
-                target_patterns = json::parse(config.at("target_patterns")).get<std::vector<std::string>>();
-            } catch (...) {
-                // Если не удалось разобрать как JSON, пробуем как обычную строку с разделителями
-                std::istringstream iss(config.at("target_patterns"));
-                std::string pattern;
-                while (std::getline(iss, pattern, ',')) {
-                    if (!pattern.empty()) {
-                        target_patterns.push_back(pattern);
+    emit logMessage("🔌 Аудио устройство недоступно, ожидание переподключения...");
+
+    // Задержки устройств сохраняются: если они увеличивались из-за сбоев, это учтено
+    double input_latency;
+    double output_latency;
+    {
+        QMutexLocker locker(&xrun_lock);
+        input_latency = xrun_stats.input_latency;
+        output_latency = xrun_stats.output_latency;
+    }
+
+    // Повторная инициализация PortAudio требует закрытых потоков
+    auto lost_at = std::chrono::steady_clock::now();
+    close_streams();
+
+    while (running) {
+        DeviceCatalog::Changes changes;
+        if (device_catalog.rescan(&changes)) {
+            if (changes.any()) {
+                log_device_changes(changes);
+                publish_device_list(false);
+            }
+
+            // Устройства ищутся по ключу: после повторного подключения индексы другие
+            int input_index = device_catalog.find(input_device_key, true);
+            int output_index = device_catalog.find(output_device_key, false);
+            if (input_index >= 0 && output_index >= 0) {
+                input_device_index = input_index;
+                output_device_index = output_index;
+
+                if (open_streams(input_latency, output_latency)) {
+                    PaError err = Pa_StartStream(input_stream);
+                    if (err == paNoError) {
+                        err = Pa_StartStream(output_stream);
                     }
+                    if (err == paNoError) {
+                        break;
+                    }
+                    close_streams();
                 }
             }
         }
 
-        // Разбор строки с целевыми словами
-        if (config.find("target_words") != config.end()) {
-            try {
-                // Предполагаем, что это JSON-строка с массивом
-                target_words = json::parse(config.at("target_words")).get<std::vector<std::string>>();
-            } catch (...) {
-                // Если не удалось разобрать как JSON, пробуем как обычную строку с разделителями
-                std::istringstream iss(config.at("target_words"));
-                std::string word;
-                while (std::getline(iss, word, ',')) {
-                    if (!word.empty()) {
-                        target_words.push_back(word);
-                    }
-                }
+        // Остановка будит поток через то же условие, что и снятие паузы
+        QMutexLocker locker(&pause_lock);
+        if (running) {
+            pause_condition.wait(&pause_lock, static_cast<unsigned long>(std::max(retry_interval_ms, 10)));
+        }
+    }
+
+    if (!running) {
+        return false;
+    }
+
+    // Время без входа восполняется тишиной, чтобы задержка воспроизведения
+    // сохранилась; больше емкости буфера вставлять нет смысла
+    double lost_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lost_at).count();
+    int64_t capacity = static_cast<int64_t>(buffer_size_in_chunks) * chunk_size;
+    int64_t gap = std::min<int64_t>(static_cast<int64_t>(lost_seconds * current_sample_rate), capacity);
+    append_to_buffer(nullptr, static_cast<size_t>(gap));
+    recognizer_offset += gap;
+    input_stream_start = Pa_GetStreamTime(input_stream);
+    input_samples_read = 0;
+
+    device_lost = false;
+    consecutive_read_errors = 0;
+    consecutive_write_errors = 0;
+
+    // Устройство после переподключения может быть другим экземпляром со своими часами
+    if (drift_compensator) {
+        drift_compensator->reset();
+    }
+    {
+        QMutexLocker locker(&xrun_lock);
+        xrun_stats.device_reconnects++;
+        xrun_stats.samples_realigned += static_cast<uint64_t>(gap);
+        xrun_stats_changed = true;
+    }
+
+    emit logMessage(QString("✅ Аудио устройства переподключены через %1 с").arg(lost_seconds, 0, 'f', 1));
+    return true;
+}
+
+void AudioProcessor::append_to_buffer(const short* samples, size_t count) {
+    size_t max_samples = static_cast<size_t>(buffer_size_in_chunks) * chunk_size;
+
+    // Кольцевой буфер ведет ту же шкалу захвата; у него своя блокировка
+    if (lookback_ring) {
+        lookback_ring->write(samples, count);
+    }
+
+    // Сэмплы добавляются и вытесняются блоками, а не по одному
+    QMutexLocker locker(&buffer_lock);
+    if (samples) {
+        audio_buffer.insert(audio_buffer.end(), samples, samples + count);
+    } else {
+        audio_buffer.insert(audio_buffer.end(), count, 0);
+    }
+    if (audio_buffer.size() > max_samples) {
+        audio_buffer.erase(audio_buffer.begin(), audio_buffer.begin() + (audio_buffer.size() - max_samples));
+    }
+    captured_samples += static_cast<int64_t>(count);
+}
+
+void AudioProcessor::record_xrun() {
+    if (!settings.xrun_adaptive_latency) {
+        return;
+    }
+
+    // Сбои считаются в скользящем окне
+    auto now = std::chrono::steady_clock::now();
+    auto window = std::chrono::milliseconds(settings.xrun_window_ms);
+    recent_xruns.push_back(now);
+    while (!recent_xruns.empty() && now - recent_xruns.front() > window) {
+        recent_xruns.pop_front();
+    }
+
+    if (static_cast<int>(recent_xruns.size()) >= settings.xrun_threshold) {
+        latency_increase_requested = true;
+        recent_xruns.clear();
+    }
+}
+
+void AudioProcessor::publish_xrun_stats(bool force) {
+    auto now = std::chrono::steady_clock::now();
+    XrunStats stats;
+    {
+        QMutexLocker locker(&xrun_lock);
+
+        // Оценка расхождения часов меняется плавно, ее мелкие колебания не публикуются
+        if (drift_compensator && drift_compensator->is_enabled() &&
+            std::abs(drift_compensator->drift_ppm() - xrun_stats.drift_ppm) >= 1.0) {
+            xrun_stats.drift_ppm = drift_compensator->drift_ppm();
+            xrun_stats_changed = true;
+        }
+
+        if (!force && (!xrun_stats_changed || now - last_xrun_publish < std::chrono::seconds(1))) {
+            return;
+        }
+        stats = xrun_stats;
+        xrun_stats_changed = false;
+    }
+    last_xrun_publish = now;
+
+    QVariantMap telemetry;
+    telemetry["input_overflows"] = static_cast<qulonglong>(stats.input_overflows);
+    telemetry["output_underflows"] = static_cast<qulonglong>(stats.output_underflows);
+    telemetry["read_errors"] = static_cast<qulonglong>(stats.read_errors);
+    telemetry["write_errors"] = static_cast<qulonglong>(stats.write_errors);
+    telemetry["samples_realigned"] = static_cast<qulonglong>(stats.samples_realigned);
+    telemetry["latency_increases"] = stats.latency_increases;
+    telemetry["device_reconnects"] = stats.device_reconnects;
+    telemetry["drift_ppm"] = stats.drift_ppm;
+    telemetry["samples_compressed"] = static_cast<qulonglong>(stats.samples_compressed);
+    telemetry["input_latency_ms"] = stats.input_latency * 1000.0;
+    telemetry["output_latency_ms"] = stats.output_latency * 1000.0;
+    emit xrunUpdate(telemetry);
+}
+
+bool AudioProcessor::increase_latency() {
+    latency_increase_requested = false;
+
+    double max_latency = settings.xrun_max_latency_ms / 1000.0;
+
+    double input_latency;
+    double output_latency;
+    {
+        QMutexLocker locker(&xrun_lock);
+        input_latency = xrun_stats.input_latency;
+        output_latency = xrun_stats.output_latency;
+    }
+    if (input_latency >= max_latency && output_latency >= max_latency) {
+        return false;
+    }
+
+    // Задержка удваивается, но не выше предела
+    double new_input_latency = std::min(std::max(input_latency * 2.0, 0.01), max_latency);
+    double new_output_latency = std::min(std::max(output_latency * 2.0, 0.01), max_latency);
+
+    // Пока потоки переоткрываются, вход не читается; это время восполняется тишиной
+    auto reopen_start = std::chrono::steady_clock::now();
+    close_streams();
+    if (!open_streams(new_input_latency, new_output_latency) &&
+        !open_streams(input_latency, output_latency)) {
+        emit logMessage("❌ Не удалось переоткрыть аудио потоки, обработка остановлена");
+        running = false;
+        return false;
+    }
+    PaError start_error = Pa_StartStream(input_stream);
+    if (start_error == paNoError) {
+        start_error = Pa_StartStream(output_stream);
+    }
+    if (start_error != paNoError) {
+        emit logMessage(QString("❌ Ошибка запуска аудио потоков: %1").arg(Pa_GetErrorText(start_error)));
+        // Потоки переоткрываются и запускаются заново при переподключении
+        device_lost = true;
+        return false;
+    }
+
+    int64_t gap = static_cast<int64_t>(std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - reopen_start).count() * current_sample_rate);
+    append_to_buffer(nullptr, static_cast<size_t>(gap));
+    recognizer_offset += gap;
+    input_stream_start = Pa_GetStreamTime(input_stream);
+    input_samples_read = 0;
+
+    // Очереди устройств стали длиннее: целевое заполнение измеряется заново
+    if (drift_compensator) {
+        drift_compensator->restart();
+    }
+
+    XrunStats stats;
+    {
+        QMutexLocker locker(&xrun_lock);
+        xrun_stats.latency_increases++;
+        xrun_stats.samples_realigned += static_cast<uint64_t>(gap);
+        xrun_stats_changed = true;
+        stats = xrun_stats;
+    }
+    emit logMessage(QString("⚠️ Частые сбои аудио: задержка устройств увеличена до %1/%2 мс")
+                    .arg(stats.input_latency * 1000.0, 0, 'f', 0)
+                    .arg(stats.output_latency * 1000.0, 0, 'f', 0));
+    return true;
+}
+
+AudioProcessor::XrunStats AudioProcessor::get_xrun_stats() const {
+    QMutexLocker locker(&xrun_lock);
+    return xrun_stats;
+}
+
+void AudioProcessor::process_recognition_result(const std::string& result_json) {
+    try {
+        // Разбираем JSON без построения дерева, слова попадают в переиспользуемый массив
+        if (!result_parser.parse(result_json)) {
+            emit logMessage(QString("❌ Ошибка при разборе JSON результатов распознавания: %1")
+                            .arg(QString::fromStdString(result_parser.error())));
+            return;
+        }
+
+        // Проверяем наличие результатов
+        if (result_parser.empty()) {
+            return;
+        }
+
+        // Выводим все распознанные слова для отладки, если включено
+        if (settings.debug_mode) {
+            QStringList all_words;
+            for (const auto& word : result_parser) {
+                all_words.append(QString::fromStdString(word.word).toLower());
             }
+            emit logMessage(QString("🔍 Распознано: %1").arg(all_words.join(", ")));
         }
 
-        // Параметры для вычисления индексов чанков
-        int chunk_size = std::stoi(config.at("chunk_size"));
-        double buffer_delay = std::stod(config.at("buffer_delay"));
-        int safety_margin = std::stoi(config.at("safety_margin"));
-        double chunks_per_second = static_cast<double>(current_sample_rate) / chunk_size;
+        // Запас вокруг слова задается в чанках; используется, если границу не удалось уточнить
+        int64_t margin_samples = static_cast<int64_t>(settings.safety_margin) * chunk_size;
 
-        for (const auto& word : words) {
-            std::string word_text = word["word"].get<std::string>();
-            std::transform(word_text.begin(), word_text.end(), word_text.begin(),
-                         [](unsigned char c){ return std::tolower(c); });
+        for (const auto& word : result_parser) {
+            // Нижний регистр нужен только для лога, детектор нормализует слово сам
+            std::string word_text;
+            text::fold_case(word.word, word_text);
 
             // Проверяем, является ли слово запрещенным
             bool is_prohibited;
             std::string matched_pattern;
-            std::tie(is_prohibited, matched_pattern) = detector.is_prohibited_word(word_text,
-                                                                               target_patterns,
-                                                                               target_words);
+            std::tie(is_prohibited, matched_pattern) = detector->is_prohibited_word(word_text);
+
+            // Получаем время начала и конца слова
+            double start_time = word.start;
+            double end_time = word.end;
+
+            // Время распознавателя переводится в индексы захвата: они не зависят
+            // от настенных часов и не сдвигаются при потерях входа
+            int64_t first_sample = static_cast<int64_t>(start_time * current_sample_rate) +
+                                   recognizer_offset;
+            int64_t last_sample = static_cast<int64_t>(std::ceil(end_time * current_sample_rate)) +
+                                  recognizer_offset;
+
+            // Проверяются слова с низкой уверенностью и почти совпадающие со словарем
+            // Слова, в которых распознаватель не уверен, распознаются повторно по аудио из кольцевого буфера
+            if (!is_prohibited && (word.conf < settings.redecode_confidence || word_text == "[unk]" ||
+                                   detector->is_near_miss(word_text, settings.near_miss_distance))) {
+                schedule_redecode(word_text, first_sample, last_sample);
+            }
 
             if (is_prohibited) {
-                // Получаем время начала и конца слова
-                double start_time = word["start"].get<double>();
-                double end_time = word["end"].get<double>();
-
-                // Рассчитываем индексы чанков для цензуры с учетом текущей частоты дискретизации
-                int chunks_offset_start = static_cast<int>((start_time - (elapsed_time - buffer_delay)) *
-                                                      chunks_per_second) - safety_margin;
-                int chunks_offset_end = static_cast<int>((end_time - (elapsed_time - buffer_delay)) *
-                                                    chunks_per_second) + safety_margin;
-
-                // Абсолютные индексы чанков для цензуры
-                int censored_chunk_start = chunks_processed + chunks_offset_start;
-                int censored_chunk_end = chunks_processed + chunks_offset_end;
-
                 // Добавляем регион для цензуры
-                {
-                    QMutexLocker locker(&regions_lock);
-                    censored_regions.push_back(std::make_tuple(censored_chunk_start, censored_chunk_end, false));
-                }
+                add_censor_region(first_sample, last_sample, margin_samples);
 
                 // Уведомляем о найденном слове
                 emit wordDetected(QString::fromStdString(word_text), start_time, end_time);
@@ -668,9 +1339,9 @@ void AudioProcessor::process_recognition_result(const std::string& result_json)
                 emit logMessage(log_message);
 
                 // Сохраняем в файл, если включено
-                if (config.at("log_to_file") == "true") {
+                if (settings.log_to_file) {
                     try {
-                        std::ofstream log_file(config.at("log_file"), std::ios::app);
+                        std::ofstream log_file(settings.log_file, std::ios::app);
                         if (log_file.is_open()) {
                             auto now = std::chrono::system_clock::now();
                             auto now_time_t = std::chrono::system_clock::to_time_t(now);
@@ -692,70 +1363,542 @@ void AudioProcessor::process_recognition_result(const std::string& result_json)
             }
         }
 
-    } catch (const json::parse_error& e) {
-        emit logMessage(QString("❌ Ошибка при разборе JSON результатов распознавания: %1").arg(e.what()));
     } catch (const std::exception& e) {
         emit logMessage(QString("❌ Ошибка при обработке результатов распознавания: %1").arg(e.what()));
     }
 }
 
-void AudioProcessor::update_config(const std::unordered_map<std::string, std::string>& new_config) {
-    config = new_config;
+void AudioProcessor::add_censor_region(int64_t first_sample, int64_t last_sample, int64_t margin_samples) {
+    // Аудио слова еще в буфере задержки: границы переносятся на края звучания.
+    // Уточненная граница не заходит внутрь отчета распознавателя, поэтому запас
+    // safety_margin заменяется только защитным отступом уточнения
+    if (!refine_boundary(first_sample, true)) {
+        first_sample -= margin_samples;
+    }
+    if (!refine_boundary(last_sample, false)) {
+        last_sample += margin_samples;
+    }
+
+    QMutexLocker locker(&regions_lock);
+    censored_regions.push_back(std::make_tuple(first_sample, last_sample, false));
+}
+
+void AudioProcessor::schedule_redecode(const std::string& word, int64_t first_sample, int64_t last_sample) {
+    if (!redecode_worker || !lookback_ring) {
+        return;
+    }
+
+    // Окно - слово с запасом по краям, в пределах того, что хранит кольцевой буфер
+    int64_t padding = static_cast<int64_t>(current_sample_rate) * settings.redecode_padding_ms / 1000;
+    int64_t window_first = std::max(first_sample - padding, lookback_ring->first_index());
+    int64_t window_end = std::min(last_sample + 1 + padding, lookback_ring->end_index());
+    if (window_end <= window_first) {
+        return;
+    }
+
+    // Срок - момент, когда начало слова прозвучит на выходе
+    int64_t play_position;
+    {
+        QMutexLocker locker(&buffer_lock);
+        play_position = captured_samples - static_cast<int64_t>(audio_buffer.size());
+    }
+    if (first_sample <= play_position) {
+        return;
+    }
+    auto until_playback = std::chrono::microseconds((first_sample - play_position) * 1000000 / current_sample_rate);
+
+    RedecodeWorker::Job job;
+    job.first_sample = window_first;
+    job.count = static_cast<size_t>(window_end - window_first);
+    job.word = word;
+    job.deadline = std::chrono::steady_clock::now() + until_playback;
+    redecode_worker->submit(job);
+}
+
+void AudioProcessor::collect_redecode_results() {
+    if (!redecode_worker) {
+        return;
+    }
+
+    int64_t margin_samples = static_cast<int64_t>(settings.safety_margin) * chunk_size;
+
+    RedecodeWorker::Result result;
+    while (redecode_worker->take_result(result)) {
+        for (const auto& word : result.words) {
+            std::string word_text;
+            text::fold_case(word.word, word_text);
 
-    // Пересчитываем размер буфера
-    buffer_size_in_chunks = static_cast<int>(std::stod(config.at("buffer_delay")) * current_sample_rate /
-                                          std::stoi(config.at("chunk_size"))) + 2;
+            bool is_prohibited;
+            std::string matched_pattern;
+            std::tie(is_prohibited, matched_pattern) = detector->is_prohibited_word(word_text);
+            if (!is_prohibited) {
+                continue;
+            }
 
-    // Очищаем кэш бипов при изменении частоты или громкости
+            // Окно с запасом могло захватить слово, уже отмеченное основным распознавателем
+            bool covered = false;
+            {
+                QMutexLocker locker(&regions_lock);
+                for (const auto& region : censored_regions) {
+                    if (std::get<0>(region) <= word.last_sample && std::get<1>(region) >= word.first_sample) {
+                        covered = true;
+                        break;
+                    }
+                }
+            }
+            if (covered) {
+                continue;
+            }
+
+            // Слово, уже ушедшее на выход, заглушить нельзя
+            int64_t play_position;
+            {
+                QMutexLocker locker(&buffer_lock);
+                play_position = captured_samples - static_cast<int64_t>(audio_buffer.size());
+            }
+            if (word.last_sample < play_position) {
+                emit logMessage(QString("⏱️ Повторное распознавание опоздало: \"%1\" уже воспроизведено")
+                                .arg(QString::fromStdString(word_text)));
+                continue;
+            }
+
+            add_censor_region(word.first_sample, word.last_sample, margin_samples);
+
+            double start_time = static_cast<double>(word.first_sample - recognizer_offset) / current_sample_rate;
+            double end_time = static_cast<double>(word.last_sample - recognizer_offset) / current_sample_rate;
+            emit wordDetected(QString::fromStdString(word_text), start_time, end_time);
+            emit logMessage(QString("🔁 Повторное распознавание: \"%1\" вместо \"%2\" (%3с - %4с)")
+                            .arg(QString::fromStdString(word_text))
+                            .arg(QString::fromStdString(result.job.word))
+                            .arg(start_time, 0, 'f', 2)
+                            .arg(end_time, 0, 'f', 2));
+        }
+    }
+}
+
+void AudioProcessor::recognize_chunk(const std::vector<short>& chunk) {
+    const char* input_data = reinterpret_cast<const char*>(chunk.data());
+    bool endpoint = vosk_recognizer_accept_waveform(recognizer.get(), input_data,
+                                                    static_cast<int>(chunk.size() * sizeof(short)));
+    recognizer_samples_fed += static_cast<int64_t>(chunk.size());
+
+    // Своя проверка тишины может закрыть фразу раньше эндпоинтера Vosk
+    bool silence = endpoint_tuner && endpoint_tuner->process_chunk(chunk.data(), chunk.size());
+    if (!endpoint && !silence) {
+        return;
+    }
+
+    const char* result_json = endpoint ? vosk_recognizer_result(recognizer.get())
+                                       : vosk_recognizer_final_result(recognizer.get());
+    process_recognition_result(result_json);
+    note_final_result(!endpoint);
+
+    // Фраза закончилась: удобный момент сменить распознаватель
+    cycle_recognizer();
+}
+
+void AudioProcessor::note_final_result(bool forced) {
+    if (!endpoint_tuner) {
+        return;
+    }
+
+    // Задержка - от конца последнего слова до текущего индекса захвата
+    int64_t latency = -1;
+    if (!result_parser.empty()) {
+        const auto& last = result_parser[result_parser.size() - 1];
+        int64_t last_sample = static_cast<int64_t>(std::ceil(last.end * current_sample_rate)) + recognizer_offset;
+        latency = std::max<int64_t>(0, captured_samples - last_sample);
+    }
+
+    if (endpoint_tuner->on_final(latency, forced)) {
+        endpoint_tuner->apply(recognizer.get());
+        if (settings.debug_mode) {
+            emit logMessage(QString("⏱️ Пауза конца фразы изменена: %1 мс").arg(endpoint_tuner->end_ms()));
+        }
+    }
+}
+
+bool AudioProcessor::cycle_recognizer() {
+    int cycle_s = settings.recognizer_cycle_s;
+    if (cycle_s <= 0 || recognizer_samples_fed < static_cast<int64_t>(cycle_s) * current_sample_rate) {
+        return false;
+    }
+
+    std::shared_ptr<VoskRecognizer> fresh;
+    {
+        QMutexLocker locker(&spare_lock);
+        fresh = std::move(spare_recognizer);
+    }
+    if (!fresh) {
+        // Запасной еще не готов: попробуем на следующей паузе
+        prepare_spare_recognizer();
+        return false;
+    }
+
+    // Все захваченные сэмплы уже поданы старому распознавателю; нулевой
+    // сэмпл нового - следующий сэмпл захвата
+    std::shared_ptr<VoskRecognizer> retired = std::move(recognizer);
+    recognizer = std::move(fresh);
+    recognizer_offset = captured_samples;
+    if (endpoint_tuner) {
+        endpoint_tuner->apply(recognizer.get());
+    }
+    double minutes = static_cast<double>(recognizer_samples_fed) / current_sample_rate / 60.0;
+    recognizer_samples_fed = 0;
+    recognizer_cycles++;
+
+    // Освобождение старого и создание следующего - вне потока обработки
+    prepare_spare_recognizer(std::move(retired));
+
+    if (settings.debug_mode) {
+        emit logMessage(QString("♻️ Распознаватель заменен после %1 мин работы (замена №%2)")
+                        .arg(minutes, 0, 'f', 1)
+                        .arg(recognizer_cycles));
+    }
+    return true;
+}
+
+void AudioProcessor::prepare_spare_recognizer(std::shared_ptr<VoskRecognizer> retired) {
+    if (spare_building || !model || (settings.recognizer_cycle_s <= 0 && !retired)) {
+        return;
+    }
+
+    // Прошлая сборка закончена (флаг снимается до публикации), ожидание короткое
+    if (spare_builder.joinable()) {
+        spare_builder.join();
+    }
+
+    {
+        QMutexLocker locker(&spare_lock);
+        if (spare_recognizer && !retired) {
+            return;
+        }
+    }
+
+    spare_building = true;
+    spare_builder = std::thread([this, model = model, rate = current_sample_rate,
+                                 retired = std::move(retired)]() mutable {
+        RealtimeProfile::apply_background_to_current_thread();
+        retired.reset();
+
+        std::shared_ptr<VoskRecognizer> fresh(vosk_recognizer_new(model.get(), static_cast<float>(rate)),
+                                              vosk_recognizer_free);
+        if (fresh) {
+            vosk_recognizer_set_words(fresh.get(), 1);
+        }
+
+        spare_building = false;
+        if (fresh) {
+            QMutexLocker locker(&spare_lock);
+            spare_recognizer = std::move(fresh);
+        }
+    });
+}
+
+void AudioProcessor::discard_spare_recognizer() {
+    if (spare_builder.joinable()) {
+        spare_builder.join();
+    }
+    QMutexLocker locker(&spare_lock);
+    spare_recognizer.reset();
+}
+
+bool AudioProcessor::refine_boundary(int64_t& boundary, bool word_start) {
+    if (!boundary_refiner || !boundary_refiner->is_enabled()) {
+        return false;
+    }
+
+    // Окно вокруг границы обрезается по содержимому буфера: начало слова могло
+    // уже уйти на выход, конец - еще не прийти со входа
+    int64_t search = static_cast<int64_t>(boundary_refiner->search_samples());
+    int64_t window_first;
+    {
+        QMutexLocker locker(&buffer_lock);
+        int64_t buffer_first = captured_samples - static_cast<int64_t>(audio_buffer.size());
+        window_first = std::max(boundary - search, buffer_first);
+        int64_t window_end = std::min(boundary + search, captured_samples);
+        if (boundary < window_first || boundary >= window_end) {
+            return false;
+        }
+        boundary_window.assign(audio_buffer.begin() + (window_first - buffer_first),
+                               audio_buffer.begin() + (window_end - buffer_first));
+    }
+
+    if (word_start) {
+        return boundary_refiner->refine_start(boundary_window.data(), boundary_window.size(),
+                                              window_first, boundary);
+    }
+    return boundary_refiner->refine_end(boundary_window.data(), boundary_window.size(),
+                                        window_first, boundary);
+}
+
+void AudioProcessor::apply_censorship(short* samples, size_t count, int64_t first_sample) {
+    int64_t fade = censor_fade_samples();
+    int64_t last_sample = first_sample + static_cast<int64_t>(count) - 1;
+
+    QMutexLocker locker(&regions_lock);
+    for (const auto& region : censored_regions) {
+        int64_t region_first = std::get<0>(region);
+        int64_t region_last = std::get<1>(region);
+        if (region_first - fade > last_sample || region_last + fade < first_sample) {
+            continue;
+        }
+
+        // Внутри региона тишина, на краях - линейный переход; усиление зависит
+        // только от индекса захвата, поэтому не зависит от разбиения на чанки
+        int64_t from = std::max(region_first - fade, first_sample);
+        int64_t to = std::min(region_last + fade, last_sample);
+        for (int64_t index = from; index <= to; index++) {
+            float gain = 0.0f;
+            if (index < region_first) {
+                gain = static_cast<float>(region_first - index) / static_cast<float>(fade + 1);
+            } else if (index > region_last) {
+                gain = static_cast<float>(index - region_last) / static_cast<float>(fade + 1);
+            }
+            short& sample = samples[index - first_sample];
+            sample = static_cast<short>(sample * gain);
+        }
+    }
+}
+
+int64_t AudioProcessor::censor_fade_samples() const {
+    return static_cast<int64_t>(current_sample_rate) * CENSOR_FADE_MS / 1000;
+}
+
+void AudioProcessor::load_dictionary() {
+    // Снимок конфигурации не меняется до конца вызова
+    auto config = current_config();
+
+    // Скомпилированный файл читается одним блоком и подключается без разбора
+    if (config->contains("dictionary_path") && !config->at("dictionary_path").empty()) {
+        auto loaded = CompiledDictionary::open(config->at("dictionary_path"));
+        if (loaded) {
+            detector->set_dictionary(std::move(loaded));
+            return;
+        }
+
+        // Поврежденный образ или образ прежнего формата (списки в открытом виде)
+        // удаляется; словарь сохранится заново при следующем обновлении списков
+        std::error_code ignored;
+        std::filesystem::remove(std::filesystem::u8path(config->at("dictionary_path")), ignored);
+    }
+
+    // Файла еще нет: компилируем словарь из списков конфигурации один раз
+    auto parse_list = [](const std::string& value) {
+        std::vector<std::string> items;
+        try {
+            // Предполагаем, что это JSON-строка с массивом
+            items = json::parse(value).get<std::vector<std::string>>();
+        } catch (...) {
+            // Если не удалось разобрать как JSON, пробуем как обычную строку с разделителями
+            std::istringstream iss(value);
+            std::string item;
+            while (std::getline(iss, item, ',')) {
+                if (!item.empty()) {
+                    items.push_back(item);
+                }
+            }
+        }
+        return items;
+    };
+
+    std::vector<std::string> target_patterns;
+    std::vector<std::string> target_words;
+    if (config->contains("target_patterns")) {
+        target_patterns = parse_list(config->at("target_patterns"));
+    }
+    if (config->contains("target_words")) {
+        target_words = parse_list(config->at("target_words"));
+    }
+
+    int fuzzy_max_distance = _config_int(*config, "fuzzy_max_distance", DEFAULT_FUZZY_MAX_DISTANCE);
+    auto compiled = CompiledDictionary::build(target_words, target_patterns, 0, fuzzy_max_distance);
+    if (compiled) {
+        detector->set_dictionary(std::move(compiled));
+    }
+}
+
+void AudioProcessor::set_dictionary(std::shared_ptr<const CompiledDictionary> dictionary) {
+    detector->set_dictionary(std::move(dictionary));
+}
+
+std::shared_ptr<const CompiledDictionary> AudioProcessor::get_dictionary() const {
+    return detector->get_dictionary();
+}
+
+void AudioProcessor::reload_dictionary(std::vector<std::string> target_words,
+                                       std::vector<std::string> target_patterns,
+                                       uint64_t version) {
+    // Вызывающий поток (интерфейс) не ждет сборку: запрос заменяет еще не начатый,
+    // а поток сборки берет его сам после текущего словаря
+    QMutexLocker locker(&dictionary_lock);
+    pending_dictionary.reset(new DictionaryRequest{std::move(target_words), std::move(target_patterns), version});
+    if (dictionary_building) {
+        return;
+    }
+
+    // Прошлый поток уже снял флаг и завершается, ожидание короткое
+    if (dictionary_builder.joinable()) {
+        dictionary_builder.join();
+    }
+    dictionary_building = true;
+    dictionary_builder = std::thread(&AudioProcessor::build_dictionaries, this);
+}
+
+void AudioProcessor::build_dictionaries() {
+    while (true) {
+        std::unique_ptr<DictionaryRequest> request;
+        {
+            QMutexLocker locker(&dictionary_lock);
+            if (!pending_dictionary) {
+                dictionary_building = false;
+                return;
+            }
+            request = std::move(pending_dictionary);
+        }
+
+        // Настройки читаются к моменту сборки: путь и порог могли измениться
+        auto config = current_config();
+        std::string dictionary_path = config->get("dictionary_path");
+        int fuzzy_max_distance = _config_int(*config, "fuzzy_max_distance", DEFAULT_FUZZY_MAX_DISTANCE);
+
+        auto build_start = std::chrono::steady_clock::now();
+
+        auto dictionary = CompiledDictionary::build(request->target_words, request->target_patterns,
+                                                    request->version, fuzzy_max_distance);
+        if (!dictionary) {
+            emit logMessage("❌ Не удалось скомпилировать словарь");
+            continue;
+        }
+
+        if (!dictionary_path.empty() && !dictionary->save(dictionary_path)) {
+            emit logMessage("⚠️ Не удалось сохранить скомпилированный словарь на диск");
+        }
+
+        detector->set_dictionary(dictionary);
+
+        auto build_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - build_start).count();
+        emit logMessage(QString("✅ Словарь обновлен: %1 слов, %2 шаблонов (%3 мс)")
+                        .arg(dictionary->word_count())
+                        .arg(dictionary->pattern_count())
+                        .arg(build_ms));
+    }
+}
+
+ConfigSnapshotPtr AudioProcessor::current_config() const {
+    return std::atomic_load(&config_snapshot);
+}
+
+void AudioProcessor::update_config(ConfigSnapshotPtr config) {
+    // Тот же снимок уже применен: сравнивать содержимое не нужно
+    auto current = current_config();
+    if (!config || (current && current->version == config->version)) {
+        return;
+    }
+    std::atomic_store(&config_snapshot, config);
+}
+
+void AudioProcessor::apply_config_snapshot(const ConfigSnapshotPtr& config) {
+    if (config->version == applied_config_version) {
+        return;
+    }
+    applied_config_version = config->version;
+
+    // Очищаем кэш бипов при изменении частоты или громкости. Размер буфера
+    // задержки здесь не меняется: он и цель наполнения заданы на весь запуск
     beep_cache.clear();
+
+    // Настройки горячего пути разбираются один раз на снимок
+    settings.censoring_enabled = config->get("enable_censoring", "true") == "true";
+    settings.debug_mode = config->get("debug_mode", "false") == "true";
+    settings.log_to_file = config->get("log_to_file", "false") == "true";
+    settings.log_file = config->get("log_file", DEFAULT_LOG_FILE);
+    settings.safety_margin = _config_int(*config, "safety_margin", DEFAULT_SAFETY_MARGIN);
+    settings.redecode_confidence = _config_double(*config, "redecode_confidence", DEFAULT_REDECODE_CONFIDENCE);
+    settings.near_miss_distance = _config_int(*config, "verify_near_miss_distance",
+                                              DEFAULT_VERIFY_NEAR_MISS_DISTANCE);
+    settings.redecode_padding_ms = _config_int(*config, "redecode_padding_ms", DEFAULT_REDECODE_PADDING_MS);
+    settings.recognizer_cycle_s = _config_int(*config, "recognizer_cycle_s", DEFAULT_RECOGNIZER_CYCLE_S);
+    settings.device_error_threshold = _config_int(*config, "device_error_threshold",
+                                                  DEFAULT_DEVICE_ERROR_THRESHOLD);
+    settings.xrun_adaptive_latency = config->get("xrun_adaptive_latency", "false") == "true";
+    settings.xrun_window_ms = _config_int(*config, "xrun_window_ms", DEFAULT_XRUN_WINDOW_MS);
+    settings.xrun_threshold = _config_int(*config, "xrun_threshold", DEFAULT_XRUN_THRESHOLD);
+    settings.xrun_max_latency_ms = _config_double(*config, "xrun_max_latency_ms", DEFAULT_XRUN_MAX_LATENCY_MS);
 }
 
 void AudioProcessor::pause() {
+    QMutexLocker locker(&pause_lock);
     paused = true;
 }
 
 void AudioProcessor::resume() {
+    QMutexLocker locker(&pause_lock);
     paused = false;
+    pause_condition.wakeAll();
 }
 
-void AudioProcessor::stop_processing() {
-    running = false;
+void AudioProcessor::wait_while_paused() {
+    // Потоки останавливаются, чтобы PortAudio не копил вход и не будил поток
+    Pa_StopStream(input_stream);
+    Pa_StopStream(output_stream);
 
-    // Ждем завершения потока
-    wait(1000); // Ждем максимум 1 секунду
+    {
+        QMutexLocker locker(&pause_lock);
+        while (paused && running) {
+            pause_condition.wait(&pause_lock);
+        }
+    }
 
-    // Освобождаем ресурсы
-    cleanup_resources();
-}
+    if (!running) {
+        return;
+    }
 
-void AudioProcessor::cleanup_resources() {
-    // Правильное освобождение ресурсов
-    try {
-        if (input_stream) {
-            Pa_StopStream(input_stream);
-            Pa_CloseStream(input_stream);
-            input_stream = nullptr;
-        }
-    } catch (const std::exception& e) {
-        emit logMessage(QString("Ошибка при закрытии потока ввода: %1").arg(e.what()));
+    // Буфер задержки и шкала захвата не менялись: воспроизведение продолжится
+    // с того же места, регионы цензуры остаются на своих сэмплах. Распознаватель
+    // за время паузы ничего не получил, поэтому его сдвиг тоже прежний
+    PaError err = Pa_StartStream(input_stream);
+    if (err == paNoError) {
+        err = Pa_StartStream(output_stream);
+    }
+    if (err != paNoError) {
+        emit logMessage(QString("❌ Ошибка возобновления аудио потоков: %1").arg(Pa_GetErrorText(err)));
+        // Устройство могло пропасть во время паузы
+        device_lost = true;
     }
 
-    try {
-        if (output_stream) {
-            Pa_StopStream(output_stream);
-            Pa_CloseStream(output_stream);
-            output_stream = nullptr;
-        }
-    } catch (const std::exception& e) {
-        emit logMessage(QString("Ошибка при закрытии потока вывода: %1").arg(e.what()));
+    // Отсчет для оценки потерь входа начинается заново
+    input_stream_start = Pa_GetStreamTime(input_stream);
+    input_samples_read = 0;
+
+    // Очереди устройств начинаются с нуля, часы остались прежними
+    if (drift_compensator) {
+        drift_compensator->restart();
     }
+}
 
-    try {
-        Pa_Terminate();
-    } catch (const std::exception& e) {
-        emit logMessage(QString("Ошибка при завершении PortAudio: %1").arg(e.what()));
+void AudioProcessor::stop_processing() {
+    {
+        // Будим поток, если он спит на паузе
+        QMutexLocker locker(&pause_lock);
+        running = false;
+        paused = false;
+        pause_condition.wakeAll();
     }
 
+    // Ждем завершения потока без ограничения по времени: в конце run() он
+    // дожидается пула повторного распознавания, который может дораспознавать
+    // окно. Потоки PortAudio он останавливает сам, но не закрывает
+    wait();
+}
+
+void AudioProcessor::cleanup_resources() {
+    // Правильное освобождение ресурсов
+    close_streams();
+
+    device_catalog.terminate();
+
     // Очищаем буферы
     {
         QMutexLocker locker(&buffer_lock);
@@ -771,8 +1914,12 @@ void AudioProcessor::cleanup_resources() {
     beep_cache.clear();
 
     // Освобождаем распознаватель и модель
+    discard_spare_recognizer();
     recognizer.reset();
     model.reset();
+    loaded_model_path.clear();
+    verify_model.reset();
+    loaded_verify_model_path.clear();
 
     emit logMessage("✅ Ресурсы аудио освобождены");
 }
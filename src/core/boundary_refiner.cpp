@@ -0,0 +1,250 @@
+#include "audiocensor/boundary_refiner.h"
+#include "audiocensor/constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace audiocensor {
+
+namespace {
+
+// Кадр анализа и шаг, мс
+constexpr int FRAME_MS = 10;
+constexpr int HOP_MS = 5;
+
+// Частоты спектра, Гц
+constexpr size_t BAND_COUNT = 16;
+constexpr double LOWEST_BAND_HZ = 150.0;
+constexpr double HIGHEST_BAND_HZ = 4000.0;
+
+// Окно тише этого уровня (средний квадрат сэмпла, дБ; около -50 dBFS) не содержит речи
+constexpr double SILENCE_LEVEL_DB = 40.0;
+
+int _config_int(const ConfigSnapshot& config, const std::string& key, int default_value) {
+    try {
+        return std::stoi(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+} // namespace
+
+BoundaryRefiner::BoundaryRefiner(const ConfigSnapshot& config, int sample_rate)
+    : enabled(config.get("boundary_refine", "true") == "true"),
+      frame_size(std::max<size_t>(4, static_cast<size_t>(sample_rate) * FRAME_MS / 1000)),
+      hop_size(std::max<size_t>(1, static_cast<size_t>(sample_rate) * HOP_MS / 1000)),
+      search_size(0),
+      guard_size(0),
+      threshold_db(_config_int(config, "boundary_threshold_db", DEFAULT_BOUNDARY_THRESHOLD_DB)),
+      band_count(BAND_COUNT) {
+
+    int search_ms = std::max(FRAME_MS, _config_int(config, "boundary_search_ms", DEFAULT_BOUNDARY_SEARCH_MS));
+    int guard_ms = std::max(0, _config_int(config, "boundary_guard_ms", DEFAULT_BOUNDARY_GUARD_MS));
+    search_size = static_cast<size_t>(sample_rate) * search_ms / 1000;
+    guard_size = static_cast<size_t>(sample_rate) * guard_ms / 1000;
+
+    // Частоты распределены логарифмически и не выходят за 0.9 от Найквиста
+    const double pi = std::acos(-1.0);
+    double highest = std::min(HIGHEST_BAND_HZ, sample_rate * 0.45);
+    cos_table.resize(band_count * frame_size);
+    sin_table.resize(band_count * frame_size);
+    for (size_t band = 0; band < band_count; band++) {
+        double frequency = LOWEST_BAND_HZ *
+            std::pow(highest / LOWEST_BAND_HZ, static_cast<double>(band) / (band_count - 1));
+        double step = 2.0 * pi * frequency / sample_rate;
+        for (size_t n = 0; n < frame_size; n++) {
+            double window = 0.5 - 0.5 * std::cos(2.0 * pi * n / (frame_size - 1));
+            cos_table[band * frame_size + n] = static_cast<float>(window * std::cos(step * n));
+            sin_table[band * frame_size + n] = static_cast<float>(window * std::sin(step * n));
+        }
+    }
+
+    // Окно - граница плюс-минус search_size
+    size_t max_frames = (2 * search_size + frame_size) / hop_size + 2;
+    energy_db.reserve(max_frames);
+    spectrum.reserve(max_frames * band_count);
+    onset_flux.reserve(max_frames);
+    offset_flux.reserve(max_frames);
+    voiced.reserve(max_frames);
+}
+
+bool BoundaryRefiner::refine_start(const short* samples, size_t count, int64_t origin, int64_t& boundary) {
+    int64_t offset = boundary - origin;
+    if (!enabled || offset < 0 || offset >= static_cast<int64_t>(count)) {
+        return false;
+    }
+
+    size_t frames = _analyze(samples, count);
+    if (frames == 0) {
+        return false;
+    }
+
+    size_t current = std::min(static_cast<size_t>(offset) / hop_size, frames - 1);
+    int64_t refined;
+
+    if (!voiced[current]) {
+        // Распознаватель поставил начало в тишину: звук начинается не раньше
+        // отчета. Вперед граница не переносится - тихий глухой согласный в
+        // начале слова может не пройти порог и остался бы незаглушенным
+        size_t i = current;
+        while (i < frames && !voiced[i]) {
+            i++;
+        }
+        if (i == frames) {
+            return false;
+        }
+        refined = boundary;
+    } else {
+        // Идем назад до тишины перед словом
+        size_t i = current;
+        while (i > 0 && voiced[i - 1]) {
+            i--;
+        }
+
+        if (i > 0) {
+            refined = origin + static_cast<int64_t>(i * hop_size);
+        } else {
+            // Тишины нет: начало - самый резкий рост спектра до отчета распознавателя
+            size_t best = current;
+            double best_flux = -1.0;
+            for (size_t j = 1; j <= current; j++) {
+                if (onset_flux[j] > best_flux) {
+                    best_flux = onset_flux[j];
+                    best = j;
+                }
+            }
+            refined = origin + static_cast<int64_t>(best * hop_size);
+        }
+    }
+
+    // Регион только расширяется относительно отчета распознавателя
+    boundary = std::min(refined, boundary) - static_cast<int64_t>(guard_size);
+    return true;
+}
+
+bool BoundaryRefiner::refine_end(const short* samples, size_t count, int64_t origin, int64_t& boundary) {
+    int64_t offset = boundary - origin;
+    if (!enabled || offset < 0 || offset >= static_cast<int64_t>(count)) {
+        return false;
+    }
+
+    size_t frames = _analyze(samples, count);
+    if (frames == 0) {
+        return false;
+    }
+
+    size_t current = std::min(static_cast<size_t>(offset) / hop_size, frames - 1);
+    int64_t refined;
+
+    if (!voiced[current]) {
+        // Распознаватель поставил конец в тишину: звук закончился раньше, граница
+        // остается на месте, чтобы не срезать тихий хвост слова
+        size_t i = current;
+        while (!voiced[i]) {
+            if (i == 0) {
+                return false;
+            }
+            i--;
+        }
+        refined = boundary;
+    } else {
+        // Идем вперед до тишины после слова
+        size_t i = current;
+        while (i + 1 < frames && voiced[i + 1]) {
+            i++;
+        }
+
+        if (i + 1 < frames) {
+            refined = origin + static_cast<int64_t>(i * hop_size + frame_size) - 1;
+        } else {
+            // Тишины нет: конец - самый резкий спад спектра после отчета распознавателя
+            size_t best = current + 1;
+            double best_flux = -1.0;
+            for (size_t j = current + 1; j < frames; j++) {
+                if (offset_flux[j] > best_flux) {
+                    best_flux = offset_flux[j];
+                    best = j;
+                }
+            }
+            refined = origin + static_cast<int64_t>((best - 1) * hop_size + frame_size) - 1;
+        }
+    }
+
+    boundary = std::max(refined, boundary) + static_cast<int64_t>(guard_size);
+    return true;
+}
+
+size_t BoundaryRefiner::_analyze(const short* samples, size_t count) {
+    if (count < frame_size) {
+        return 0;
+    }
+    size_t frames = (count - frame_size) / hop_size + 1;
+    if (frames < 3) {
+        return 0;
+    }
+
+    energy_db.resize(frames);
+    spectrum.resize(frames * band_count);
+    onset_flux.resize(frames);
+    offset_flux.resize(frames);
+    voiced.resize(frames);
+
+    double lowest = 1e9;
+    double highest = -1e9;
+    for (size_t i = 0; i < frames; i++) {
+        const short* frame = samples + i * hop_size;
+
+        double power = 0.0;
+        for (size_t n = 0; n < frame_size; n++) {
+            double sample = frame[n];
+            power += sample * sample;
+        }
+        energy_db[i] = 10.0 * std::log10(power / frame_size + 1.0);
+        lowest = std::min(lowest, energy_db[i]);
+        highest = std::max(highest, energy_db[i]);
+
+        // Логарифм амплитуды на каждой частоте
+        for (size_t band = 0; band < band_count; band++) {
+            const float* cos_row = cos_table.data() + band * frame_size;
+            const float* sin_row = sin_table.data() + band * frame_size;
+            float re = 0.0f;
+            float im = 0.0f;
+            for (size_t n = 0; n < frame_size; n++) {
+                re += frame[n] * cos_row[n];
+                im += frame[n] * sin_row[n];
+            }
+            spectrum[i * band_count + band] = 0.5f * std::log(re * re + im * im + 1.0f);
+        }
+
+        // Поток: рост спектра - для начала звука, спад - для конца
+        onset_flux[i] = 0.0;
+        offset_flux[i] = 0.0;
+        if (i > 0) {
+            for (size_t band = 0; band < band_count; band++) {
+                float delta = spectrum[i * band_count + band] - spectrum[(i - 1) * band_count + band];
+                if (delta > 0) {
+                    onset_flux[i] += delta;
+                } else {
+                    offset_flux[i] -= delta;
+                }
+            }
+        }
+    }
+
+    // Тихое окно не содержит звука; окно без перепада уровня - сплошной звук
+    for (size_t i = 0; i < frames; i++) {
+        if (highest < SILENCE_LEVEL_DB) {
+            voiced[i] = 0;
+        } else if (highest - lowest < threshold_db) {
+            voiced[i] = 1;
+        } else {
+            voiced[i] = energy_db[i] >= lowest + threshold_db ? 1 : 0;
+        }
+    }
+
+    return frames;
+}
+
+} // namespace audiocensor
@@ -0,0 +1,363 @@
+#include "audiocensor/compiled_dictionary.h"
+#include "audiocensor/detection_cache.h"
+#include "audiocensor/security.h"
+#include "audiocensor/text_normalizer.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <type_traits>
+
+namespace audiocensor {
+
+namespace {
+
+constexpr char IMAGE_MAGIC[8] = {'A', 'C', 'D', 'I', 'C', 'T', '\0', '\0'};
+constexpr uint32_t IMAGE_FORMAT_VERSION = 2;
+constexpr uint32_t IMAGE_BYTE_ORDER = 0x01020304u;
+constexpr size_t IMAGE_ALIGNMENT = 8;
+
+enum SectionId : uint32_t {
+    SECTION_WORD_OFFSETS = 0,
+    SECTION_WORD_BYTES,
+    SECTION_PATTERN_OFFSETS,
+    SECTION_PATTERN_BYTES,
+    SECTION_FUZZY_SYMBOLS,
+    SECTION_FUZZY_ENTRIES,
+    SECTION_FUZZY_LENGTH_OFFSETS,
+    SECTION_MORPH_NODES,
+    SECTION_COUNT
+};
+
+struct SectionInfo {
+    uint64_t offset;    // Смещение от начала образа
+    uint64_t size;      // Размер в байтах
+};
+
+struct ImageHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t byte_order;
+    uint64_t image_size;
+    uint64_t version;
+    uint64_t fingerprint;
+    uint32_t fuzzy_max_threshold;
+    uint32_t morph_stem_count;
+    SectionInfo sections[SECTION_COUNT];
+};
+
+static_assert(std::is_trivially_copyable<ImageHeader>::value, "ImageHeader must be POD");
+static_assert(std::is_trivially_copyable<FuzzyMatcher::Entry>::value, "FuzzyMatcher::Entry must be POD");
+static_assert(std::is_trivially_copyable<MorphIndex::Node>::value, "MorphIndex::Node must be POD");
+static_assert(sizeof(ImageHeader) % IMAGE_ALIGNMENT == 0, "ImageHeader must keep sections aligned");
+
+// Собирает образ: секции дописываются подряд с выравниванием
+class ImageWriter {
+public:
+    ImageWriter() : bytes(sizeof(ImageHeader), '\0') {}
+
+    void add(SectionId id, const void* source, size_t length) {
+        bytes.resize((bytes.size() + IMAGE_ALIGNMENT - 1) / IMAGE_ALIGNMENT * IMAGE_ALIGNMENT, '\0');
+        sections[id].offset = bytes.size();
+        sections[id].size = length;
+        if (length > 0) {
+            bytes.append(static_cast<const char*>(source), length);
+        }
+    }
+
+    std::string finish(ImageHeader header) {
+        bytes.resize((bytes.size() + IMAGE_ALIGNMENT - 1) / IMAGE_ALIGNMENT * IMAGE_ALIGNMENT, '\0');
+        std::memcpy(header.sections, sections, sizeof(sections));
+        header.image_size = bytes.size();
+        std::memcpy(&bytes[0], &header, sizeof(header));
+        return std::move(bytes);
+    }
+
+private:
+    std::string bytes;
+    SectionInfo sections[SECTION_COUNT] = {};
+};
+
+// Таблица смещений строк: count + 1 значений, строка i занимает [offsets[i], offsets[i + 1])
+void pack_strings(const std::vector<std::string>& values,
+                  std::vector<uint32_t>& offsets, std::string& packed) {
+    offsets.clear();
+    packed.clear();
+    offsets.reserve(values.size() + 1);
+    for (const auto& value : values) {
+        offsets.push_back(static_cast<uint32_t>(packed.size()));
+        packed += value;
+    }
+    offsets.push_back(static_cast<uint32_t>(packed.size()));
+}
+
+} // namespace
+
+CompiledDictionary::CompiledDictionary()
+    : data(nullptr), size(0),
+      word_offsets(nullptr), word_bytes(nullptr), word_total(0), word_bytes_size(0),
+      pattern_offsets(nullptr), pattern_bytes(nullptr), pattern_total(0), pattern_bytes_size(0) {
+}
+
+uint64_t CompiledDictionary::fingerprint(const std::vector<std::string>& target_words,
+                                         const std::vector<std::string>& patterns) {
+    // Отпечаток содержимого: разделители не дают спискам "склеиться"
+    static const std::string separator(1, '\0');
+    uint64_t hash = DetectionCache::hash_string("patterns");
+    for (const auto& pattern : patterns) {
+        hash = DetectionCache::hash_string(pattern, hash);
+        hash = DetectionCache::hash_string(separator, hash);
+    }
+    hash = DetectionCache::hash_string("words", hash);
+    for (const auto& word : target_words) {
+        hash = DetectionCache::hash_string(word, hash);
+        hash = DetectionCache::hash_string(separator, hash);
+    }
+    return hash;
+}
+
+std::shared_ptr<CompiledDictionary> CompiledDictionary::build(
+    const std::vector<std::string>& target_words,
+    const std::vector<std::string>& patterns,
+    uint64_t version,
+    int fuzzy_max_distance) {
+
+    try {
+        // Нормализуем слова и отделяем пороги нечеткого сравнения
+        std::vector<std::string> normalized_words;
+        std::vector<int> thresholds;
+        normalized_words.reserve(target_words.size());
+        thresholds.reserve(target_words.size());
+        for (const auto& target : target_words) {
+            std::string word;
+            thresholds.push_back(FuzzyMatcher::parse_threshold(target, word));
+
+            std::string normalized;
+            text::normalize_word(word, normalized);
+            normalized_words.push_back(std::move(normalized));
+        }
+
+        FuzzyMatcher fuzzy;
+        fuzzy.build(normalized_words, thresholds, fuzzy_max_distance);
+        MorphIndex morph;
+        morph.build(normalized_words);
+
+        std::vector<uint32_t> word_offsets;
+        std::string word_bytes;
+        pack_strings(normalized_words, word_offsets, word_bytes);
+        std::vector<uint32_t> pattern_offsets;
+        std::string pattern_bytes;
+        pack_strings(patterns, pattern_offsets, pattern_bytes);
+
+        ImageWriter writer;
+        writer.add(SECTION_WORD_OFFSETS, word_offsets.data(), word_offsets.size() * sizeof(uint32_t));
+        writer.add(SECTION_WORD_BYTES, word_bytes.data(), word_bytes.size());
+        writer.add(SECTION_PATTERN_OFFSETS, pattern_offsets.data(), pattern_offsets.size() * sizeof(uint32_t));
+        writer.add(SECTION_PATTERN_BYTES, pattern_bytes.data(), pattern_bytes.size());
+        writer.add(SECTION_FUZZY_SYMBOLS, fuzzy.symbols_data(), fuzzy.symbols_size());
+        writer.add(SECTION_FUZZY_ENTRIES, fuzzy.entries_data(), fuzzy.size() * sizeof(FuzzyMatcher::Entry));
+        writer.add(SECTION_FUZZY_LENGTH_OFFSETS, fuzzy.length_offsets_data(),
+                   fuzzy.length_offsets_data() ? (FuzzyMatcher::MAX_WORD_LENGTH + 2) * sizeof(uint32_t) : 0);
+        writer.add(SECTION_MORPH_NODES, morph.get_nodes(), morph.get_node_count() * sizeof(MorphIndex::Node));
+
+        ImageHeader header{};
+        std::memcpy(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+        header.format_version = IMAGE_FORMAT_VERSION;
+        header.byte_order = IMAGE_BYTE_ORDER;
+        header.version = version;
+        header.fingerprint = fingerprint(target_words, patterns);
+        header.fuzzy_max_threshold = static_cast<uint32_t>(fuzzy.get_max_threshold());
+        header.morph_stem_count = static_cast<uint32_t>(morph.size());
+        std::string image = writer.finish(header);
+
+        // Буфер из uint64_t гарантирует выравнивание секций в памяти
+        std::shared_ptr<CompiledDictionary> dictionary(new CompiledDictionary());
+        dictionary->buffer.resize(image.size() / sizeof(uint64_t));
+        std::memcpy(dictionary->buffer.data(), image.data(), image.size());
+        dictionary->data = reinterpret_cast<const unsigned char*>(dictionary->buffer.data());
+        dictionary->size = image.size();
+
+        if (!dictionary->_attach()) {
+            return nullptr;
+        }
+        return dictionary;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка при компиляции словаря: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+std::shared_ptr<CompiledDictionary> CompiledDictionary::open(const std::string& path) {
+    try {
+        std::ifstream file(std::filesystem::u8path(path), std::ios::binary | std::ios::ate);
+        if (!file) {
+            return nullptr;
+        }
+        std::streamoff file_size = file.tellg();
+        if (file_size < static_cast<std::streamoff>(sizeof(ImageHeader)) ||
+            file_size % static_cast<std::streamoff>(IMAGE_ALIGNMENT) != 0) {
+            std::cerr << "Файл словаря поврежден или имеет другой формат: " << path << std::endl;
+            return nullptr;
+        }
+
+        // Файл читается прямо в выровненный буфер и восстанавливается на месте
+        std::shared_ptr<CompiledDictionary> dictionary(new CompiledDictionary());
+        dictionary->size = static_cast<size_t>(file_size);
+        dictionary->buffer.resize(dictionary->size / sizeof(uint64_t));
+        char* bytes = reinterpret_cast<char*>(dictionary->buffer.data());
+        file.seekg(0);
+        if (!file.read(bytes, static_cast<std::streamsize>(dictionary->size))) {
+            std::cerr << "Ошибка при чтении файла словаря: " << path << std::endl;
+            return nullptr;
+        }
+        security::obscure_bytes(bytes, dictionary->size);
+
+        dictionary->data = reinterpret_cast<const unsigned char*>(bytes);
+        if (!dictionary->_attach()) {
+            std::cerr << "Файл словаря поврежден или имеет другой формат: " << path << std::endl;
+            return nullptr;
+        }
+        return dictionary;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка при чтении словаря: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+bool CompiledDictionary::_attach() {
+    // Проверяем только заголовок и границы секций: время не зависит от размера словаря
+    if (!data || size < sizeof(ImageHeader)) {
+        return false;
+    }
+
+    ImageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 ||
+        header.format_version != IMAGE_FORMAT_VERSION ||
+        header.byte_order != IMAGE_BYTE_ORDER ||
+        header.image_size != size) {
+        return false;
+    }
+
+    for (const auto& section : header.sections) {
+        if (section.offset % IMAGE_ALIGNMENT != 0 ||
+            section.offset < sizeof(ImageHeader) ||
+            section.offset > size || section.size > size - section.offset) {
+            return false;
+        }
+    }
+
+    auto section_data = [&](SectionId id) {
+        return data + header.sections[id].offset;
+    };
+    auto section_size = [&](SectionId id) {
+        return static_cast<size_t>(header.sections[id].size);
+    };
+
+    size_t word_offsets_size = section_size(SECTION_WORD_OFFSETS);
+    size_t pattern_offsets_size = section_size(SECTION_PATTERN_OFFSETS);
+    size_t fuzzy_entries_size = section_size(SECTION_FUZZY_ENTRIES);
+    size_t length_offsets_size = section_size(SECTION_FUZZY_LENGTH_OFFSETS);
+    size_t morph_nodes_size = section_size(SECTION_MORPH_NODES);
+
+    if (word_offsets_size < sizeof(uint32_t) || word_offsets_size % sizeof(uint32_t) != 0 ||
+        pattern_offsets_size < sizeof(uint32_t) || pattern_offsets_size % sizeof(uint32_t) != 0 ||
+        fuzzy_entries_size % sizeof(FuzzyMatcher::Entry) != 0 ||
+        (length_offsets_size != 0 && length_offsets_size != (FuzzyMatcher::MAX_WORD_LENGTH + 2) * sizeof(uint32_t)) ||
+        morph_nodes_size % sizeof(MorphIndex::Node) != 0) {
+        return false;
+    }
+
+    word_offsets = reinterpret_cast<const uint32_t*>(section_data(SECTION_WORD_OFFSETS));
+    word_total = word_offsets_size / sizeof(uint32_t) - 1;
+    word_bytes = reinterpret_cast<const char*>(section_data(SECTION_WORD_BYTES));
+    word_bytes_size = section_size(SECTION_WORD_BYTES);
+
+    pattern_offsets = reinterpret_cast<const uint32_t*>(section_data(SECTION_PATTERN_OFFSETS));
+    pattern_total = pattern_offsets_size / sizeof(uint32_t) - 1;
+    pattern_bytes = reinterpret_cast<const char*>(section_data(SECTION_PATTERN_BYTES));
+    pattern_bytes_size = section_size(SECTION_PATTERN_BYTES);
+
+    fuzzy_matcher.attach(section_data(SECTION_FUZZY_SYMBOLS), section_size(SECTION_FUZZY_SYMBOLS),
+                         reinterpret_cast<const FuzzyMatcher::Entry*>(section_data(SECTION_FUZZY_ENTRIES)),
+                         fuzzy_entries_size / sizeof(FuzzyMatcher::Entry),
+                         length_offsets_size ? reinterpret_cast<const uint32_t*>(section_data(SECTION_FUZZY_LENGTH_OFFSETS))
+                                             : nullptr,
+                         header.fuzzy_max_threshold < FuzzyMatcher::MAX_WORD_LENGTH
+                             ? static_cast<int>(header.fuzzy_max_threshold)
+                             : static_cast<int>(FuzzyMatcher::MAX_WORD_LENGTH));
+
+    return morph_index.attach(reinterpret_cast<const MorphIndex::Node*>(section_data(SECTION_MORPH_NODES)),
+                              morph_nodes_size / sizeof(MorphIndex::Node),
+                              header.morph_stem_count);
+}
+
+bool CompiledDictionary::save(const std::string& path) const {
+    try {
+        std::filesystem::path target = std::filesystem::u8path(path);
+        if (target.has_parent_path()) {
+            std::filesystem::create_directories(target.parent_path());
+        }
+
+        // Пишем во временный файл и переименовываем, чтобы не оставить полузаписанный словарь
+        std::filesystem::path temporary = target;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cerr << "Не удалось создать файл словаря: " << path << std::endl;
+                return false;
+            }
+            // Слова и паттерны не должны попадать на диск в открытом виде
+            std::string obscured(reinterpret_cast<const char*>(data), size);
+            security::obscure_bytes(&obscured[0], obscured.size());
+            file.write(obscured.data(), static_cast<std::streamsize>(obscured.size()));
+            if (!file) {
+                std::cerr << "Ошибка при записи файла словаря: " << path << std::endl;
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary, target);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка при сохранении словаря: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+uint64_t CompiledDictionary::get_version() const {
+    ImageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    return header.version;
+}
+
+uint64_t CompiledDictionary::get_fingerprint() const {
+    ImageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    return header.fingerprint;
+}
+
+std::string_view CompiledDictionary::_string_at(const uint32_t* offsets, size_t count,
+                                                const char* bytes, size_t bytes_size, size_t index) {
+    if (index >= count) {
+        return std::string_view();
+    }
+    size_t begin = offsets[index];
+    size_t end = offsets[index + 1];
+    if (begin > end || end > bytes_size) {
+        return std::string_view();
+    }
+    return std::string_view(bytes + begin, end - begin);
+}
+
+std::string_view CompiledDictionary::word(size_t index) const {
+    return _string_at(word_offsets, word_total, word_bytes, word_bytes_size, index);
+}
+
+std::string_view CompiledDictionary::pattern(size_t index) const {
+    return _string_at(pattern_offsets, pattern_total, pattern_bytes, pattern_bytes_size, index);
+}
+
+} // namespace audiocensor
@@ -3,6 +3,9 @@
 #include "audiocensor/security.h"
 
 #include <QSettings>
+#include <QStandardPaths>
+#include <QDir>
+#include <QTimer>
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <sstream>
@@ -11,13 +14,27 @@ namespace audiocensor {
 
 using json = nlohmann::json;
 
-ConfigManager::ConfigManager() {
+ConfigManager::ConfigManager()
+    : _next_subscription_id(1) {
     settings = new QSettings("AudioCensor", "Config");
-    _config = _load_default_config();
-    _load_saved_config();
+
+    auto initial = std::make_shared<ConfigSnapshot>();
+    initial->version = 1;
+    initial->values = _load_default_config();
+    _load_saved_config(initial->values);
+    _parse_lists(*initial);
+    _snapshot = std::move(initial);
+
+    // Серия обновлений сохраняется одной записью после паузы
+    _save_timer = new QTimer();
+    _save_timer->setSingleShot(true);
+    _save_timer->setInterval(DEFAULT_CONFIG_SAVE_DELAY_MS);
+    QObject::connect(_save_timer, &QTimer::timeout, [this]() { _save_config(); });
 }
 
 ConfigManager::~ConfigManager() {
+    flush();
+    delete _save_timer;
     delete settings;
 }
 
@@ -33,98 +50,286 @@ std::unordered_map<std::string, std::string> ConfigManager::_load_default_config
     config["log_to_file"] = "false";
     config["log_file"] = DEFAULT_LOG_FILE;
     config["debug_mode"] = "false";
+    config["log_buffer_size"] = std::to_string(DEFAULT_LOG_BUFFER_SIZE);
+    config["log_view_max_lines"] = std::to_string(DEFAULT_LOG_VIEW_MAX_LINES);
+    config["log_flush_fps"] = std::to_string(DEFAULT_LOG_FLUSH_FPS);
     config["safety_margin"] = std::to_string(DEFAULT_SAFETY_MARGIN);
+    config["detection_cache_size"] = std::to_string(DEFAULT_DETECTION_CACHE_SIZE);
+    config["morphology"] = "false";
+    config["fuzzy_matching"] = "false";
+    config["fuzzy_max_distance"] = std::to_string(DEFAULT_FUZZY_MAX_DISTANCE);
     
-    // Преобразуем дефолтные списки слов и паттернов в JSON строки
-    _target_words = DEFAULT_TARGET_WORDS;
-    _target_patterns = DEFAULT_TARGET_PATTERNS;
+    // Адаптивная задержка устройств при частых сбоях аудио потоков
+    config["xrun_adaptive_latency"] = "false";
+    config["xrun_threshold"] = std::to_string(DEFAULT_XRUN_THRESHOLD);
+    config["xrun_window_ms"] = std::to_string(DEFAULT_XRUN_WINDOW_MS);
+    config["xrun_max_latency_ms"] = std::to_string(DEFAULT_XRUN_MAX_LATENCY_MS);
+    
+    // Отключение и возвращение устройств; device_refresh_interval_ms = 0 отключает проверку списка,
+    // device_rescan_interval_ms = 0 - пересканирование без подписи звуковых карт (Windows, macOS)
+    config["device_error_threshold"] = std::to_string(DEFAULT_DEVICE_ERROR_THRESHOLD);
+    config["device_reconnect_interval_ms"] = std::to_string(DEFAULT_DEVICE_RECONNECT_INTERVAL_MS);
+    config["device_refresh_interval_ms"] = std::to_string(DEFAULT_DEVICE_REFRESH_INTERVAL_MS);
+    config["device_rescan_interval_ms"] = std::to_string(DEFAULT_DEVICE_RESCAN_INTERVAL_MS);
+    
+    // Компенсация расхождения часов входного и выходного устройств
+    config["drift_compensation"] = "true";
+    config["drift_kp"] = std::to_string(DEFAULT_DRIFT_KP);
+    config["drift_ki"] = std::to_string(DEFAULT_DRIFT_KI);
+    config["drift_max_ppm"] = std::to_string(DEFAULT_DRIFT_MAX_PPM);
+    config["drift_settle_ms"] = std::to_string(DEFAULT_DRIFT_SETTLE_MS);
+    
+    // Возврат задержки к buffer_delay за счет пауз после сбоев и переподключений
+    config["catchup_enabled"] = "true";
+    config["catchup_silence_db"] = std::to_string(DEFAULT_CATCHUP_SILENCE_DB);
+    config["catchup_min_excess_ms"] = std::to_string(DEFAULT_CATCHUP_MIN_EXCESS_MS);
+    config["catchup_max_drop_percent"] = std::to_string(DEFAULT_CATCHUP_MAX_DROP_PERCENT);
+    
+    // Уточнение границ запрещенных слов по энергии и спектру; safety_margin - запас без уточнения
+    config["boundary_refine"] = "true";
+    config["boundary_search_ms"] = std::to_string(DEFAULT_BOUNDARY_SEARCH_MS);
+    config["boundary_threshold_db"] = std::to_string(DEFAULT_BOUNDARY_THRESHOLD_DB);
+    config["boundary_guard_ms"] = std::to_string(DEFAULT_BOUNDARY_GUARD_MS);
+    
+    // Повторное распознавание слов с уверенностью ниже redecode_confidence или "[unk]"
+    config["redecode_enabled"] = "true";
+    config["redecode_confidence"] = std::to_string(DEFAULT_REDECODE_CONFIDENCE);
+    config["redecode_padding_ms"] = std::to_string(DEFAULT_REDECODE_PADDING_MS);
+    config["redecode_lookback_ms"] = std::to_string(DEFAULT_REDECODE_LOOKBACK_MS);
+    config["redecode_max_window_ms"] = std::to_string(DEFAULT_REDECODE_MAX_WINDOW_MS);
+    config["redecode_queue_size"] = std::to_string(DEFAULT_REDECODE_QUEUE_SIZE);
+    
+    // Двухуровневая проверка: окна распознает модель verify_model_path (пусто - основная модель)
+    config["verify_model_path"] = "";
+    config["verify_workers"] = std::to_string(DEFAULT_VERIFY_WORKERS);
+    config["verify_near_miss_distance"] = std::to_string(DEFAULT_VERIFY_NEAR_MISS_DISTANCE);
     
-    config["target_words"] = json(_target_words).dump();
-    config["target_patterns"] = json(_target_patterns).dump();
+    // Распознаватель заменяется заранее созданным на паузе речи; 0 - один распознаватель на всю сессию
+    config["recognizer_cycle_s"] = std::to_string(DEFAULT_RECOGNIZER_CYCLE_S);
+    
+    // Эндпоинтер: endpointer_mode - default, short, long или very_long (если Vosk поддерживает);
+    // своя проверка тишины закрывает фразу принудительно, подстройка сокращает паузу конца фразы
+    config["endpointer_mode"] = "default";
+    config["endpointer_start_max_s"] = std::to_string(DEFAULT_ENDPOINTER_START_MAX_S);
+    config["endpointer_end_ms"] = std::to_string(DEFAULT_ENDPOINTER_END_MS);
+    config["endpointer_max_s"] = std::to_string(DEFAULT_ENDPOINTER_MAX_S);
+    config["endpointer_min_end_ms"] = std::to_string(DEFAULT_ENDPOINTER_MIN_END_MS);
+    config["endpointer_speech_db"] = std::to_string(DEFAULT_ENDPOINTER_SPEECH_DB);
+    config["endpointer_budget_percent"] = std::to_string(DEFAULT_ENDPOINTER_BUDGET_PERCENT);
+    config["endpointer_force_final"] = "true";
+    config["endpointer_auto_tune"] = "true";
+    
+    // Профиль реального времени (Linux): fifo или rr, список ядер вида "2,3" или "2-3"
+    config["realtime_enabled"] = "false";
+    config["realtime_policy"] = "fifo";
+    config["realtime_priority"] = std::to_string(DEFAULT_REALTIME_PRIORITY);
+    config["realtime_cpus"] = "";
+    config["realtime_lock_memory"] = "true";
+    
+    // Скомпилированный словарь хранится в каталоге данных приложения
+    QString data_dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    config["dictionary_path"] = data_dir.isEmpty()
+        ? DEFAULT_DICTIONARY_FILE
+        : QDir(data_dir).filePath(QString::fromStdString(DEFAULT_DICTIONARY_FILE)).toStdString();
+    config["word_list_cache_path"] = data_dir.isEmpty()
+        ? DEFAULT_WORD_LIST_CACHE_FILE
+        : QDir(data_dir).filePath(QString::fromStdString(DEFAULT_WORD_LIST_CACHE_FILE)).toStdString();
+    
+    // Синхронизация списков слов (пустой адрес - адрес из лицензии)
+    config["words_api_url"] = "";
+    config["sync_timeout_ms"] = std::to_string(DEFAULT_SYNC_TIMEOUT_MS);
+    config["sync_connect_timeout_ms"] = std::to_string(DEFAULT_SYNC_CONNECT_TIMEOUT_MS);
+    config["sync_retries"] = std::to_string(DEFAULT_SYNC_RETRIES);
+    config["sync_retry_delay_ms"] = std::to_string(DEFAULT_SYNC_RETRY_DELAY_MS);
+    
+    // Проверка лицензии (пустой адрес - встроенный адрес сервера)
+    config["license_api_url"] = "";
+    config["license_offline_grace_days"] = std::to_string(DEFAULT_LICENSE_OFFLINE_GRACE_DAYS);
+    config["license_reverify_hours"] = std::to_string(DEFAULT_LICENSE_REVERIFY_HOURS);
+    config["license_timeout_ms"] = std::to_string(DEFAULT_LICENSE_TIMEOUT_MS);
+    config["license_connect_timeout_ms"] = std::to_string(DEFAULT_LICENSE_CONNECT_TIMEOUT_MS);
+    
+    // Преобразуем дефолтные списки слов и паттернов в JSON строки
+    config["target_words"] = json(DEFAULT_TARGET_WORDS).dump();
+    config["target_patterns"] = json(DEFAULT_TARGET_PATTERNS).dump();
     
     return config;
 }
 
-void ConfigManager::_load_saved_config() {
+void ConfigManager::_load_saved_config(std::unordered_map<std::string, std::string>& config) {
     // Загружаем сохраненные настройки
-    for (const auto& [key, value] : _config) {
+    for (const auto& [key, value] : config) {
         // Специальная обработка для списков
         if (key == "target_words" || key == "target_patterns") {
             QString saved_value = settings->value(QString::fromStdString(key), "").toString();
             if (!saved_value.isEmpty()) {
-                try {
+                // Списки разбираются только по запросу: детектор использует скомпилированный словарь
+                if (saved_value.startsWith("ENC:")) {
                     // Если значение было зашифровано
-                    if (saved_value.startsWith("ENC:")) {
-                        std::string encrypted = saved_value.mid(4).toStdString();
-                        std::string decrypted = security::deobscure_str(encrypted);
-                        _config[key] = decrypted;
-                        
-                        // Парсим JSON-строку в вектор
-                        if (key == "target_words") {
-                            _target_words = json::parse(decrypted).get<std::vector<std::string>>();
-                        } else { // target_patterns
-                            _target_patterns = json::parse(decrypted).get<std::vector<std::string>>();
-                        }
-                    } else {
-                        // Для обратной совместимости со старыми версиями
-                        std::string value_str = saved_value.toStdString();
-                        _config[key] = value_str;
-                        
-                        // Парсим JSON-строку в вектор
-                        if (key == "target_words") {
-                            _target_words = json::parse(value_str).get<std::vector<std::string>>();
-                        } else { // target_patterns
-                            _target_patterns = json::parse(value_str).get<std::vector<std::string>>();
-                        }
-                    }
-                } catch (const std::exception& e) {
-                    std::cerr << "Ошибка при разборе JSON для " << key << ": " << e.what() << std::endl;
-                    // Если не удалось декодировать, используем значение по умолчанию
+                    std::string encrypted = saved_value.mid(4).toStdString();
+                    config[key] = security::deobscure_str(encrypted);
+                } else {
+                    // Для обратной совместимости со старыми версиями
+                    config[key] = saved_value.toStdString();
                 }
             }
-        } else {
+        } else if (settings->contains(QString::fromStdString(key))) {
+            // Ключи, которых еще нет в сохраненных настройках, сохраняют значение по умолчанию
             QVariant saved_value = settings->value(QString::fromStdString(key), "");
             if (!saved_value.isNull()) {
-                _config[key] = saved_value.toString().toStdString();
+                config[key] = saved_value.toString().toStdString();
             }
         }
     }
 }
 
 std::unordered_map<std::string, std::string> ConfigManager::get_config() const {
-    return _config;
+    return get_snapshot()->values;
+}
+
+ConfigSnapshotPtr ConfigManager::get_snapshot() const {
+    return std::atomic_load(&_snapshot);
+}
+
+uint64_t ConfigManager::get_version() const {
+    return get_snapshot()->version;
+}
+
+std::shared_ptr<const std::vector<std::string>> ConfigManager::get_target_words() const {
+    return get_snapshot()->target_words;
+}
+
+std::shared_ptr<const std::vector<std::string>> ConfigManager::get_target_patterns() const {
+    return get_snapshot()->target_patterns;
+}
+
+void ConfigManager::_parse_lists(ConfigSnapshot& snapshot) {
+    // Снимок после публикации не меняется, поэтому списки разбираются до нее
+    if (!snapshot.target_words) {
+        snapshot.target_words = std::make_shared<const std::vector<std::string>>(
+            _parse_list(snapshot.values, "target_words"));
+    }
+    if (!snapshot.target_patterns) {
+        snapshot.target_patterns = std::make_shared<const std::vector<std::string>>(
+            _parse_list(snapshot.values, "target_patterns"));
+    }
+}
+
+std::vector<std::string> ConfigManager::_parse_list(const std::unordered_map<std::string, std::string>& values,
+                                                    const std::string& key) {
+    auto it = values.find(key);
+    if (it == values.end() || it->second.empty()) {
+        return {};
+    }
+
+    try {
+        return json::parse(it->second).get<std::vector<std::string>>();
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка при разборе JSON для " << key << ": " << e.what() << std::endl;
+        return {};
+    }
 }
 
-std::vector<std::string> ConfigManager::get_target_words() const {
-    return _target_words;
+int ConfigManager::subscribe(ChangeCallback callback) {
+    int subscription_id = _next_subscription_id++;
+    _subscribers[subscription_id] = std::move(callback);
+    return subscription_id;
 }
 
-std::vector<std::string> ConfigManager::get_target_patterns() const {
-    return _target_patterns;
+void ConfigManager::unsubscribe(int subscription_id) {
+    _subscribers.erase(subscription_id);
 }
 
 void ConfigManager::update_config(const std::unordered_map<std::string, std::string>& config) {
+    std::shared_ptr<ConfigSnapshot> next;
     for (const auto& [key, value] : config) {
-        _config[key] = value;
+        _set_value(next, key, value);
+    }
+    if (next) {
+        _publish(std::move(next));
     }
-    _save_config();
 }
 
 void ConfigManager::update_target_words(const std::vector<std::string>& words) {
-    _target_words = words;
-    _config["target_words"] = json(words).dump();
-    _save_config();
+    std::shared_ptr<ConfigSnapshot> next;
+    _set_value(next, "target_words", json(words).dump());
+    if (next) {
+        _publish(std::move(next));
+    }
 }
 
 void ConfigManager::update_target_patterns(const std::vector<std::string>& patterns) {
-    _target_patterns = patterns;
-    _config["target_patterns"] = json(patterns).dump();
+    std::shared_ptr<ConfigSnapshot> next;
+    _set_value(next, "target_patterns", json(patterns).dump());
+    if (next) {
+        _publish(std::move(next));
+    }
+}
+
+void ConfigManager::_set_value(std::shared_ptr<ConfigSnapshot>& next, const std::string& key,
+                               const std::string& value) {
+    const ConfigSnapshot& current = next ? *next : *_snapshot;
+    auto it = current.values.find(key);
+    if (it != current.values.end() && it->second == value) {
+        return;
+    }
+
+    // Копия делается один раз на пачку изменений
+    if (!next) {
+        next = std::make_shared<ConfigSnapshot>(*_snapshot);
+    }
+    next->values[key] = value;
+    _dirty_keys.insert(key);
+
+    if (key == "target_words") {
+        next->target_words.reset();
+    } else if (key == "target_patterns") {
+        next->target_patterns.reset();
+    }
+}
+
+void ConfigManager::_publish(std::shared_ptr<ConfigSnapshot> next) {
+    next->version = _snapshot->version + 1;
+    _parse_lists(*next);
+    ConfigSnapshotPtr published = std::move(next);
+    std::atomic_store(&_snapshot, published);
+
+    _schedule_save();
+
+    // Копия списка позволяет подписчику отписаться из обработчика
+    auto subscribers = _subscribers;
+    for (const auto& [subscription_id, callback] : subscribers) {
+        if (callback) {
+            callback(published);
+        }
+    }
+}
+
+void ConfigManager::_schedule_save() {
+    // Каждое изменение откладывает запись, пока обновления не прекратятся
+    _save_timer->start();
+}
+
+void ConfigManager::flush() {
+    _save_timer->stop();
     _save_config();
 }
 
 void ConfigManager::_save_config() {
-    for (const auto& [key, value] : _config) {
+    if (_dirty_keys.empty()) {
+        return;
+    }
+
+    auto snapshot = get_snapshot();
+    for (const auto& key : _dirty_keys) {
+        auto it = snapshot->values.find(key);
+        if (it == snapshot->values.end()) {
+            settings->remove(QString::fromStdString(key));
+            continue;
+        }
+
         // Шифруем списки перед сохранением
+        const std::string& value = it->second;
         if (key == "target_words" || key == "target_patterns") {
             std::string encrypted = "ENC:" + security::obscure_str(value);
             settings->setValue(QString::fromStdString(key), QString::fromStdString(encrypted));
@@ -132,15 +337,23 @@ void ConfigManager::_save_config() {
             settings->setValue(QString::fromStdString(key), QString::fromStdString(value));
         }
     }
+
+    // Все накопленные изменения попадают на диск одной записью
     settings->sync();
+    if (settings->status() != QSettings::NoError) {
+        std::cerr << "Ошибка при сохранении настроек" << std::endl;
+        return;
+    }
+    _dirty_keys.clear();
 }
 
 void ConfigManager::reset_config() {
-    _config = _load_default_config();
-    _target_words = DEFAULT_TARGET_WORDS;
-    _target_patterns = DEFAULT_TARGET_PATTERNS;
-    _save_config();
+    auto next = std::make_shared<ConfigSnapshot>();
+    next->values = _load_default_config();
+    for (const auto& [key, value] : next->values) {
+        _dirty_keys.insert(key);
+    }
+    _publish(std::move(next));
 }
 
 } // namespace audiocensor
-
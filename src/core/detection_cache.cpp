@@ -0,0 +1,128 @@
+#include "audiocensor/detection_cache.h"
+
+#include <algorithm>
+
+namespace audiocensor {
+
+DetectionCache::DetectionCache(size_t capacity)
+    : entries(std::max<size_t>(capacity, 1)),
+      head(NIL), tail(NIL), used(0),
+      hit_count(0), miss_count(0) {
+    index.reserve(entries.size());
+}
+
+uint64_t DetectionCache::hash_string(const std::string& data, uint64_t seed) {
+    uint64_t hash = seed;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t DetectionCache::make_key(const std::string& normalized_word, uint64_t dictionary_generation) {
+    // Перемешиваем хеш слова с поколением словаря (финализатор splitmix64)
+    uint64_t key = hash_string(normalized_word) ^ (dictionary_generation * 0x9e3779b97f4a7c15ULL);
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+void DetectionCache::_unlink(uint32_t idx) {
+    Entry& entry = entries[idx];
+    if (entry.prev != NIL) {
+        entries[entry.prev].next = entry.next;
+    } else {
+        head = entry.next;
+    }
+    if (entry.next != NIL) {
+        entries[entry.next].prev = entry.prev;
+    } else {
+        tail = entry.prev;
+    }
+    entry.prev = NIL;
+    entry.next = NIL;
+}
+
+void DetectionCache::_push_front(uint32_t idx) {
+    Entry& entry = entries[idx];
+    entry.prev = NIL;
+    entry.next = head;
+    if (head != NIL) {
+        entries[head].prev = idx;
+    }
+    head = idx;
+    if (tail == NIL) {
+        tail = idx;
+    }
+}
+
+bool DetectionCache::lookup(uint64_t key, std::tuple<bool, std::string>& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(key);
+    if (it == index.end()) {
+        miss_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint32_t idx = it->second;
+    if (idx != head) {
+        _unlink(idx);
+        _push_front(idx);
+    }
+
+    const Entry& entry = entries[idx];
+    result = std::make_tuple(entry.is_prohibited, entry.reason);
+    hit_count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void DetectionCache::insert(uint64_t key, const std::tuple<bool, std::string>& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    uint32_t idx;
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Обновляем существующую запись
+        idx = it->second;
+        _unlink(idx);
+    } else if (used < entries.size()) {
+        // Есть свободное место
+        idx = used++;
+        index.emplace(key, idx);
+    } else {
+        // Вытесняем самую старую запись
+        idx = tail;
+        _unlink(idx);
+        index.erase(entries[idx].key);
+        index.emplace(key, idx);
+    }
+
+    Entry& entry = entries[idx];
+    entry.key = key;
+    entry.is_prohibited = std::get<0>(result);
+    entry.reason = std::get<1>(result);
+    _push_front(idx);
+}
+
+void DetectionCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto& entry : entries) {
+        entry = Entry();
+    }
+    index.clear();
+    head = NIL;
+    tail = NIL;
+    used = 0;
+    hit_count.store(0, std::memory_order_relaxed);
+    miss_count.store(0, std::memory_order_relaxed);
+}
+
+size_t DetectionCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return used;
+}
+
+} // namespace audiocensor
@@ -0,0 +1,220 @@
+#include "audiocensor/device_catalog.h"
+
+#include <portaudio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace audiocensor {
+
+DeviceCatalog::DeviceCatalog()
+    : initialized(false), generation_value(0) {
+}
+
+DeviceCatalog::~DeviceCatalog() {
+    terminate();
+}
+
+bool DeviceCatalog::initialize() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!initialized) {
+            PaError err = Pa_Initialize();
+            if (err != paNoError) {
+                error_message = Pa_GetErrorText(err);
+                std::cerr << "Ошибка инициализации PortAudio: " << error_message << std::endl;
+                return false;
+            }
+            initialized = true;
+        }
+    }
+
+    return _scan(nullptr);
+}
+
+bool DeviceCatalog::rescan(Changes* changes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (initialized) {
+            Pa_Terminate();
+            initialized = false;
+        }
+
+        PaError err = Pa_Initialize();
+        if (err != paNoError) {
+            error_message = Pa_GetErrorText(err);
+            std::cerr << "Ошибка повторной инициализации PortAudio: " << error_message << std::endl;
+            return false;
+        }
+        initialized = true;
+    }
+
+    return _scan(changes);
+}
+
+void DeviceCatalog::terminate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (initialized) {
+        Pa_Terminate();
+        initialized = false;
+    }
+    entries.clear();
+    system_signature.clear();
+}
+
+bool DeviceCatalog::is_initialized() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return initialized;
+}
+
+bool DeviceCatalog::rescan_due(int fallback_interval_ms) const {
+    std::string signature = _read_system_signature();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!signature.empty()) {
+        return signature != system_signature;
+    }
+    if (fallback_interval_ms <= 0) {
+        return false;
+    }
+    return std::chrono::steady_clock::now() - scanned_at >= std::chrono::milliseconds(fallback_interval_ms);
+}
+
+uint64_t DeviceCatalog::generation() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return generation_value;
+}
+
+std::vector<AudioDeviceInfo> DeviceCatalog::devices() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries;
+}
+
+bool DeviceCatalog::get(int index, AudioDeviceInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : entries) {
+        if (entry.index == index) {
+            info = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+int DeviceCatalog::find(const std::string& key, bool input) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : entries) {
+        int channels = input ? entry.max_input_channels : entry.max_output_channels;
+        if (channels > 0 && entry.key() == key) {
+            return entry.index;
+        }
+    }
+    return -1;
+}
+
+std::string DeviceCatalog::error() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error_message;
+}
+
+bool DeviceCatalog::_scan(Changes* changes) {
+    // Подпись снимается до опроса PortAudio: изменение во время опроса
+    // будет замечено при следующей проверке
+    std::string signature = _read_system_signature();
+
+    int count = Pa_GetDeviceCount();
+    if (count < 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error_message = Pa_GetErrorText(count);
+        std::cerr << "Ошибка при получении списка устройств: " << error_message << std::endl;
+        return false;
+    }
+
+    std::vector<AudioDeviceInfo> scanned;
+    scanned.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const PaDeviceInfo* device_info = Pa_GetDeviceInfo(i);
+        if (!device_info) {
+            continue;
+        }
+
+        // Устройства без ввода и вывода не нужны
+        if (device_info->maxInputChannels <= 0 && device_info->maxOutputChannels <= 0) {
+            continue;
+        }
+
+        AudioDeviceInfo info;
+        info.index = i;
+        info.name = device_info->name ? device_info->name : "";
+        const PaHostApiInfo* host_info = Pa_GetHostApiInfo(device_info->hostApi);
+        info.host_api = host_info && host_info->name ? host_info->name : "";
+        info.max_input_channels = device_info->maxInputChannels;
+        info.max_output_channels = device_info->maxOutputChannels;
+        info.default_sample_rate = device_info->defaultSampleRate;
+        info.default_low_input_latency = device_info->defaultLowInputLatency;
+        info.default_low_output_latency = device_info->defaultLowOutputLatency;
+        scanned.push_back(info);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Сравнение по ключам: индексы после повторной инициализации могут сдвинуться
+    auto contains = [](const std::vector<AudioDeviceInfo>& list, const AudioDeviceInfo& info) {
+        return std::any_of(list.begin(), list.end(), [&info](const AudioDeviceInfo& other) {
+            return other.key() == info.key() &&
+                   other.max_input_channels == info.max_input_channels &&
+                   other.max_output_channels == info.max_output_channels;
+        });
+    };
+
+    Changes found;
+    for (const auto& info : scanned) {
+        if (!contains(entries, info)) {
+            found.added.push_back(info);
+        }
+    }
+    for (const auto& info : entries) {
+        if (!contains(scanned, info)) {
+            found.removed.push_back(info);
+        }
+    }
+
+    // Индексы обновляются даже при неизменном наборе устройств
+    bool reindexed = scanned.size() != entries.size();
+    for (size_t i = 0; !reindexed && i < scanned.size(); i++) {
+        reindexed = scanned[i].index != entries[i].index || scanned[i].key() != entries[i].key();
+    }
+    if (found.any() || reindexed || generation_value == 0) {
+        generation_value++;
+    }
+
+    entries = std::move(scanned);
+    system_signature = std::move(signature);
+    scanned_at = std::chrono::steady_clock::now();
+    error_message.clear();
+
+    if (changes) {
+        *changes = std::move(found);
+    }
+    return true;
+}
+
+std::string DeviceCatalog::_read_system_signature() {
+#ifdef __linux__
+    // Список звуковых карт ALSA меняется при подключении и отключении USB устройств
+    std::ifstream cards("/proc/asound/cards");
+    if (!cards) {
+        return "";
+    }
+
+    std::ostringstream contents;
+    contents << cards.rdbuf();
+    return contents.str();
+#else
+    return "";
+#endif
+}
+
+} // namespace audiocensor
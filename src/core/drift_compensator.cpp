@@ -0,0 +1,138 @@
+#include "audiocensor/drift_compensator.h"
+#include "audiocensor/constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace audiocensor {
+
+namespace {
+
+// Постоянная времени сглаживания заполнения, с: подавляет колебания
+// в пределах чанка, которые дает блокирующее чтение и запись
+constexpr double FILL_SMOOTHING_SECONDS = 2.0;
+
+double _config_double(const ConfigSnapshot& config, const std::string& key, double default_value) {
+    try {
+        return std::stod(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+} // namespace
+
+DriftCompensator::DriftCompensator(const ConfigSnapshot& config, int sample_rate, int chunk_size)
+    : enabled(config.get("drift_compensation", "true") == "true"),
+      sample_rate(std::max(sample_rate, 1)),
+      update_interval(static_cast<double>(std::max(chunk_size, 1)) / std::max(sample_rate, 1)),
+      kp(_config_double(config, "drift_kp", DEFAULT_DRIFT_KP)),
+      ki(_config_double(config, "drift_ki", DEFAULT_DRIFT_KI)),
+      max_ppm(std::max(0.0, _config_double(config, "drift_max_ppm", DEFAULT_DRIFT_MAX_PPM))),
+      settle_updates(1),
+      locked(false), settle_count(0), settle_sum(0.0), target_fill(0.0),
+      smoothed_fill(0.0), has_fill(false), integral_ppm(0.0), current_ratio(1.0),
+      position(1.0) {
+
+    double settle_seconds = _config_double(config, "drift_settle_ms", DEFAULT_DRIFT_SETTLE_MS) / 1000.0;
+    settle_updates = std::max<size_t>(1, static_cast<size_t>(settle_seconds / update_interval));
+
+    // Вход чанка плюс соседи для интерполяции
+    history.reserve(static_cast<size_t>(chunk_size) + 4);
+    reset();
+}
+
+void DriftCompensator::reset() {
+    integral_ppm = 0.0;
+    restart();
+
+    // Первый сэмпл интерполируется с нулевым соседом слева
+    history.assign(1, 0.0f);
+    position = 1.0;
+}
+
+void DriftCompensator::restart() {
+    locked = false;
+    settle_count = 0;
+    settle_sum = 0.0;
+    has_fill = false;
+
+    // До измерения цели действует уже найденная оценка расхождения
+    current_ratio = 1.0 + integral_ppm * 1e-6;
+}
+
+void DriftCompensator::update(double fill_samples) {
+    if (!enabled) {
+        return;
+    }
+
+    // Целевое заполнение - среднее за время установления после запуска
+    if (!locked) {
+        settle_sum += fill_samples;
+        if (++settle_count >= settle_updates) {
+            target_fill = settle_sum / static_cast<double>(settle_count);
+            smoothed_fill = target_fill;
+            has_fill = true;
+            locked = true;
+        }
+        return;
+    }
+
+    double alpha = update_interval / (FILL_SMOOTHING_SECONDS + update_interval);
+    smoothed_fill = has_fill ? smoothed_fill + alpha * (fill_samples - smoothed_fill) : fill_samples;
+    has_fill = true;
+
+    // Ошибка в миллисекундах не зависит от частоты дискретизации. Интеграл
+    // сходится к расхождению часов и ограничен тем же пределом (без накопления
+    // за пределом)
+    double error_ms = (smoothed_fill - target_fill) * 1000.0 / sample_rate;
+    integral_ppm = _clamp(integral_ppm + ki * error_ms * update_interval);
+    double ppm = _clamp(kp * error_ms + integral_ppm);
+
+    current_ratio = 1.0 + ppm * 1e-6;
+}
+
+void DriftCompensator::process(const short* input, size_t count, std::vector<short>& output) {
+    output.clear();
+    if (!enabled) {
+        output.assign(input, input + count);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        history.push_back(static_cast<float>(input[i]));
+    }
+
+    // Для сэмпла в позиции p нужны соседи floor(p)-1 .. floor(p)+2
+    while (static_cast<size_t>(position) + 2 < history.size()) {
+        size_t index = static_cast<size_t>(position);
+        float t = static_cast<float>(position - static_cast<double>(index));
+        float y0 = history[index - 1];
+        float y1 = history[index];
+        float y2 = history[index + 1];
+        float y3 = history[index + 2];
+
+        // Кубическая интерполяция Катмулла-Рома
+        float a = -0.5f * y0 + 1.5f * y1 - 1.5f * y2 + 0.5f * y3;
+        float b = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+        float c = -0.5f * y0 + 0.5f * y2;
+        float value = ((a * t + b) * t + c) * t + y1;
+
+        value = std::max(-32768.0f, std::min(32767.0f, std::round(value)));
+        output.push_back(static_cast<short>(value));
+        position += current_ratio;
+    }
+
+    // Оставляем только соседей, нужных следующему чанку
+    size_t consumed = static_cast<size_t>(position) - 1;
+    consumed = std::min(consumed, history.size());
+    history.erase(history.begin(), history.begin() + consumed);
+    position -= static_cast<double>(consumed);
+}
+
+double DriftCompensator::_clamp(double ppm) const {
+    return std::max(-max_ppm, std::min(max_ppm, ppm));
+}
+
+} // namespace audiocensor
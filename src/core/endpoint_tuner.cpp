@@ -0,0 +1,200 @@
+#include "audiocensor/endpoint_tuner.h"
+#include "audiocensor/constants.h"
+
+#include <vosk_api.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace audiocensor {
+
+namespace {
+
+// Измерений в окне подстройки и результатов между пересмотрами паузы
+constexpr size_t LATENCY_WINDOW = 32;
+constexpr size_t TUNE_INTERVAL = 16;
+
+// Шаги подстройки паузы конца фразы
+constexpr double SHORTEN_FACTOR = 0.8;
+constexpr double LENGTHEN_FACTOR = 1.1;
+
+int _config_int(const ConfigSnapshot& config, const std::string& key, int default_value) {
+    try {
+        return std::stoi(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+double _config_double(const ConfigSnapshot& config, const std::string& key, double default_value) {
+    try {
+        return std::stod(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+int _parse_mode(const std::string& mode) {
+    if (mode == "short") {
+        return 1;
+    }
+    if (mode == "long") {
+        return 2;
+    }
+    if (mode == "very_long") {
+        return 3;
+    }
+    return 0;
+}
+
+} // namespace
+
+EndpointTuner::EndpointTuner(const ConfigSnapshot& config, int sample_rate)
+    : sample_rate(sample_rate),
+      mode(_parse_mode(config.get("endpointer_mode", "default"))),
+      start_max_s(_config_double(config, "endpointer_start_max_s", DEFAULT_ENDPOINTER_START_MAX_S)),
+      max_s(_config_double(config, "endpointer_max_s", DEFAULT_ENDPOINTER_MAX_S)),
+      configured_end_ms(std::max(50, _config_int(config, "endpointer_end_ms", DEFAULT_ENDPOINTER_END_MS))),
+      min_end_ms(0),
+      end_silence_ms(0),
+      force_final(config.get("endpointer_force_final", "true") == "true"),
+      auto_tune(config.get("endpointer_auto_tune", "true") == "true"),
+      budget_ms(0.0),
+      speech_power(0.0),
+      speech_seen(false),
+      silence_samples(0),
+      latencies_ms(LATENCY_WINDOW, 0.0),
+      latency_next(0),
+      latency_count(0),
+      since_tune(0),
+      final_count(0),
+      forced_count(0) {
+
+    min_end_ms = std::max(50, std::min(configured_end_ms,
+                                       _config_int(config, "endpointer_min_end_ms", DEFAULT_ENDPOINTER_MIN_END_MS)));
+    end_silence_ms = configured_end_ms;
+
+    // Результат должен приходить с запасом: остальная часть задержки - на уточнение границ и вывод
+    double buffer_delay = _config_double(config, "buffer_delay", DEFAULT_BUFFER_DELAY);
+    int budget_percent = std::max(10, std::min(100, _config_int(config, "endpointer_budget_percent",
+                                                                DEFAULT_ENDPOINTER_BUDGET_PERCENT)));
+    budget_ms = buffer_delay * 1000.0 * budget_percent / 100.0;
+
+    // Порог речи в dBFS переводится в средний квадрат сэмпла
+    int speech_db = _config_int(config, "endpointer_speech_db", DEFAULT_ENDPOINTER_SPEECH_DB);
+    double threshold = 32768.0 * std::pow(10.0, speech_db / 20.0);
+    speech_power = threshold * threshold;
+
+    sorted.reserve(LATENCY_WINDOW);
+}
+
+bool EndpointTuner::apply(VoskRecognizer* recognizer) const {
+#ifdef HAVE_VOSK_ENDPOINTER
+    if (!recognizer) {
+        return false;
+    }
+
+    // Режим масштабирует задержки по умолчанию, явные задержки задаются после него
+    vosk_recognizer_set_endpointer_mode(recognizer, static_cast<VoskEndpointerMode>(mode));
+    vosk_recognizer_set_endpointer_delays(recognizer, static_cast<float>(start_max_s),
+                                          static_cast<float>(end_silence_ms / 1000.0),
+                                          static_cast<float>(max_s));
+    return true;
+#else
+    (void)recognizer;
+    return false;
+#endif
+}
+
+bool EndpointTuner::process_chunk(const short* samples, size_t count) {
+    if (count == 0) {
+        return false;
+    }
+
+    double power = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double sample = samples[i];
+        power += sample * sample;
+    }
+
+    if (power / count >= speech_power) {
+        speech_seen = true;
+        silence_samples = 0;
+        return false;
+    }
+
+    silence_samples += static_cast<int64_t>(count);
+    return force_final && speech_seen &&
+           silence_samples >= static_cast<int64_t>(sample_rate) * end_silence_ms / 1000;
+}
+
+bool EndpointTuner::on_final(int64_t latency_samples, bool forced) {
+    speech_seen = false;
+    silence_samples = 0;
+    final_count++;
+    if (forced) {
+        forced_count++;
+    }
+
+    // Результат без слов (шум) не говорит о задержке
+    if (latency_samples < 0) {
+        return false;
+    }
+
+    latencies_ms[latency_next] = latency_samples * 1000.0 / sample_rate;
+    latency_next = (latency_next + 1) % latencies_ms.size();
+    latency_count = std::min(latency_count + 1, latencies_ms.size());
+
+    if (!auto_tune || ++since_tune < TUNE_INTERVAL) {
+        return false;
+    }
+    since_tune = 0;
+    return _tune();
+}
+
+double EndpointTuner::mean_ms() const {
+    if (latency_count == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < latency_count; i++) {
+        sum += latencies_ms[i];
+    }
+    return sum / latency_count;
+}
+
+double EndpointTuner::_percentile_ms(int percent) const {
+    if (latency_count == 0) {
+        return 0.0;
+    }
+    sorted.assign(latencies_ms.begin(), latencies_ms.begin() + latency_count);
+    size_t rank = (latency_count * static_cast<size_t>(percent) + 99) / 100;
+    size_t index = std::min(latency_count - 1, rank > 0 ? rank - 1 : 0);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+bool EndpointTuner::_tune() {
+    double p95 = p95_ms();
+    int previous = end_silence_ms;
+
+    if (p95 > budget_ms) {
+        // Результаты опаздывают: фраза закрывается после более короткой паузы
+        end_silence_ms = std::max(min_end_ms, static_cast<int>(end_silence_ms * SHORTEN_FACTOR));
+    } else if (p95 < budget_ms / 2 && end_silence_ms < configured_end_ms) {
+        // Большой запас: длинная пауза реже разрывает фразу и дает распознавателю больше контекста
+        end_silence_ms = std::min(configured_end_ms, static_cast<int>(std::ceil(end_silence_ms * LENGTHEN_FACTOR)));
+    }
+
+    if (end_silence_ms == previous) {
+        return false;
+    }
+
+    // Прежние измерения сделаны с другой паузой: следующее решение - по новым
+    latency_next = 0;
+    latency_count = 0;
+    return true;
+}
+
+} // namespace audiocensor
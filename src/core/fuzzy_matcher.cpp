@@ -0,0 +1,263 @@
+#include "audiocensor/fuzzy_matcher.h"
+#include "audiocensor/text_normalizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace audiocensor {
+
+namespace {
+
+// Символ алфавита для всего, что не является латиницей или кириллицей
+constexpr uint8_t OTHER_SYMBOL = 255;
+
+uint8_t symbol_for(uint32_t cp) {
+    if (cp < 128) {
+        return static_cast<uint8_t>(cp);
+    }
+    if (cp >= 0x0430 && cp <= 0x045F) {
+        return static_cast<uint8_t>(128 + (cp - 0x0430));
+    }
+    return OTHER_SYMBOL;
+}
+
+} // namespace
+
+FuzzyMatcher::FuzzyMatcher()
+    : symbols(nullptr), symbol_count(0),
+      entries(nullptr), entry_count(0),
+      length_offsets(nullptr), max_threshold(0) {
+}
+
+int FuzzyMatcher::parse_threshold(const std::string& entry, std::string& word) {
+    size_t pos = entry.rfind('~');
+    if (pos != std::string::npos && pos + 1 < entry.size()) {
+        bool digits = std::all_of(entry.begin() + pos + 1, entry.end(),
+                                  [](unsigned char c) { return c >= '0' && c <= '9'; });
+        if (digits && entry.size() - pos - 1 <= 2) {
+            word = entry.substr(0, pos);
+            return std::stoi(entry.substr(pos + 1));
+        }
+    }
+    word = entry;
+    return -1;
+}
+
+int FuzzyMatcher::default_threshold(size_t letters) {
+    // Короткие слова слишком легко "совпадают" с соседними
+    if (letters <= 3) {
+        return 0;
+    }
+    if (letters <= 5) {
+        return 1;
+    }
+    return 2;
+}
+
+bool FuzzyMatcher::_encode(const std::string& word, std::vector<uint8_t>& output) {
+    output.clear();
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(word.data());
+    const unsigned char* end = p + word.size();
+    while (p < end) {
+        uint32_t cp;
+        p += text::decode_utf8(p, end, cp);
+        if (output.size() == MAX_WORD_LENGTH) {
+            return false;
+        }
+        output.push_back(symbol_for(cp));
+    }
+    return true;
+}
+
+void FuzzyMatcher::clear() {
+    symbol_storage.clear();
+    entry_storage.clear();
+    length_offset_storage.clear();
+    attach(nullptr, 0, nullptr, 0, nullptr, 0);
+}
+
+void FuzzyMatcher::attach(const uint8_t* symbol_data, size_t symbol_total,
+                          const Entry* entry_data, size_t entry_total,
+                          const uint32_t* length_offset_data, int threshold) {
+    symbols = symbol_data;
+    symbol_count = symbol_total;
+    entries = entry_data;
+    entry_count = length_offset_data ? entry_total : 0;
+    length_offsets = length_offset_data;
+    max_threshold = threshold;
+}
+
+void FuzzyMatcher::build(const std::vector<std::string>& normalized_words,
+                         const std::vector<int>& thresholds,
+                         int max_distance) {
+    clear();
+
+    int threshold_max = 0;
+    std::vector<uint8_t> encoded;
+    for (size_t i = 0; i < normalized_words.size(); i++) {
+        const std::string& word = normalized_words[i];
+        if (word.empty() || !_encode(word, encoded)) {
+            continue;
+        }
+
+        int threshold = (i < thresholds.size() && thresholds[i] >= 0)
+                            ? thresholds[i]
+                            : std::min(default_threshold(encoded.size()), max_distance);
+        threshold = std::min<int>(threshold, static_cast<int>(encoded.size()) - 1);
+        if (threshold <= 0) {
+            // Точные совпадения проверяются отдельно
+            continue;
+        }
+
+        Entry entry;
+        entry.offset = static_cast<uint32_t>(symbol_storage.size());
+        entry.length = static_cast<uint8_t>(encoded.size());
+        entry.first_symbol = encoded[0];
+        entry.max_distance = static_cast<uint8_t>(threshold);
+        entry.reserved = 0;
+        entry.word_index = static_cast<uint32_t>(i);
+
+        symbol_storage.insert(symbol_storage.end(), encoded.begin(), encoded.end());
+        entry_storage.push_back(entry);
+        threshold_max = std::max(threshold_max, threshold);
+    }
+
+    std::sort(entry_storage.begin(), entry_storage.end(), [](const Entry& a, const Entry& b) {
+        if (a.length != b.length) {
+            return a.length < b.length;
+        }
+        return a.first_symbol < b.first_symbol;
+    });
+
+    // length_offsets[L] - первая запись длины L, length_offsets[L + 1] - конец группы
+    length_offset_storage.assign(MAX_WORD_LENGTH + 2, 0);
+    size_t pos = 0;
+    for (size_t length = 0; length <= MAX_WORD_LENGTH + 1; length++) {
+        while (pos < entry_storage.size() && entry_storage[pos].length < length) {
+            pos++;
+        }
+        length_offset_storage[length] = static_cast<uint32_t>(pos);
+    }
+
+    attach(symbol_storage.data(), symbol_storage.size(),
+           entry_storage.data(), entry_storage.size(),
+           length_offset_storage.data(), threshold_max);
+}
+
+int FuzzyMatcher::_distance(const uint64_t* peq, size_t query_length,
+                            const uint8_t* text, size_t text_length, int limit) {
+    const uint64_t high_bit = 1ULL << (query_length - 1);
+
+    uint64_t pv = ~0ULL;
+    uint64_t mv = 0;
+    int score = static_cast<int>(query_length);
+
+    for (size_t j = 0; j < text_length; j++) {
+        uint64_t eq = peq[text[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & high_bit) {
+            score++;
+        } else if (mh & high_bit) {
+            score--;
+        }
+
+        // Для полного расстояния верхняя граница растет на 1 с каждой буквой
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // Оставшиеся буквы могут уменьшить расстояние не больше чем на их количество
+        if (score - static_cast<int>(text_length - j - 1) > limit) {
+            return limit + 1;
+        }
+    }
+
+    return score;
+}
+
+bool FuzzyMatcher::find(const std::string& normalized_word, uint32_t& word_index, int& distance, int slack) const {
+    if (entry_count == 0) {
+        return false;
+    }
+    int threshold = max_threshold + std::max(slack, 0);
+
+    // Кодируем запрос без выделения памяти
+    uint8_t query[MAX_WORD_LENGTH];
+    size_t query_length = 0;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(normalized_word.data());
+    const unsigned char* end = p + normalized_word.size();
+    while (p < end) {
+        uint32_t cp;
+        p += text::decode_utf8(p, end, cp);
+        if (query_length == MAX_WORD_LENGTH) {
+            return false;
+        }
+        query[query_length++] = symbol_for(cp);
+    }
+    if (query_length == 0) {
+        return false;
+    }
+
+    // Битовые маски вхождений символов в запрос
+    uint64_t peq[256];
+    std::memset(peq, 0, sizeof(peq));
+    for (size_t i = 0; i < query_length; i++) {
+        peq[query[i]] |= 1ULL << i;
+    }
+
+    size_t min_length = query_length > static_cast<size_t>(threshold)
+                            ? query_length - threshold : 1;
+    size_t max_length = std::min(query_length + threshold, MAX_WORD_LENGTH);
+
+    int best_distance = threshold + 1;
+    const Entry* best_entry = nullptr;
+
+    for (size_t length = min_length; length <= max_length; length++) {
+        // Смещения могут прийти из файла, поэтому не доверяем им вслепую
+        const Entry* group_begin = entries + std::min<size_t>(length_offsets[length], entry_count);
+        const Entry* group_end = entries + std::min<size_t>(length_offsets[length + 1], entry_count);
+        if (group_begin >= group_end) {
+            continue;
+        }
+
+        // Внутри группы одной длины записи отсортированы по первому символу
+        uint8_t first = query[0];
+        auto range_begin = std::lower_bound(group_begin, group_end, first,
+            [](const Entry& entry, uint8_t symbol) { return entry.first_symbol < symbol; });
+        auto range_end = std::upper_bound(range_begin, group_end, first,
+            [](uint8_t symbol, const Entry& entry) { return symbol < entry.first_symbol; });
+
+        int length_gap = static_cast<int>(length > query_length ? length - query_length
+                                                                : query_length - length);
+        for (auto it = range_begin; it != range_end; ++it) {
+            int limit = std::min<int>(it->max_distance + std::max(slack, 0), best_distance - 1);
+            if (length_gap > limit || it->offset + static_cast<size_t>(it->length) > symbol_count) {
+                continue;
+            }
+
+            int d = _distance(peq, query_length, symbols + it->offset, it->length, limit);
+            if (d <= limit) {
+                best_distance = d;
+                best_entry = it;
+                if (d == 0) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!best_entry) {
+        return false;
+    }
+
+    word_index = best_entry->word_index;
+    distance = best_distance;
+    return true;
+}
+
+} // namespace audiocensor
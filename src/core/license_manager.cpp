@@ -31,8 +31,35 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::stri
     return realsize;
 }
 
+// Прерывает запрос при закрытии приложения
+static int ProgressCallback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    const std::atomic<bool>* shutting_down = static_cast<const std::atomic<bool>*>(clientp);
+    return shutting_down->load() ? 1 : 0;
+}
+
+static long config_long(const std::unordered_map<std::string, std::string>& config,
+                        const std::string& key, long default_value) {
+    auto it = config.find(key);
+    if (it == config.end() || it->second.empty()) {
+        return default_value;
+    }
+    try {
+        return std::stol(it->second);
+    } catch (...) {
+        return default_value;
+    }
+}
+
 LicenseManager::LicenseManager(QObject* parent)
-    : QObject(parent) {
+    : QObject(parent),
+      verified_at(0),
+      cache_trusted(false),
+      offline_grace_days(DEFAULT_LICENSE_OFFLINE_GRACE_DAYS),
+      reverify_hours(DEFAULT_LICENSE_REVERIFY_HOURS),
+      timeout_ms(DEFAULT_LICENSE_TIMEOUT_MS),
+      connect_timeout_ms(DEFAULT_LICENSE_CONNECT_TIMEOUT_MS),
+      verification_running(false),
+      shutting_down(false) {
 
     // Проверка целостности и окружения
     _check_environment();
@@ -51,18 +78,126 @@ LicenseManager::LicenseManager(QObject* parent)
     words_api_url = security::deobscure_str(API_WORDS_URL);
     telegram_contact = security::deobscure_str(TELEGRAM_CONTACT);
 
-    // Добавляем небольшую задержку для защиты от автоматизированных атак
-    security::add_random_delay(50, 100); // 50-100 мс
+    // Состояние последней онлайн-проверки
+    machine_id = security::get_machine_id();
+    _load_cache();
 
     // Инициализация cURL
     curl_global_init(CURL_GLOBAL_ALL);
 }
 
 LicenseManager::~LicenseManager() {
+    // Прерываем фоновую проверку до освобождения настроек
+    shutting_down = true;
+    if (verification_worker.joinable()) {
+        verification_worker.join();
+    }
+
     delete settings;
     curl_global_cleanup();
 }
 
+void LicenseManager::apply_config(const std::unordered_map<std::string, std::string>& config) {
+    auto url = config.find("license_api_url");
+    if (url != config.end() && !url->second.empty()) {
+        verification_url = url->second;
+    }
+
+    offline_grace_days = static_cast<int>(config_long(config, "license_offline_grace_days",
+                                                      DEFAULT_LICENSE_OFFLINE_GRACE_DAYS));
+    reverify_hours = static_cast<int>(config_long(config, "license_reverify_hours",
+                                                  DEFAULT_LICENSE_REVERIFY_HOURS));
+    timeout_ms = config_long(config, "license_timeout_ms", DEFAULT_LICENSE_TIMEOUT_MS);
+    connect_timeout_ms = config_long(config, "license_connect_timeout_ms", DEFAULT_LICENSE_CONNECT_TIMEOUT_MS);
+}
+
+std::string LicenseManager::_cache_signature(const std::string& payload) const {
+    // Ключ привязан к устройству: перенесенный на другую машину кэш недействителен
+    return security::hmac_sha256(machine_id + security::get_hardware_salt() + LICENSE_APP, payload);
+}
+
+void LicenseManager::_load_cache() {
+    verified_at = 0;
+    cache_trusted = false;
+
+    if (license_key.empty() || expiry_date.empty()) {
+        return;
+    }
+
+    QString stored = settings->value("license_cache", "").toString();
+    QString signature = settings->value("license_cache_signature", "").toString();
+
+    if (stored.isEmpty()) {
+        // Лицензия сохранена до появления кэша (или кэш удален): без подписи
+        // ей нельзя доверять, пока сервер не подтвердит ключ. Проверка
+        // запускается при старте, когда адрес сервера уже настроен
+        // (needs_online_verification возвращает true)
+        std::cerr << "Кэш лицензии отсутствует, требуется онлайн-проверка" << std::endl;
+        return;
+    }
+
+    try {
+        std::string payload = security::deobscure_str(stored.toStdString());
+        if (_cache_signature(payload) != signature.toStdString()) {
+            std::cerr << "Подпись кэша лицензии не совпадает, требуется онлайн-проверка" << std::endl;
+            return;
+        }
+
+        // Ключ и дата в настройках должны совпадать с подписанными
+        json data = json::parse(payload);
+        if (data.value("license_key", "") != license_key ||
+            data.value("expiry_date", "") != expiry_date ||
+            data.value("machine_id", "") != machine_id) {
+            std::cerr << "Кэш лицензии не соответствует сохраненной лицензии" << std::endl;
+            return;
+        }
+
+        verified_at = data.value("verified_at", static_cast<int64_t>(0));
+        cache_trusted = true;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка чтения кэша лицензии: " << e.what() << std::endl;
+    }
+}
+
+void LicenseManager::_save_cache() {
+    json data;
+    data["license_key"] = license_key;
+    data["expiry_date"] = expiry_date;
+    data["machine_id"] = machine_id;
+    data["verified_at"] = verified_at;
+
+    std::string payload = data.dump();
+    settings->setValue("license_cache", QString::fromStdString(security::obscure_str(payload)));
+    settings->setValue("license_cache_signature", QString::fromStdString(_cache_signature(payload)));
+    settings->sync();
+}
+
+bool LicenseManager::is_within_offline_grace() const {
+    if (!cache_trusted) {
+        return false;
+    }
+
+    // Неположительное значение отключает ограничение
+    if (offline_grace_days <= 0) {
+        return true;
+    }
+
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    return now - verified_at <= static_cast<int64_t>(offline_grace_days) * 24 * 60 * 60;
+}
+
+bool LicenseManager::needs_online_verification() const {
+    if (license_key.empty()) {
+        return false;
+    }
+    if (!cache_trusted) {
+        return true;
+    }
+
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    return now - verified_at >= static_cast<int64_t>(reverify_hours) * 60 * 60;
+}
+
 void LicenseManager::_check_environment() {
     // Защита от отладки
     if (security::detect_debugger()) {
@@ -81,8 +216,13 @@ void LicenseManager::reset_all_license_data() {
     expiry_date = "";
 
     // Очищаем все сохраненные значения
+    verified_at = 0;
+    cache_trusted = false;
+
     settings->remove("license_key");
     settings->remove("expiry_date");
+    settings->remove("license_cache");
+    settings->remove("license_cache_signature");
     // Удаляем устаревшее значение, если оно существует
     settings->remove("first_run_date");
     settings->sync();
@@ -93,9 +233,6 @@ std::pair<bool, std::string> LicenseManager::activate_trial_period() {
         // Защитная задержка
         security::add_random_delay(50, 100);
 
-        // Получаем machine_id для идентификации устройства
-        std::string machine_id = security::get_machine_id();
-
         // Подготавливаем данные для запроса с добавлением уникального идентификатора
         json payload;
         payload["machine_id"] = machine_id;
@@ -105,37 +242,14 @@ std::pair<bool, std::string> LicenseManager::activate_trial_period() {
         // Преобразуем JSON в строку
         std::string payload_str = payload.dump();
 
-        // Выполняем запрос к API с помощью cURL
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            return {false, "Ошибка инициализации cURL"};
+        // Выполняем запрос к API
+        VerificationResponse response = _post_json(trial_url, payload_str);
+        if (!response.received) {
+            return {false, "Ошибка cURL: " + response.error};
         }
 
-        std::string response_data;
-
-        curl_easy_setopt(curl, CURLOPT_URL, trial_url.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload_str.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, payload_str.length());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-        // Устанавливаем заголовки
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        CURLcode res = curl_easy_perform(curl);
-
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-
-        if (res != CURLE_OK) {
-            return {false, std::string("Ошибка cURL: ") + curl_easy_strerror(res)};
-        }
+        long http_code = response.http_code;
+        const std::string& response_data = response.body;
 
         if (http_code == 200) {
             try {
@@ -156,10 +270,12 @@ std::pair<bool, std::string> LicenseManager::activate_trial_period() {
                     license_key = data["license_key"];
                     expiry_date = data["expiry_date"];
 
-                    // Сохраняем в настройки
+                    // Сохраняем в настройки; ключ только что выдан сервером
                     settings->setValue("license_key", QString::fromStdString(license_key));
                     settings->setValue("expiry_date", QString::fromStdString(expiry_date));
-                    settings->sync();
+                    verified_at = static_cast<int64_t>(std::time(nullptr));
+                    cache_trusted = true;
+                    _save_cache();
 
                     return {true, "Тестовая лицензия успешно активирована"};
                 } else {
@@ -266,9 +382,6 @@ bool LicenseManager::check_trial_period() {
 }
 
 std::unordered_map<std::string, std::string> LicenseManager::get_license_status() {
-    // Защитная задержка
-    security::add_random_delay(50, 100);
-
     std::unordered_map<std::string, std::string> status;
     status["has_license"] = "false";
     status["license_key"] = "";
@@ -299,7 +412,12 @@ std::unordered_map<std::string, std::string> LicenseManager::get_license_status(
                 bool is_trial = _is_trial_key(license_key, expiry_date);
                 status["trial_active"] = is_trial ? "true" : "false";
 
-                if (days_remaining > 0) {
+                if (days_remaining > 0 && !is_within_offline_grace()) {
+                    // Локальная лицензия не подтверждена сервером слишком давно
+                    status["status_text"] = "Требуется подключение к серверу для проверки лицензии";
+                    status["has_license"] = "false";
+                    status["trial_active"] = "false";
+                } else if (days_remaining > 0) {
                     if (is_trial) {
                         status["status_text"] = "Тестовая лицензия активна, осталось " +
                                                 std::to_string(days_remaining) + " дней";
@@ -324,9 +442,6 @@ std::unordered_map<std::string, std::string> LicenseManager::get_license_status(
 }
 
 bool LicenseManager::_is_trial_key(const std::string& key, const std::string& expiry_date_str) {
-    // Защитная задержка
-    security::add_random_delay(50, 100);
-
     // Пример определения по сроку действия
     if (key.empty() || expiry_date_str.empty()) {
         return false;
@@ -391,7 +506,11 @@ bool LicenseManager::save_license(const std::string& key, const std::string& exp
     this->expiry_date = expiry_date_str;
     settings->setValue("license_key", QString::fromStdString(key));
     settings->setValue("expiry_date", QString::fromStdString(expiry_date_str));
-    settings->sync();
+
+    // Сохраненная лицензия считается подтвержденной сервером
+    verified_at = static_cast<int64_t>(std::time(nullptr));
+    cache_trusted = true;
+    _save_cache();
     return true;
 }
 
@@ -402,28 +521,34 @@ bool LicenseManager::has_valid_license() {
     // Проверяем окружение
     _check_environment();
 
-    // Проверяем наличие лицензионного ключа
+    // Решение принимается по локальному состоянию, сеть не ждем
     if (!license_key.empty() && !expiry_date.empty()) {
         try {
             std::tm expiry_tm = {};
             std::istringstream ss(expiry_date);
             ss >> std::get_time(&expiry_tm, "%Y-%m-%d");
             if (ss.fail()) {
-                return verify_license_online(license_key);
+                start_background_verification();
+                return false;
             }
 
             std::time_t expiry_time = std::mktime(&expiry_tm);
             std::time_t now = std::time(nullptr);
 
-            if (now <= expiry_time) {
+            if (now <= expiry_time && is_within_offline_grace()) {
+                if (needs_online_verification()) {
+                    start_background_verification();
+                }
                 return true; // Лицензия действительна
-            } else {
-                // Попытка обновить онлайн
-                return verify_license_online(license_key);
             }
+
+            // Срок истек или лицензию давно не подтверждали: сервер мог ее продлить
+            start_background_verification();
+            return false;
         } catch (const std::exception& e) {
             std::cerr << "Ошибка проверки лицензии: " << e.what() << std::endl;
-            return verify_license_online(license_key);
+            start_background_verification();
+            return false;
         }
     }
 
@@ -431,116 +556,175 @@ bool LicenseManager::has_valid_license() {
     return false;
 }
 
-bool LicenseManager::verify_license_online(const std::string& key) {
-    try {
-        // Защитная задержка
-        security::add_random_delay(50, 100);
+std::string LicenseManager::_build_verification_payload(const std::string& key) {
+    // Отправляем запрос на сервер с дополнительными проверками
+    json payload;
+    payload["license_key"] = key;
+    payload["machine_id"] = machine_id;
+    payload["timestamp"] = static_cast<int>(std::time(nullptr));
+    payload["request_id"] = _generate_request_id();
+    payload["app_signature"] = _generate_app_signature();
 
-        // Создаем уникальный хэш для устройства
-        std::string machine_id = security::get_machine_id();
+    return payload.dump();
+}
 
-        // Отправляем запрос на сервер с дополнительными проверками
-        json payload;
-        payload["license_key"] = key;
-        payload["machine_id"] = machine_id;
-        payload["timestamp"] = static_cast<int>(std::time(nullptr));
-        payload["request_id"] = _generate_request_id();
-        payload["app_signature"] = _generate_app_signature();
+LicenseManager::VerificationResponse LicenseManager::_post_json(const std::string& url,
+                                                                const std::string& payload) const {
+    VerificationResponse response;
 
-        std::string payload_str = payload.dump();
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        response.error = "ошибка инициализации cURL";
+        return response;
+    }
 
-        // Выполняем запрос к API с помощью cURL
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            return false;
-        }
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, payload.length());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);  // Запрос может выполняться не в главном потоке
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, ProgressCallback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &shutting_down);
+
+    // Устанавливаем заголовки
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.http_code);
+
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+
+    response.received = (res == CURLE_OK);
+    if (!response.received) {
+        response.error = curl_easy_strerror(res);
+    }
+    return response;
+}
 
-        std::string response_data;
+bool LicenseManager::_apply_verification(const std::string& key, const VerificationResponse& response,
+                                         std::string& message) {
+    // Без ответа сервера доверяем кэшу, пока не истек льготный период
+    bool offline_valid = !license_key.empty() && !expiry_date.empty() &&
+                         key == license_key && is_within_offline_grace();
 
-        curl_easy_setopt(curl, CURLOPT_URL, verification_url.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload_str.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, payload_str.length());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+    if (!response.received) {
+        message = "сервер лицензий недоступен (" + response.error + ")";
+        return offline_valid;
+    }
 
-        // Устанавливаем заголовки
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    if (response.http_code != 200) {
+        message = "ошибка сервера лицензий: " + std::to_string(response.http_code);
+        return offline_valid;
+    }
 
-        CURLcode res = curl_easy_perform(curl);
+    try {
+        json data = json::parse(response.body);
 
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        if (data["status"] == "valid") {
+            // Проверяем полученные данные
+            std::unordered_map<std::string, std::string> license_data;
+            license_data["license_key"] = data["license_key"];
+            license_data["expiry_date"] = data["expiry_date"];
 
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
+            if (!_validate_license_data(license_data)) {
+                message = "получены некорректные данные лицензии";
+                return false;
+            }
 
-        if (res != CURLE_OK) {
-            // При ошибке соединения используем локальные данные
-            return !license_key.empty() && !expiry_date.empty();
+            // Обновляем локальные данные и время подтверждения
+            save_license(key, data["expiry_date"]);
+            message = "лицензия подтверждена сервером";
+            return true;
         }
 
-        if (http_code == 200) {
-            try {
-                json data = json::parse(response_data);
+        // Очищаем недействительную лицензию
+        if (data["status"] == "expired" || data["status"] == "invalid") {
+            if (key == license_key) {
+                clear_license();
+            }
+        }
+        message = "сервер отклонил лицензию";
+        return false;
+    } catch (const std::exception& e) {
+        // При ошибке разбора JSON используем локальные данные
+        message = std::string("ошибка разбора ответа сервера лицензий: ") + e.what();
+        return offline_valid;
+    }
+}
 
-                if (data["status"] == "valid") {
-                    // Проверяем полученные данные
-                    std::unordered_map<std::string, std::string> license_data;
-                    license_data["license_key"] = data["license_key"];
-                    license_data["expiry_date"] = data["expiry_date"];
+bool LicenseManager::verify_license_online(const std::string& key) {
+    try {
+        // Защитная задержка
+        security::add_random_delay(50, 100);
 
-                    if (!_validate_license_data(license_data)) {
-                        return false;
-                    }
+        VerificationResponse response = _post_json(verification_url, _build_verification_payload(key));
 
-                    // Обновляем локальные данные
-                    save_license(key, data["expiry_date"]);
-                    return true;
-                } else {
-                    // Очищаем недействительную лицензию
-                    if (data["status"] == "expired" || data["status"] == "invalid") {
-                        clear_license();
-                    }
-                    return false;
-                }
-            } catch (const json::parse_error& e) {
-                // При ошибке разбора JSON используем локальные данные
-                return !license_key.empty() && !expiry_date.empty();
-            }
-        } else {
-            // При ошибке сервера используем локальные данные, если они есть
-            return !license_key.empty() && !expiry_date.empty();
-        }
+        std::string message;
+        return _apply_verification(key, response, message);
     } catch (const std::exception& e) {
         std::cerr << "Ошибка при проверке лицензии онлайн: " << e.what() << std::endl;
         // При ошибке соединения используем локальные данные
-        return !license_key.empty() && !expiry_date.empty();
+        return key == license_key && is_within_offline_grace();
+    }
+}
+
+bool LicenseManager::start_background_verification() {
+    if (license_key.empty() || verification_running.exchange(true)) {
+        return false;
+    }
+
+    // Предыдущий поток уже завершился (флаг был сброшен), забираем его
+    if (verification_worker.joinable()) {
+        verification_worker.join();
+    }
+
+    // Запрос формируется здесь: поля объекта читаются только в его потоке
+    std::string key = license_key;
+    std::string payload;
+    try {
+        payload = _build_verification_payload(key);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка подготовки проверки лицензии: " << e.what() << std::endl;
+        verification_running = false;
+        return false;
     }
+
+    std::string url = verification_url;
+    verification_worker = std::thread([this, key, url, payload]() {
+        VerificationResponse response = _post_json(url, payload);
+        verification_running = false;
+        if (shutting_down) {
+            return;
+        }
+
+        // Состояние и настройки меняются только в потоке объекта
+        QMetaObject::invokeMethod(this, [this, key, response]() {
+            std::string message;
+            bool valid = _apply_verification(key, response, message);
+            emit licenseVerified(valid, QString::fromStdString(message));
+        }, Qt::QueuedConnection);
+    });
+    return true;
 }
 
 std::string LicenseManager::_generate_app_signature() {
     try {
         if (security::is_running_as_executable()) {
-            std::string executable_path;
-
-            #ifdef _WIN32
-            char buffer[MAX_PATH];
-            GetModuleFileNameA(NULL, buffer, MAX_PATH);
-            executable_path = buffer;
-            #else
-            char buffer[PATH_MAX];
-            ssize_t count = readlink("/proc/self/exe", buffer, PATH_MAX);
-            if (count != -1) {
-                executable_path = std::string(buffer, count);
-            }
-            #endif
+            // Исполняемый файл не меняется за время работы: читаем его один раз
+            static const std::string executable_signature = []() -> std::string {
+                // Берем первые 1024 байта для ускорения
+                std::ifstream file(std::filesystem::u8path(security::get_executable_path()), std::ios::binary);
+                if (!file) {
+                    return "";
+                }
 
-            // Берем первые 1024 байта для ускорения
-            std::ifstream file(executable_path, std::ios::binary);
-            if (file) {
                 char buffer[1024];
                 file.read(buffer, 1024);
                 std::streamsize readBytes = file.gcount();
@@ -552,8 +736,11 @@ std::string LicenseManager::_generate_app_signature() {
                 for (int i = 0; i < MD5_DIGEST_LENGTH; i++) {
                     ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(md[i]);
                 }
-
                 return ss.str();
+            }();
+
+            if (!executable_signature.empty()) {
+                return executable_signature;
             }
 
             // Если не удалось прочитать файл, используем запасной вариант
@@ -572,8 +759,12 @@ std::string LicenseManager::_generate_app_signature() {
 void LicenseManager::clear_license() {
     license_key = "";
     expiry_date = "";
+    verified_at = 0;
+    cache_trusted = false;
     settings->remove("license_key");
     settings->remove("expiry_date");
+    settings->remove("license_cache");
+    settings->remove("license_cache_signature");
     settings->sync();
 }
 
@@ -0,0 +1,42 @@
+#include "audiocensor/log_buffer.h"
+
+namespace audiocensor {
+
+LogBuffer::LogBuffer(size_t capacity)
+    : entries(capacity > 0 ? capacity : 1),
+      count(0),
+      next(0) {
+}
+
+uint64_t LogBuffer::append(std::time_t timestamp, const std::string& message) {
+    // Место определяется номером записи; при переполнении перезаписывается самая старая
+    Entry& entry = entries[next % entries.size()];
+    entry.sequence = next;
+    entry.timestamp = timestamp;
+    entry.message.assign(message);
+
+    if (count < entries.size()) {
+        ++count;
+    }
+    return next++;
+}
+
+void LogBuffer::clear() {
+    // Строки не освобождаются, чтобы переиспользовать их память
+    count = 0;
+}
+
+void LogBuffer::format_entry(const Entry& entry, std::string& output) {
+    char timestamp[16] = "--:--:--";
+    std::tm* local = std::localtime(&entry.timestamp);
+    if (local) {
+        std::strftime(timestamp, sizeof(timestamp), "%H:%M:%S", local);
+    }
+
+    output += '[';
+    output += timestamp;
+    output += "] ";
+    output += entry.message;
+}
+
+} // namespace audiocensor
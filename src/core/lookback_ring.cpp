@@ -0,0 +1,70 @@
+#include "audiocensor/lookback_ring.h"
+
+#include <algorithm>
+
+namespace audiocensor {
+
+LookbackRing::LookbackRing(size_t capacity)
+    : data(std::max<size_t>(capacity, 1), 0), end(0), filled(0) {
+}
+
+void LookbackRing::reset(int64_t first_index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    end = first_index;
+    filled = 0;
+}
+
+void LookbackRing::write(const short* samples, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t size = data.size();
+
+    // Из записи длиннее буфера нужен только хвост
+    if (count > size) {
+        if (samples) {
+            samples += count - size;
+        }
+        end += static_cast<int64_t>(count - size);
+        count = size;
+    }
+
+    // Запись в два куска: до конца массива и с его начала
+    size_t position = static_cast<size_t>(end % static_cast<int64_t>(size));
+    size_t first_part = std::min(count, size - position);
+    if (samples) {
+        std::copy(samples, samples + first_part, data.begin() + position);
+        std::copy(samples + first_part, samples + count, data.begin());
+    } else {
+        std::fill(data.begin() + position, data.begin() + position + first_part, 0);
+        std::fill(data.begin(), data.begin() + (count - first_part), 0);
+    }
+
+    end += static_cast<int64_t>(count);
+    filled = std::min(size, filled + count);
+}
+
+bool LookbackRing::read(int64_t first_index, size_t count, short* output) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    int64_t oldest = end - static_cast<int64_t>(filled);
+    if (first_index < oldest || first_index + static_cast<int64_t>(count) > end) {
+        return false;
+    }
+
+    size_t size = data.size();
+    size_t position = static_cast<size_t>(first_index % static_cast<int64_t>(size));
+    size_t first_part = std::min(count, size - position);
+    std::copy(data.begin() + position, data.begin() + position + first_part, output);
+    std::copy(data.begin(), data.begin() + (count - first_part), output + first_part);
+    return true;
+}
+
+int64_t LookbackRing::first_index() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return end - static_cast<int64_t>(filled);
+}
+
+int64_t LookbackRing::end_index() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return end;
+}
+
+} // namespace audiocensor
@@ -0,0 +1,250 @@
+#include "audiocensor/morph_index.h"
+#include "audiocensor/text_normalizer.h"
+
+namespace audiocensor {
+
+namespace {
+
+// Флаги терминального узла дерева основ
+constexpr uint8_t TERMINAL_STEM = 1;       // Основа слова словаря
+constexpr uint8_t TERMINAL_BARE_WORD = 2;  // Основа без окончания тоже является формой слова
+
+// Наибольшее число братьев: по одному на значение байта
+constexpr int MAX_SIBLINGS = 256;
+
+// Падежные, родовые и глагольные окончания, а также частые суффиксы
+// (уменьшительные, возвратные), которые могут стоять перед окончанием
+const char* const RUSSIAN_ENDINGS[] = {
+    // Существительные
+    "а", "я", "о", "е", "ы", "и", "у", "ю", "ь",
+    "ой", "ей", "ом", "ем", "ам", "ям", "ах", "ях", "ами", "ями",
+    "ов", "ев", "ью", "ия", "ие", "ий", "ья", "ье", "ьи", "ьев", "ью",
+    // Прилагательные и причастия
+    "ый", "ая", "яя", "ое", "ее", "ые", "ого", "его", "ому", "ему",
+    "ым", "им", "ую", "юю", "ых", "их", "ыми", "ими",
+    // Глаголы
+    "ть", "ти", "ться", "тся", "ся", "сь", "ет", "ешь", "ете", "ут", "ют",
+    "ит", "ишь", "ите", "ат", "ят", "л", "ла", "ло", "ли", "й", "йте",
+    "ешься", "ется", "ются", "утся", "ится", "ятся", "ал", "ял", "ил", "ел",
+    "ала", "яла", "ила", "ела", "али", "яли", "или", "ели", "ать", "ять", "ить", "еть",
+    "ывать", "ивать", "нуть", "ну", "нул", "нула", "нули",
+    // Суффиксы, после которых может идти окончание
+    "ик", "ок", "ек", "чик", "очк", "ечк", "ушк", "юшк", "к", "ищ", "ск", "ов", "ев", "ан", "ен", "ств"
+};
+
+// Приставки, которые отбрасываются перед поиском основы. Однобуквенных
+// (у, с, о, в) нет: с ними основа находится внутри обычных слов
+const char* const RUSSIAN_PREFIXES[] = {
+    "по", "на", "за", "от", "ото", "вы", "раз", "рас", "разо", "при", "пере", "пре",
+    "до", "об", "обо", "со", "под", "подо", "над", "надо", "про", "недо",
+    "вз", "вс", "из", "ис", "изо", "низ", "нис", "воз", "вос", "без", "бес", "во",
+    "не", "ни", "съ", "объ", "подъ", "отъ", "разъ", "въ"
+};
+
+} // namespace
+
+MorphIndex::MorphIndex()
+    : nodes(nullptr), node_count(0), stem_count(0) {
+    clear();
+}
+
+void MorphIndex::clear() {
+    node_storage.clear();
+    node_storage.resize(ROOT_COUNT, Node{NO_NODE, NO_NODE, 0, 0, 0, 0});
+    nodes = node_storage.data();
+    node_count = node_storage.size();
+    stem_count = 0;
+}
+
+bool MorphIndex::attach(const Node* node_data, size_t nodes_total, size_t stems) {
+    if (!node_data || nodes_total < ROOT_COUNT) {
+        clear();
+        return false;
+    }
+
+    node_storage.clear();
+    node_storage.shrink_to_fit();
+    nodes = node_data;
+    node_count = nodes_total;
+    stem_count = stems;
+    return true;
+}
+
+uint32_t MorphIndex::_child(uint32_t node, uint8_t byte) const {
+    // Индексы могут прийти из файла, поэтому выход за массив считаем отсутствием ребенка.
+    // У братьев разные байты, значит их не больше 256: более длинная цепочка - цикл
+    // в поврежденном файле, и обход прерывается
+    uint32_t child = nodes[node].first_child;
+    for (int siblings = 0; child < node_count && siblings < MAX_SIBLINGS; siblings++) {
+        if (nodes[child].byte == byte) {
+            return child;
+        }
+        child = nodes[child].next_sibling;
+    }
+    return NO_NODE;
+}
+
+bool MorphIndex::_insert(uint32_t root, const std::string& value, uint32_t word_index) {
+    uint32_t node = root;
+    for (unsigned char byte : value) {
+        uint32_t child = _child(node, byte);
+        if (child == NO_NODE) {
+            child = static_cast<uint32_t>(node_storage.size());
+            node_storage.push_back(Node{NO_NODE, node_storage[node].first_child, 0, byte, 0, 0});
+            node_storage[node].first_child = child;
+            nodes = node_storage.data();
+            node_count = node_storage.size();
+        }
+        node = child;
+    }
+
+    bool added = (node_storage[node].terminal & TERMINAL_STEM) == 0;
+    if (added) {
+        node_storage[node].terminal |= TERMINAL_STEM;
+        node_storage[node].word_index = word_index;
+    }
+    return added;
+}
+
+std::string MorphIndex::_stem(const std::string& word) const {
+    // Ищем самое левое начало окончания, оставляющее основу нужной длины
+    size_t letters = 0;
+    for (size_t pos = 0; pos < word.size(); pos++) {
+        if ((static_cast<unsigned char>(word[pos]) & 0xC0) == 0x80) {
+            continue;
+        }
+        if (letters >= MIN_STEM_LETTERS) {
+            uint32_t node = ENDINGS_ROOT;
+            size_t i = pos;
+            while (i < word.size() && node != NO_NODE) {
+                node = _child(node, static_cast<uint8_t>(word[i]));
+                i++;
+            }
+            if (node != NO_NODE && (nodes[node].terminal & TERMINAL_STEM)) {
+                return word.substr(0, pos);
+            }
+        }
+        letters++;
+    }
+    return word;
+}
+
+void MorphIndex::build(const std::vector<std::string>& normalized_words) {
+    clear();
+
+    // Окончания и приставки нормализуются так же, как проверяемые слова
+    std::string normalized;
+    for (const char* ending : RUSSIAN_ENDINGS) {
+        text::normalize_word(ending, normalized);
+        _insert(ENDINGS_ROOT, normalized, 0);
+    }
+    for (const char* prefix : RUSSIAN_PREFIXES) {
+        text::normalize_word(prefix, normalized);
+        _insert(PREFIXES_ROOT, normalized, 0);
+    }
+
+    std::string zero_plural_a;
+    std::string zero_plural_ya;
+    std::string zero_plural_o;
+    text::normalize_word("а", zero_plural_a);
+    text::normalize_word("я", zero_plural_ya);
+    text::normalize_word("о", zero_plural_o);
+
+    for (size_t i = 0; i < normalized_words.size(); i++) {
+        const std::string& word = normalized_words[i];
+        if (text::utf8_length(word) < MIN_STEM_LETTERS) {
+            continue;
+        }
+
+        std::string stem = _stem(word);
+        if (_insert(STEMS_ROOT, stem, static_cast<uint32_t>(i))) {
+            stem_count++;
+        }
+
+        // Голая основа - тоже форма слова, если слово было без окончания
+        // или окончание "нулевое" в родительном падеже множественного числа (собака -> собак)
+        std::string ending = word.substr(stem.size());
+        if (ending.empty() || ending == zero_plural_a || ending == zero_plural_ya || ending == zero_plural_o) {
+            uint32_t node = STEMS_ROOT;
+            for (unsigned char byte : stem) {
+                node = _child(node, byte);
+            }
+            node_storage[node].terminal |= TERMINAL_BARE_WORD;
+        }
+    }
+}
+
+bool MorphIndex::_accepts_tail(const char* data, const char* end, int depth) const {
+    if (data == end) {
+        return true;
+    }
+    if (depth == 0) {
+        return false;
+    }
+
+    uint32_t node = ENDINGS_ROOT;
+    for (const char* p = data; p < end; ) {
+        node = _child(node, static_cast<uint8_t>(*p));
+        if (node == NO_NODE) {
+            return false;
+        }
+        ++p;
+        if ((nodes[node].terminal & TERMINAL_STEM) && _accepts_tail(p, end, depth - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MorphIndex::find(const std::string& normalized_word, uint32_t& word_index) const {
+    if (stem_count == 0 || normalized_word.empty()) {
+        return false;
+    }
+
+    const char* begin = normalized_word.data();
+    const char* end = begin + normalized_word.size();
+
+    // Возможные начала основы: само слово и позиции после каждой подходящей приставки
+    const char* starts[8];
+    size_t start_count = 0;
+    starts[start_count++] = begin;
+
+    uint32_t prefix_node = PREFIXES_ROOT;
+    for (const char* p = begin; p < end && start_count < 8; ) {
+        prefix_node = _child(prefix_node, static_cast<uint8_t>(*p));
+        if (prefix_node == NO_NODE) {
+            break;
+        }
+        ++p;
+        if (nodes[prefix_node].terminal & TERMINAL_STEM) {
+            starts[start_count++] = p;
+        }
+    }
+
+    for (size_t s = 0; s < start_count; s++) {
+        uint32_t node = STEMS_ROOT;
+        for (const char* p = starts[s]; p < end; ) {
+            node = _child(node, static_cast<uint8_t>(*p));
+            if (node == NO_NODE) {
+                break;
+            }
+            ++p;
+
+            uint8_t terminal = nodes[node].terminal;
+            if (!(terminal & TERMINAL_STEM)) {
+                continue;
+            }
+
+            // Голая основа совпадает, только если слово словаря допускает нулевое окончание
+            bool bare = (p == end);
+            if ((bare && (terminal & TERMINAL_BARE_WORD)) || (!bare && _accepts_tail(p, end, 2))) {
+                word_index = nodes[node].word_index;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+} // namespace audiocensor
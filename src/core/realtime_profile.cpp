@@ -0,0 +1,252 @@
+#include "audiocensor/realtime_profile.h"
+#include "audiocensor/constants.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace audiocensor {
+
+namespace {
+
+// Наибольший номер ядра в списке (размер cpu_set_t в Linux)
+#ifdef __linux__
+constexpr int MAX_CPU_INDEX = CPU_SETSIZE - 1;
+#else
+constexpr int MAX_CPU_INDEX = 1023;
+#endif
+
+#ifdef __linux__
+std::string _errno_text(int error) {
+    return std::string(std::strerror(error));
+}
+#endif
+
+} // namespace
+
+RealtimeProfile::RealtimeProfile(const ConfigSnapshot& config)
+    : enabled(config.get("realtime_enabled", "false") == "true"),
+      policy(config.get("realtime_policy", "fifo")),
+      priority(DEFAULT_REALTIME_PRIORITY),
+      cpu_spec(config.get("realtime_cpus")),
+      lock_memory(config.get("realtime_lock_memory", "true") == "true"),
+      memory_locked(false) {
+
+    try {
+        priority = std::stoi(config.get("realtime_priority", std::to_string(DEFAULT_REALTIME_PRIORITY)));
+    } catch (const std::exception&) {
+        priority = DEFAULT_REALTIME_PRIORITY;
+    }
+}
+
+RealtimeProfile::~RealtimeProfile() {
+    release();
+}
+
+bool RealtimeProfile::apply_to_current_thread(std::vector<Step>& steps) {
+    steps.clear();
+    if (!enabled) {
+        return true;
+    }
+
+#ifdef __linux__
+    steps.push_back(_apply_scheduling());
+    if (!cpu_spec.empty()) {
+        steps.push_back(_apply_affinity());
+    }
+    if (lock_memory) {
+        steps.push_back(_lock_memory());
+    }
+#else
+    steps.push_back({false, "профиль реального времени поддерживается только в Linux"});
+#endif
+
+    for (const auto& step : steps) {
+        if (!step.applied) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RealtimeProfile::apply_background_to_current_thread() {
+#ifdef __linux__
+    // Понижение до SCHED_OTHER не требует прав
+    sched_param param{};
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+
+    // Ядра берутся у главного потока процесса: он не закрепляется профилем
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(getpid(), sizeof(set), &set) == 0) {
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+}
+
+void RealtimeProfile::release() {
+#ifdef __linux__
+    if (memory_locked) {
+        munlockall();
+        memory_locked = false;
+    }
+#endif
+}
+
+RealtimeProfile::Step RealtimeProfile::_apply_scheduling() {
+    Step step;
+#ifdef __linux__
+    int sched_policy = policy == "rr" ? SCHED_RR : SCHED_FIFO;
+    const char* policy_name = sched_policy == SCHED_RR ? "SCHED_RR" : "SCHED_FIFO";
+
+    // Приоритет ограничивается допустимым диапазоном политики
+    int min_priority = sched_get_priority_min(sched_policy);
+    int max_priority = sched_get_priority_max(sched_policy);
+    int effective_priority = std::max(min_priority, std::min(priority, max_priority));
+
+    sched_param param{};
+    param.sched_priority = effective_priority;
+    int error = pthread_setschedparam(pthread_self(), sched_policy, &param);
+    if (error == 0) {
+        step.applied = true;
+        step.message = std::string(policy_name) + ", приоритет " + std::to_string(effective_priority);
+    } else if (error == EPERM) {
+        // Без прав на реальное время проверяем лимит, чтобы подсказать причину
+        rlimit limit{};
+        getrlimit(RLIMIT_RTPRIO, &limit);
+        step.message = std::string(policy_name) + " недоступен: нет прав (RLIMIT_RTPRIO=" +
+                       std::to_string(limit.rlim_cur) +
+                       ", нужен CAP_SYS_NICE или rtprio в /etc/security/limits.conf), "
+                       "используется обычный приоритет";
+    } else {
+        step.message = std::string(policy_name) + " недоступен: " + _errno_text(error) +
+                       ", используется обычный приоритет";
+    }
+#endif
+    return step;
+}
+
+RealtimeProfile::Step RealtimeProfile::_apply_affinity() {
+    Step step;
+#ifdef __linux__
+    std::vector<int> cpus;
+    if (!_parse_cpu_list(cpu_spec, cpus)) {
+        step.message = "некорректный список ядер \"" + cpu_spec + "\", привязка к ядрам не выполнена";
+        return step;
+    }
+
+    int cpu_count = static_cast<int>(std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::ostringstream applied;
+    for (int cpu : cpus) {
+        if (cpu >= CPU_SETSIZE || (cpu_count > 0 && cpu >= cpu_count)) {
+            step.message = "ядро " + std::to_string(cpu) + " отсутствует (доступно " +
+                           std::to_string(cpu_count) + "), привязка к ядрам не выполнена";
+            return step;
+        }
+        CPU_SET(cpu, &set);
+        applied << (applied.tellp() > 0 ? "," : "") << cpu;
+    }
+
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error == 0) {
+        step.applied = true;
+        step.message = "поток закреплен за ядрами " + applied.str();
+    } else {
+        step.message = "привязка к ядрам не выполнена: " + _errno_text(error);
+    }
+#endif
+    return step;
+}
+
+RealtimeProfile::Step RealtimeProfile::_lock_memory() {
+    Step step;
+#ifdef __linux__
+    if (memory_locked) {
+        step.applied = true;
+        step.message = "память уже заблокирована";
+        return step;
+    }
+
+    // MCL_FUTURE только без лимита: иначе при исчерпании лимита начнут
+    // отказывать последующие выделения памяти
+    rlimit limit{};
+    getrlimit(RLIMIT_MEMLOCK, &limit);
+    bool unlimited = limit.rlim_cur == RLIM_INFINITY;
+    int flags = unlimited ? (MCL_CURRENT | MCL_FUTURE) : MCL_CURRENT;
+
+    if (mlockall(flags) == 0) {
+        memory_locked = true;
+        step.applied = true;
+        step.message = unlimited ? "память процесса заблокирована (текущая и будущая)"
+                                 : "загруженная память процесса заблокирована";
+    } else {
+        int error = errno;
+        std::string limit_text = unlimited ? "без ограничений"
+                                           : std::to_string(limit.rlim_cur / 1024) + " КБ";
+        step.message = "блокировка памяти не выполнена: " + _errno_text(error) +
+                       " (RLIMIT_MEMLOCK " + limit_text + ", нужен CAP_IPC_LOCK или memlock "
+                       "в /etc/security/limits.conf)";
+    }
+#endif
+    return step;
+}
+
+bool RealtimeProfile::_parse_cpu_list(const std::string& spec, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream stream(spec);
+    std::string item;
+
+    while (std::getline(stream, item, ',')) {
+        // Удаляем пробелы
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+
+        try {
+            size_t dash = item.find('-');
+            if (dash == std::string::npos) {
+                size_t used = 0;
+                int cpu = std::stoi(item, &used);
+                if (used != item.size() || cpu < 0 || cpu > MAX_CPU_INDEX) {
+                    return false;
+                }
+                cpus.push_back(cpu);
+            } else {
+                size_t used_first = 0;
+                size_t used_last = 0;
+                std::string first_text = item.substr(0, dash);
+                std::string last_text = item.substr(dash + 1);
+                int first = std::stoi(first_text, &used_first);
+                int last = std::stoi(last_text, &used_last);
+                if (used_first != first_text.size() || used_last != last_text.size() ||
+                    first < 0 || last < first || last > MAX_CPU_INDEX) {
+                    return false;
+                }
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    return !cpus.empty();
+}
+
+} // namespace audiocensor
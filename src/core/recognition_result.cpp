@@ -0,0 +1,543 @@
+#include "audiocensor/recognition_result.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace audiocensor {
+
+namespace {
+
+// Максимальная вложенность пропускаемых значений
+const int MAX_SKIP_DEPTH = 64;
+
+// Степени 10, которые представимы в double точно
+const double EXACT_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool _is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+int _hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void _append_utf8(std::string& output, uint32_t code_point) {
+    if (code_point < 0x80) {
+        output.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        output.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        output.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        output.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+} // namespace
+
+RecognitionResultParser::RecognitionResultParser(size_t reserve_words)
+    : words(reserve_words),
+      count(0),
+      result_found(false),
+      cursor(nullptr),
+      limit(nullptr),
+      origin(nullptr) {
+
+    // Буферы строк выделяются заранее, чтобы типичные слова не требовали памяти
+    for (auto& word : words) {
+        word.word.reserve(32);
+    }
+    key_buffer.reserve(16);
+    text_value.reserve(256);
+}
+
+bool RecognitionResultParser::parse(const char* data, size_t size) {
+    count = 0;
+    result_found = false;
+    text_value.clear();
+    error_message.clear();
+
+    origin = data;
+    cursor = data;
+    limit = data + size;
+
+    if (!data || size == 0) {
+        return _fail("пустой документ");
+    }
+
+    if (!_parse_document()) {
+        count = 0;
+        return false;
+    }
+    return true;
+}
+
+bool RecognitionResultParser::_parse_document() {
+    _skip_whitespace();
+    if (!_expect('{')) {
+        return _fail("ожидался объект");
+    }
+
+    _skip_whitespace();
+    if (cursor < limit && *cursor == '}') {
+        ++cursor;
+    } else {
+        while (true) {
+            _skip_whitespace();
+            if (!_parse_string(key_buffer)) {
+                return false;
+            }
+            _skip_whitespace();
+            if (!_expect(':')) {
+                return _fail("ожидалось ':'");
+            }
+            _skip_whitespace();
+
+            if (key_buffer == "result" && cursor < limit && *cursor == '[') {
+                result_found = true;
+                if (!_parse_result_array()) {
+                    return false;
+                }
+            } else if (key_buffer == "text" && cursor < limit && *cursor == '"') {
+                if (!_parse_string(text_value)) {
+                    return false;
+                }
+            } else if (!_skip_value()) {
+                return false;
+            }
+
+            _skip_whitespace();
+            if (cursor < limit && *cursor == ',') {
+                ++cursor;
+                continue;
+            }
+            if (!_expect('}')) {
+                return _fail("ожидалось ',' или '}'");
+            }
+            break;
+        }
+    }
+
+    _skip_whitespace();
+    if (cursor != limit) {
+        return _fail("лишние данные после документа");
+    }
+    return true;
+}
+
+bool RecognitionResultParser::_parse_result_array() {
+    ++cursor; // '['
+    _skip_whitespace();
+    if (cursor < limit && *cursor == ']') {
+        ++cursor;
+        return true;
+    }
+
+    while (true) {
+        _skip_whitespace();
+
+        if (cursor < limit && *cursor == '{') {
+            // Запись переиспользуется вместе с буфером строки
+            if (count == words.size()) {
+                words.emplace_back();
+            }
+            RecognizedWord& word = words[count];
+            bool has_word = false;
+            if (!_parse_word_object(word, has_word)) {
+                return false;
+            }
+            if (has_word) {
+                ++count;
+            }
+        } else if (!_skip_value()) {
+            return false;
+        }
+
+        _skip_whitespace();
+        if (cursor < limit && *cursor == ',') {
+            ++cursor;
+            continue;
+        }
+        if (!_expect(']')) {
+            return _fail("ожидалось ',' или ']'");
+        }
+        return true;
+    }
+}
+
+bool RecognitionResultParser::_parse_word_object(RecognizedWord& word, bool& has_word) {
+    ++cursor; // '{'
+    word.word.clear();
+    word.start = 0.0;
+    word.end = 0.0;
+    word.conf = 0.0;
+
+    _skip_whitespace();
+    if (cursor < limit && *cursor == '}') {
+        ++cursor;
+        return true;
+    }
+
+    while (true) {
+        _skip_whitespace();
+        if (!_parse_string(key_buffer)) {
+            return false;
+        }
+        _skip_whitespace();
+        if (!_expect(':')) {
+            return _fail("ожидалось ':'");
+        }
+        _skip_whitespace();
+
+        double* number = nullptr;
+        if (key_buffer == "start") {
+            number = &word.start;
+        } else if (key_buffer == "end") {
+            number = &word.end;
+        } else if (key_buffer == "conf") {
+            number = &word.conf;
+        }
+
+        char next = cursor < limit ? *cursor : '\0';
+        if (key_buffer == "word" && next == '"') {
+            if (!_parse_string(word.word)) {
+                return false;
+            }
+            has_word = true;
+        } else if (number && (next == '-' || _is_digit(next))) {
+            if (!_parse_number(*number)) {
+                return false;
+            }
+        } else if (!_skip_value()) {
+            return false;
+        }
+
+        _skip_whitespace();
+        if (cursor < limit && *cursor == ',') {
+            ++cursor;
+            continue;
+        }
+        if (!_expect('}')) {
+            return _fail("ожидалось ',' или '}'");
+        }
+        return true;
+    }
+}
+
+bool RecognitionResultParser::_parse_string(std::string& output) {
+    output.clear();
+    if (!_expect('"')) {
+        return _fail("ожидалась строка");
+    }
+
+    while (cursor < limit) {
+        // Копируем участок без экранирования целиком
+        const char* run = cursor;
+        while (cursor < limit && *cursor != '"' && *cursor != '\\' &&
+               static_cast<unsigned char>(*cursor) >= 0x20) {
+            ++cursor;
+        }
+        output.append(run, cursor - run);
+
+        if (cursor >= limit) {
+            break;
+        }
+
+        char c = *cursor++;
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\') {
+            return _fail("управляющий символ в строке");
+        }
+        if (cursor >= limit) {
+            break;
+        }
+
+        char escape = *cursor++;
+        switch (escape) {
+            case '"': output.push_back('"'); break;
+            case '\\': output.push_back('\\'); break;
+            case '/': output.push_back('/'); break;
+            case 'b': output.push_back('\b'); break;
+            case 'f': output.push_back('\f'); break;
+            case 'n': output.push_back('\n'); break;
+            case 'r': output.push_back('\r'); break;
+            case 't': output.push_back('\t'); break;
+            case 'u': {
+                uint32_t code_point = 0;
+                for (int i = 0; i < 4; ++i) {
+                    int digit = cursor < limit ? _hex_value(*cursor) : -1;
+                    if (digit < 0) {
+                        return _fail("некорректная последовательность \\u");
+                    }
+                    code_point = (code_point << 4) | static_cast<uint32_t>(digit);
+                    ++cursor;
+                }
+
+                // Суррогатная пара
+                if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                    if (limit - cursor < 6 || cursor[0] != '\\' || cursor[1] != 'u') {
+                        return _fail("непарный суррогат");
+                    }
+                    cursor += 2;
+                    uint32_t low = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        int digit = _hex_value(*cursor);
+                        if (digit < 0) {
+                            return _fail("некорректная последовательность \\u");
+                        }
+                        low = (low << 4) | static_cast<uint32_t>(digit);
+                        ++cursor;
+                    }
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return _fail("непарный суррогат");
+                    }
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+                    return _fail("непарный суррогат");
+                }
+
+                _append_utf8(output, code_point);
+                break;
+            }
+            default:
+                return _fail("некорректная escape-последовательность");
+        }
+    }
+
+    return _fail("незавершенная строка");
+}
+
+bool RecognitionResultParser::_parse_number(double& value) {
+    bool negative = false;
+    if (cursor < limit && *cursor == '-') {
+        negative = true;
+        ++cursor;
+    }
+
+    if (cursor >= limit || !_is_digit(*cursor)) {
+        return _fail("некорректное число");
+    }
+
+    // Мантисса накапливается как целое (до 19 значащих цифр), остальные
+    // цифры целой части учитываются в показателе степени
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+
+    if (*cursor == '0') {
+        ++cursor;
+    } else {
+        while (cursor < limit && _is_digit(*cursor)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*cursor - '0');
+                ++digits;
+            } else {
+                ++exponent;
+            }
+            ++cursor;
+        }
+    }
+
+    if (cursor < limit && *cursor == '.') {
+        ++cursor;
+        if (cursor >= limit || !_is_digit(*cursor)) {
+            return _fail("некорректное число");
+        }
+        while (cursor < limit && _is_digit(*cursor)) {
+            if (digits < 19) {
+                if (mantissa != 0 || *cursor != '0') {
+                    ++digits;
+                }
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*cursor - '0');
+                --exponent;
+            }
+            ++cursor;
+        }
+    }
+
+    if (cursor < limit && (*cursor == 'e' || *cursor == 'E')) {
+        ++cursor;
+        bool exponent_negative = false;
+        if (cursor < limit && (*cursor == '+' || *cursor == '-')) {
+            exponent_negative = *cursor == '-';
+            ++cursor;
+        }
+        if (cursor >= limit || !_is_digit(*cursor)) {
+            return _fail("некорректное число");
+        }
+        int explicit_exponent = 0;
+        while (cursor < limit && _is_digit(*cursor)) {
+            if (explicit_exponent < 10000) {
+                explicit_exponent = explicit_exponent * 10 + (*cursor - '0');
+            }
+            ++cursor;
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+
+    // Для мантиссы до 2^53 и |exponent| <= 22 результат округлен правильно;
+    // таймкоды Vosk ("0.870000") всегда попадают в этот случай
+    double result = static_cast<double>(mantissa);
+    if (exponent != 0 && mantissa != 0) {
+        if (exponent > 0 && exponent <= 22) {
+            result *= EXACT_POWERS_OF_TEN[exponent];
+        } else if (exponent < 0 && exponent >= -22) {
+            result /= EXACT_POWERS_OF_TEN[-exponent];
+        } else {
+            result *= std::pow(10.0, exponent);
+        }
+    }
+
+    value = negative ? -result : result;
+    return true;
+}
+
+bool RecognitionResultParser::_skip_value() {
+    // Вложенность отслеживается стеком скобок фиксированного размера
+    char stack[MAX_SKIP_DEPTH];
+    int depth = 0;
+
+    while (true) {
+        _skip_whitespace();
+        if (cursor >= limit) {
+            return _fail("неожиданный конец документа");
+        }
+
+        // Значение
+        char c = *cursor;
+        if (c == '{' || c == '[') {
+            if (depth == MAX_SKIP_DEPTH) {
+                return _fail("слишком глубокая вложенность");
+            }
+            stack[depth++] = c == '{' ? '}' : ']';
+            ++cursor;
+            _skip_whitespace();
+
+            if (cursor < limit && *cursor == stack[depth - 1]) {
+                ++cursor;
+                --depth;
+            } else {
+                if (c == '{') {
+                    if (!_skip_string()) {
+                        return false;
+                    }
+                    _skip_whitespace();
+                    if (!_expect(':')) {
+                        return _fail("ожидалось ':'");
+                    }
+                }
+                continue;
+            }
+        } else if (c == '"') {
+            if (!_skip_string()) {
+                return false;
+            }
+        } else if (c == '-' || _is_digit(c)) {
+            double ignored;
+            if (!_parse_number(ignored)) {
+                return false;
+            }
+        } else if (limit - cursor >= 4 && std::memcmp(cursor, "true", 4) == 0) {
+            cursor += 4;
+        } else if (limit - cursor >= 4 && std::memcmp(cursor, "null", 4) == 0) {
+            cursor += 4;
+        } else if (limit - cursor >= 5 && std::memcmp(cursor, "false", 5) == 0) {
+            cursor += 5;
+        } else {
+            return _fail("некорректное значение");
+        }
+
+        // Разделители после значения
+        while (true) {
+            if (depth == 0) {
+                return true;
+            }
+            _skip_whitespace();
+            if (cursor >= limit) {
+                return _fail("неожиданный конец документа");
+            }
+            if (*cursor == ',') {
+                ++cursor;
+                if (stack[depth - 1] == '}') {
+                    _skip_whitespace();
+                    if (!_skip_string()) {
+                        return false;
+                    }
+                    _skip_whitespace();
+                    if (!_expect(':')) {
+                        return _fail("ожидалось ':'");
+                    }
+                }
+                break;
+            }
+            if (*cursor != stack[depth - 1]) {
+                return _fail("несогласованные скобки");
+            }
+            ++cursor;
+            --depth;
+        }
+    }
+}
+
+bool RecognitionResultParser::_skip_string() {
+    if (!_expect('"')) {
+        return _fail("ожидалась строка");
+    }
+    while (cursor < limit) {
+        char c = *cursor++;
+        if (c == '"') {
+            return true;
+        }
+        if (c == '\\') {
+            if (cursor >= limit) {
+                break;
+            }
+            ++cursor;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            return _fail("управляющий символ в строке");
+        }
+    }
+    return _fail("незавершенная строка");
+}
+
+bool RecognitionResultParser::_expect(char c) {
+    if (cursor < limit && *cursor == c) {
+        ++cursor;
+        return true;
+    }
+    return false;
+}
+
+void RecognitionResultParser::_skip_whitespace() {
+    while (cursor < limit && (*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t')) {
+        ++cursor;
+    }
+}
+
+bool RecognitionResultParser::_fail(const char* message) {
+    // Сохраняется только первая ошибка
+    if (error_message.empty()) {
+        error_message = message;
+        error_message += " (позиция ";
+        error_message += std::to_string(cursor - origin);
+        error_message += ")";
+    }
+    return false;
+}
+
+} // namespace audiocensor
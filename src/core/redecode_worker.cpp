@@ -0,0 +1,203 @@
+#include "audiocensor/redecode_worker.h"
+#include "audiocensor/lookback_ring.h"
+#include "audiocensor/realtime_profile.h"
+
+#include <vosk_api.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace audiocensor {
+
+RedecodeWorker::RedecodeWorker(std::shared_ptr<VoskModel> model, int sample_rate, const LookbackRing& ring,
+                               size_t max_window, size_t queue_limit, size_t thread_count,
+                               int64_t cycle_samples)
+    : model(std::move(model)), sample_rate(sample_rate), ring(ring),
+      max_window(max_window), queue_limit(std::max<size_t>(queue_limit, 1)),
+      requested_threads(std::max<size_t>(thread_count, 1)), cycle_samples(cycle_samples),
+      running(false), dropped_jobs(0), expired_jobs(0), decoded_jobs(0), decoded_sample_count(0) {
+}
+
+RedecodeWorker::~RedecodeWorker() {
+    stop();
+}
+
+bool RedecodeWorker::start() {
+    if (running || !model) {
+        return false;
+    }
+
+    // Отдельные распознаватели: основной продолжает работу, пока эти заняты окнами
+    decoders.clear();
+    for (size_t i = 0; i < requested_threads; i++) {
+        auto decoder = std::make_unique<Decoder>();
+        if (!_create_recognizer(*decoder)) {
+            std::cerr << "Ошибка создания распознавателя для повторного распознавания" << std::endl;
+            break;
+        }
+
+        // Окно читается в заранее выделенный буфер
+        decoder->window.reserve(max_window);
+        decoders.push_back(std::move(decoder));
+    }
+    if (decoders.empty()) {
+        return false;
+    }
+
+    running = true;
+    for (auto& decoder : decoders) {
+        workers.emplace_back(&RedecodeWorker::_run, this, std::ref(*decoder));
+    }
+    return true;
+}
+
+void RedecodeWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    condition.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+    decoders.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.clear();
+    results.clear();
+}
+
+bool RedecodeWorker::submit(const Job& job) {
+    if (!running || job.count == 0 || job.count > max_window) {
+        dropped_jobs++;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.size() >= queue_limit) {
+            dropped_jobs++;
+            return false;
+        }
+        jobs.push_back(job);
+    }
+    condition.notify_one();
+    return true;
+}
+
+bool RedecodeWorker::take_result(Result& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (results.empty()) {
+        return false;
+    }
+    result = std::move(results.front());
+    results.pop_front();
+    return true;
+}
+
+void RedecodeWorker::_run(Decoder& decoder) {
+    // Пул создается из потока обработки аудио и не должен наследовать его профиль
+    RealtimeProfile::apply_background_to_current_thread();
+
+    Result result;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !running || !jobs.empty(); });
+            if (!running) {
+                return;
+            }
+            job = _take_earliest_job();
+        }
+
+        // Окно уже звучит: результат не успеет заглушить его
+        if (std::chrono::steady_clock::now() >= job.deadline) {
+            expired_jobs++;
+            continue;
+        }
+
+        if (!_decode(decoder, job, result)) {
+            dropped_jobs++;
+            continue;
+        }
+        decoded_jobs++;
+        decoded_sample_count += job.count;
+
+        // Результат, который никто не забирает, вытесняет самый старый
+        std::lock_guard<std::mutex> lock(mutex);
+        if (results.size() >= queue_limit) {
+            results.pop_front();
+            dropped_jobs++;
+        }
+        results.push_back(std::move(result));
+    }
+}
+
+RedecodeWorker::Job RedecodeWorker::_take_earliest_job() {
+    // Очередь короткая (queue_limit), поэтому достаточно линейного поиска
+    auto earliest = std::min_element(jobs.begin(), jobs.end(),
+        [](const Job& a, const Job& b) { return a.deadline < b.deadline; });
+    Job job = std::move(*earliest);
+    jobs.erase(earliest);
+    return job;
+}
+
+bool RedecodeWorker::_decode(Decoder& decoder, const Job& job, Result& result) {
+    // Аудио окна могло быть вытеснено из кольцевого буфера, пока задание ждало очереди
+    decoder.window.resize(job.count);
+    if (!ring.read(job.first_sample, job.count, decoder.window.data())) {
+        return false;
+    }
+
+    // Состояние распознавателя растет за долгую сессию; между окнами фразы нет,
+    // поэтому его можно заменить в любой момент
+    if (cycle_samples > 0 && decoder.samples_fed >= cycle_samples) {
+        _create_recognizer(decoder);
+    }
+
+    // Время результата отсчитывается от создания распознавателя
+    int64_t offset = job.first_sample - decoder.samples_fed;
+    vosk_recognizer_accept_waveform(decoder.recognizer.get(), reinterpret_cast<const char*>(decoder.window.data()),
+                                    static_cast<int>(job.count * sizeof(short)));
+    const char* json = vosk_recognizer_final_result(decoder.recognizer.get());
+    decoder.samples_fed += static_cast<int64_t>(job.count);
+
+    if (!json || !decoder.parser.parse(json, std::strlen(json))) {
+        return false;
+    }
+
+    result.job = job;
+    result.words.clear();
+    for (const auto& word : decoder.parser) {
+        Word mapped;
+        mapped.word = word.word;
+        mapped.first_sample = static_cast<int64_t>(word.start * sample_rate) + offset;
+        mapped.last_sample = static_cast<int64_t>(std::ceil(word.end * sample_rate)) + offset;
+        mapped.conf = word.conf;
+        result.words.push_back(std::move(mapped));
+    }
+    return true;
+}
+
+bool RedecodeWorker::_create_recognizer(Decoder& decoder) {
+    std::shared_ptr<VoskRecognizer> fresh(vosk_recognizer_new(model.get(), static_cast<float>(sample_rate)),
+                                          vosk_recognizer_free);
+    if (!fresh) {
+        return false;
+    }
+    vosk_recognizer_set_words(fresh.get(), 1);
+
+    // Время нового распознавателя начинается с нуля
+    decoder.recognizer = std::move(fresh);
+    decoder.samples_fed = 0;
+    return true;
+}
+
+} // namespace audiocensor
@@ -6,8 +6,13 @@
 #include <sstream>
 #include <iostream>
 #include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
 #include <openssl/sha.h>
 #include <openssl/md5.h>
+#include <openssl/hmac.h>
+#include <openssl/evp.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -19,6 +24,9 @@
 #include <process.h>
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/utsname.h>
 #endif
 
@@ -28,21 +36,262 @@ namespace security {
 // Константы для обфускации
 constexpr unsigned char _XOR_KEY = 0x37;
 
+namespace {
+
+/**
+ * @brief Идентичность файла: пока она не меняется, хеш содержимого не пересчитывается
+ */
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+
+    bool operator==(const FileIdentity& other) const {
+        return device == other.device && inode == other.inode &&
+               size == other.size && mtime == other.mtime;
+    }
+};
+
+bool _file_identity(const std::string& file_path, FileIdentity& identity) {
+#ifdef _WIN32
+    std::wstring wide_path = std::filesystem::u8path(file_path).wstring();
+    HANDLE file = CreateFileW(wide_path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    BY_HANDLE_FILE_INFORMATION info;
+    bool ok = GetFileInformationByHandle(file, &info) != 0;
+    CloseHandle(file);
+    if (!ok) {
+        return false;
+    }
+
+    identity.device = info.dwVolumeSerialNumber;
+    identity.inode = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    identity.size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    identity.mtime = static_cast<int64_t>((static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                                          info.ftLastWriteTime.dwLowDateTime);
+    return true;
+#else
+    struct stat info;
+    if (::stat(file_path.c_str(), &info) != 0) {
+        return false;
+    }
+
+    identity.device = static_cast<uint64_t>(info.st_dev);
+    identity.inode = static_cast<uint64_t>(info.st_ino);
+    identity.size = static_cast<uint64_t>(info.st_size);
+#ifdef __APPLE__
+    identity.mtime = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    identity.mtime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    return true;
+#endif
+}
+
+std::string _digest_to_hex(const unsigned char* digest, unsigned int length) {
+    std::stringstream ss;
+    for (unsigned int i = 0; i < length; i++) {
+        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+    }
+    return ss.str();
+}
+
+/**
+ * @brief Хеширует отображенный в память файл одним вызовом EVP_Digest
+ * @return false если файл не удалось отобразить (хеш тогда считается чтением)
+ */
+bool _hash_mapped_file(const std::string& file_path, std::string& hash) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length = 0;
+    bool ok = false;
+
+#ifdef _WIN32
+    std::wstring wide_path = std::filesystem::u8path(file_path).wstring();
+    HANDLE file = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view) {
+                ok = EVP_Digest(view, static_cast<size_t>(file_size.QuadPart),
+                                digest, &digest_length, EVP_sha256(), nullptr) == 1;
+                UnmapViewOfFile(view);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        size_t size = static_cast<size_t>(info.st_size);
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            madvise(view, size, MADV_SEQUENTIAL);
+            ok = EVP_Digest(view, size, digest, &digest_length, EVP_sha256(), nullptr) == 1;
+            munmap(view, size);
+        }
+    }
+    ::close(fd);
+#endif
+
+    if (ok) {
+        hash = _digest_to_hex(digest, digest_length);
+    }
+    return ok;
+}
+
+/**
+ * @brief Хеширует файл последовательным чтением (для файлов, которые нельзя отобразить)
+ */
+std::string _hash_streamed_file(const std::string& file_path, size_t block_size) {
+    std::ifstream file(std::filesystem::u8path(file_path), std::ios::binary);
+    if (!file) {
+        return "";
+    }
+
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    if (!context || EVP_DigestInit_ex(context, EVP_sha256(), nullptr) != 1) {
+        EVP_MD_CTX_free(context);
+        return "";
+    }
+
+    std::vector<char> buffer(block_size > 0 ? block_size : 65536);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize count = file.gcount();
+        if (count > 0) {
+            EVP_DigestUpdate(context, buffer.data(), static_cast<size_t>(count));
+        }
+    }
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length = 0;
+    bool ok = EVP_DigestFinal_ex(context, digest, &digest_length) == 1;
+    EVP_MD_CTX_free(context);
+
+    return ok ? _digest_to_hex(digest, digest_length) : "";
+}
+
+/**
+ * @brief Хеширует файл без запоминания результата
+ */
+std::string _hash_file(const std::string& file_path, size_t block_size) {
+    std::string hash;
+    if (!_hash_mapped_file(file_path, hash)) {
+        hash = _hash_streamed_file(file_path, block_size);
+    }
+    return hash;
+}
+
+/**
+ * @brief Фоновая проверка исполняемого файла
+ *
+ * Первый хеш, посчитанный за время работы, считается эталоном. Повторно файл
+ * хешируется, только если изменились устройство, inode, размер или время
+ * изменения; до этого проверка стоит одного stat.
+ *
+ * Монитор - статический объект, а его поток может работать при завершении
+ * программы, поэтому поток использует только поля монитора (а не общий кэш
+ * calculate_file_hash, который может быть разрушен раньше монитора).
+ */
+class IntegrityMonitor {
+public:
+    ~IntegrityMonitor() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    bool check() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (executable_path.empty()) {
+            executable_path = get_executable_path();
+            if (executable_path.empty()) {
+                return intact;
+            }
+        }
+
+        FileIdentity identity;
+        if (!_file_identity(executable_path, identity)) {
+            return intact;
+        }
+
+        // Файл не менялся или уже хешируется: отвечаем по последнему результату
+        if ((checked && identity == checked_identity) || running) {
+            return intact;
+        }
+
+        if (worker.joinable()) {
+            worker.join();
+        }
+
+        running = true;
+        worker = std::thread([this, identity]() {
+            std::string hash = _hash_file(executable_path, 65536);
+
+            std::lock_guard<std::mutex> worker_lock(mutex);
+            if (!hash.empty()) {
+                if (reference_hash.empty()) {
+                    reference_hash = hash;
+                } else if (hash != reference_hash) {
+                    intact = false;
+                }
+            }
+            checked_identity = identity;
+            checked = true;
+            running = false;
+        });
+
+        return intact;
+    }
+
+private:
+    std::mutex mutex;
+    std::thread worker;
+    std::string executable_path;
+    std::string reference_hash;
+    FileIdentity checked_identity;
+    bool checked = false;
+    bool running = false;
+    bool intact = true;
+};
+
+} // namespace
+
 std::string obscure_str(const std::string& s) {
     if (s.empty()) {
         return "";
     }
     
-    std::string result;
-    result.reserve(s.size());
-    
-    for (char c : s) {
-        result.push_back(static_cast<char>(c ^ _XOR_KEY));
-    }
-    
+    std::string result = s;
+    obscure_bytes(&result[0], result.size());
     return result;
 }
 
+void obscure_bytes(char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        data[i] = static_cast<char>(data[i] ^ _XOR_KEY);
+    }
+}
+
 std::string deobscure_str(const std::string& s) {
     // XOR операция симметрична, поэтому используем ту же функцию
     return obscure_str(s);
@@ -132,47 +381,54 @@ std::string sha256_hash(const std::string& str) {
 }
 
 std::string calculate_file_hash(const std::string& file_path, size_t block_size) {
-    std::ifstream file(file_path, std::ios::binary);
-    if (!file) {
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, std::pair<FileIdentity, std::string>> cache;
+
+    FileIdentity identity;
+    if (!_file_identity(file_path, identity)) {
         return "";
     }
-    
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    
-    std::vector<char> buffer(block_size);
-    while (file) {
-        file.read(buffer.data(), block_size);
-        std::streamsize count = file.gcount();
-        if (count > 0) {
-            SHA256_Update(&sha256, buffer.data(), count);
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = cache.find(file_path);
+        if (it != cache.end() && it->second.first == identity) {
+            return it->second.second;
         }
     }
-    
-    unsigned char digest[SHA256_DIGEST_LENGTH];
-    SHA256_Final(digest, &sha256);
-    
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+
+    std::string hash = _hash_file(file_path, block_size);
+    if (!hash.empty()) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        cache[file_path] = std::make_pair(identity, hash);
     }
-    
-    return ss.str();
+    return hash;
 }
 
-bool check_executable_integrity() {
-    try {
-        if (is_running_as_executable()) {
+std::string get_executable_path() {
+    static const std::string executable_path = []() -> std::string {
 #ifdef _WIN32
-            TCHAR szFileName[MAX_PATH];
-            GetModuleFileName(NULL, szFileName, MAX_PATH);
-            // Здесь в реальном коде нужно сравнивать с предварительно сохраненным хешем
-            // В демо-версии просто возвращаем true
-            return true;
+        wchar_t buffer[MAX_PATH];
+        DWORD length = GetModuleFileNameW(NULL, buffer, MAX_PATH);
+        if (length == 0 || length >= MAX_PATH) {
+            return "";
+        }
+        return std::filesystem::path(std::wstring(buffer, length)).u8string();
 #else
-            // Для Linux упрощено
-            return true;
+        char buffer[PATH_MAX];
+        ssize_t count = readlink("/proc/self/exe", buffer, sizeof(buffer));
+        return count > 0 ? std::string(buffer, static_cast<size_t>(count)) : "";
 #endif
+    }();
+    return executable_path;
+}
+
+bool check_executable_integrity() {
+    try {
+        if (is_running_as_executable()) {
+            // Хеш считается в фоне, вызывающий поток не ждет чтения файла
+            static IntegrityMonitor monitor;
+            return monitor.check();
         }
     } catch (...) {
         // При ошибке в безопасном режиме считаем, что все ОК
@@ -180,7 +436,26 @@ bool check_executable_integrity() {
     return true;
 }
 
-std::string get_hardware_salt() {
+std::string hmac_sha256(const std::string& key, const std::string& data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length = 0;
+    if (!HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+              reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+              digest, &digest_length)) {
+        return "";
+    }
+    
+    std::stringstream ss;
+    for (unsigned int i = 0; i < digest_length; i++) {
+        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+    }
+    
+    return ss.str();
+}
+
+namespace {
+
+std::string _compute_hardware_salt() {
     try {
         std::vector<std::string> salt_components;
         
@@ -221,7 +496,7 @@ std::string get_hardware_salt() {
     }
 }
 
-std::string get_machine_id() {
+std::string _compute_machine_id() {
     std::vector<std::string> machine_data;
 
 #ifdef _WIN32
@@ -264,6 +539,19 @@ std::string get_machine_id() {
     return sha256_hash(salted_id);
 }
 
+} // namespace
+
+std::string get_hardware_salt() {
+    // Аппаратные характеристики не меняются за время работы
+    static const std::string salt = _compute_hardware_salt();
+    return salt;
+}
+
+std::string get_machine_id() {
+    static const std::string machine_id = _compute_machine_id();
+    return machine_id;
+}
+
 bool validate_environment() {
     // Добавляем случайную задержку для защиты от анализа
     add_random_delay(10, 50);
@@ -0,0 +1,133 @@
+#include "audiocensor/silence_compressor.h"
+#include "audiocensor/constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace audiocensor {
+
+namespace {
+
+// Кадр анализа и переход на стыке, мс
+constexpr int FRAME_MS = 10;
+constexpr int CROSSFADE_MS = 2;
+
+int _config_int(const ConfigSnapshot& config, const std::string& key, int default_value) {
+    try {
+        return std::stoi(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+} // namespace
+
+SilenceCompressor::SilenceCompressor(const ConfigSnapshot& config, int sample_rate)
+    : enabled(config.get("catchup_enabled", "true") == "true"),
+      frame_size(std::max<size_t>(1, static_cast<size_t>(sample_rate) * FRAME_MS / 1000)),
+      crossfade_size(static_cast<size_t>(sample_rate) * CROSSFADE_MS / 1000),
+      min_excess(0),
+      max_drop_percent(std::max(0, std::min(100, _config_int(config, "catchup_max_drop_percent",
+                                                             DEFAULT_CATCHUP_MAX_DROP_PERCENT)))),
+      silence_power(0.0),
+      previous_silent(false),
+      dropped_total(0) {
+
+    int min_excess_ms = std::max(0, _config_int(config, "catchup_min_excess_ms", DEFAULT_CATCHUP_MIN_EXCESS_MS));
+    min_excess = static_cast<size_t>(sample_rate) * min_excess_ms / 1000;
+
+    // Порог в dBFS переводится в средний квадрат сэмпла, чтобы не извлекать корень
+    int silence_db = _config_int(config, "catchup_silence_db", DEFAULT_CATCHUP_SILENCE_DB);
+    double threshold = 32768.0 * std::pow(10.0, silence_db / 20.0);
+    silence_power = threshold * threshold;
+}
+
+void SilenceCompressor::reset() {
+    previous_silent = false;
+    dropped_total = 0;
+}
+
+size_t SilenceCompressor::drop_budget(size_t buffered, size_t target, size_t chunk_size) const {
+    if (!enabled || buffered <= target + min_excess || buffered <= chunk_size) {
+        return 0;
+    }
+
+    // Выбрасываются только целые кадры
+    size_t budget = std::min(buffered - target, chunk_size * max_drop_percent / 100);
+    budget = std::min(budget, buffered - chunk_size);
+    return budget / frame_size * frame_size;
+}
+
+size_t SilenceCompressor::compress(const short* input, size_t count, short* output,
+                                   size_t output_count, size_t max_drop) {
+    size_t position = 0;
+    size_t written = 0;
+    size_t dropped = 0;
+    bool cut_pending = false;
+    bool silent_before = previous_silent;
+
+    // Тишина следующего кадра нужна для решения по текущему, результат переиспользуется
+    bool next_known = false;
+    bool next_silent = false;
+
+    while (written < output_count && position < count) {
+        size_t length = std::min(frame_size, count - position);
+        bool silent = next_known ? next_silent : _is_silent(input + position, length);
+
+        next_known = position + length + frame_size <= count;
+        next_silent = next_known && _is_silent(input + position + length, frame_size);
+
+        // Кадр выбрасывается только в окружении тихих кадров
+        if (silent && silent_before && next_silent && length == frame_size &&
+            dropped + length <= max_drop) {
+            position += length;
+            dropped += length;
+            cut_pending = true;
+            continue;
+        }
+
+        // Стык после выброшенных кадров: конец записанного плавно переходит
+        // в сэмплы, которые шли перед продолжением
+        if (cut_pending) {
+            size_t fade = std::min(crossfade_size, std::min(written, position));
+            for (size_t k = 0; k < fade; k++) {
+                float weight = static_cast<float>(k + 1) / static_cast<float>(fade + 1);
+                size_t index = written - fade + k;
+                float value = (1.0f - weight) * output[index] + weight * input[position - fade + k];
+                output[index] = static_cast<short>(std::lround(value));
+            }
+            cut_pending = false;
+        }
+
+        size_t take = std::min(length, output_count - written);
+        std::copy(input + position, input + position + take, output + written);
+        position += take;
+        written += take;
+        silent_before = silent;
+
+        // Чанк закончился на середине кадра: решение по следующему кадру не годится
+        if (take < length) {
+            next_known = false;
+        }
+    }
+
+    previous_silent = silent_before;
+    dropped_total += dropped;
+    return position;
+}
+
+bool SilenceCompressor::_is_silent(const short* frame, size_t length) const {
+    if (length == 0) {
+        return false;
+    }
+
+    double energy = 0.0;
+    for (size_t i = 0; i < length; i++) {
+        double sample = frame[i];
+        energy += sample * sample;
+    }
+    return energy / static_cast<double>(length) < silence_power;
+}
+
+} // namespace audiocensor
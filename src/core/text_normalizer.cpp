@@ -0,0 +1,263 @@
+#include "audiocensor/text_normalizer.h"
+
+#include <cstring>
+
+namespace audiocensor {
+namespace text {
+
+namespace {
+
+// Признак некорректного байта: такой байт копируется в результат без изменений
+constexpr uint32_t INVALID_BYTE_FLAG = 0x80000000u;
+
+// Кириллический блок U+0400..U+045F покрывает весь русский алфавит
+constexpr uint32_t CYRILLIC_FIRST = 0x0400;
+constexpr uint32_t CYRILLIC_LAST = 0x045F;
+
+struct FoldTables {
+    uint32_t ascii_normalize[128];
+    uint16_t cyrillic_lower[CYRILLIC_LAST - CYRILLIC_FIRST + 1];
+    uint16_t cyrillic_normalize[CYRILLIC_LAST - CYRILLIC_FIRST + 1];
+};
+
+constexpr FoldTables make_fold_tables() {
+    FoldTables tables{};
+
+    // ASCII: нижний регистр и латинские двойники кириллических букв
+    for (uint32_t c = 0; c < 128; c++) {
+        uint32_t lower = (c >= 'A' && c <= 'Z') ? c + 0x20 : c;
+        tables.ascii_normalize[c] = lower;
+    }
+    const char homoglyphs_latin[] = "aceopxykmthb";
+    const uint32_t homoglyphs_cyrillic[] = {
+        0x0430, 0x0441, 0x0435, 0x043E, 0x0440, 0x0445,  // а с е о р х
+        0x0443, 0x043A, 0x043C, 0x0442, 0x043D, 0x0432   // у к м т н в
+    };
+    for (int i = 0; homoglyphs_latin[i] != '\0'; i++) {
+        uint32_t lower = static_cast<uint32_t>(homoglyphs_latin[i]);
+        tables.ascii_normalize[lower] = homoglyphs_cyrillic[i];
+        tables.ascii_normalize[lower - 0x20] = homoglyphs_cyrillic[i];
+    }
+
+    // Кириллица: Ѐ..Џ -> ѐ..џ, А..Я -> а..я
+    for (uint32_t cp = CYRILLIC_FIRST; cp <= CYRILLIC_LAST; cp++) {
+        uint32_t lower = cp;
+        if (cp < 0x0410) {
+            lower = cp + 0x50;
+        } else if (cp < 0x0430) {
+            lower = cp + 0x20;
+        }
+        tables.cyrillic_lower[cp - CYRILLIC_FIRST] = static_cast<uint16_t>(lower);
+
+        // ё и ѐ сравниваем как е
+        uint32_t normalized = (lower == 0x0451 || lower == 0x0450) ? 0x0435 : lower;
+        tables.cyrillic_normalize[cp - CYRILLIC_FIRST] = static_cast<uint16_t>(normalized);
+    }
+
+    return tables;
+}
+
+constexpr FoldTables fold_tables = make_fold_tables();
+
+inline bool is_space(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Проверяет, что все 8 байт блока - ASCII
+inline bool load_ascii_block(const unsigned char* p, uint64_t& block) {
+    std::memcpy(&block, p, sizeof(block));
+    return (block & 0x8080808080808080ULL) == 0;
+}
+
+// Переводит 'A'..'Z' в нижний регистр во всех 8 байтах сразу (SWAR)
+inline uint64_t ascii_lower_block(uint64_t block) {
+    uint64_t above_z = block + 0x2525252525252525ULL;      // старший бит, если байт > 'Z'
+    uint64_t from_a = block + 0x3F3F3F3F3F3F3F3FULL;       // старший бит, если байт >= 'A'
+    uint64_t is_upper = (from_a ^ above_z) & 0x8080808080808080ULL;
+    return block | (is_upper >> 2);
+}
+
+inline uint32_t normalize_code_point(uint32_t cp) {
+    if (cp < 128) {
+        return fold_tables.ascii_normalize[cp];
+    }
+    if (cp >= CYRILLIC_FIRST && cp <= CYRILLIC_LAST) {
+        return fold_tables.cyrillic_normalize[cp - CYRILLIC_FIRST];
+    }
+    return cp;
+}
+
+inline uint32_t lower_code_point(uint32_t cp) {
+    if (cp < 128) {
+        return (cp >= 'A' && cp <= 'Z') ? cp + 0x20 : cp;
+    }
+    if (cp >= CYRILLIC_FIRST && cp <= CYRILLIC_LAST) {
+        return fold_tables.cyrillic_lower[cp - CYRILLIC_FIRST];
+    }
+    return cp;
+}
+
+} // namespace
+
+size_t decode_utf8(const unsigned char* data, const unsigned char* end, uint32_t& code_point) {
+    unsigned char lead = data[0];
+    if (lead < 0x80) {
+        code_point = lead;
+        return 1;
+    }
+
+    size_t length;
+    uint32_t cp;
+    if ((lead & 0xE0) == 0xC0 && lead >= 0xC2) {
+        length = 2;
+        cp = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        cp = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0 && lead <= 0xF4) {
+        length = 4;
+        cp = lead & 0x07;
+    } else {
+        code_point = INVALID_BYTE_FLAG | lead;
+        return 1;
+    }
+
+    if (static_cast<size_t>(end - data) < length) {
+        code_point = INVALID_BYTE_FLAG | lead;
+        return 1;
+    }
+
+    for (size_t i = 1; i < length; i++) {
+        if ((data[i] & 0xC0) != 0x80) {
+            code_point = INVALID_BYTE_FLAG | lead;
+            return 1;
+        }
+        cp = (cp << 6) | (data[i] & 0x3F);
+    }
+
+    code_point = cp;
+    return length;
+}
+
+void append_utf8(uint32_t code_point, std::string& output) {
+    if (code_point & INVALID_BYTE_FLAG) {
+        output.push_back(static_cast<char>(code_point & 0xFF));
+    } else if (code_point < 0x80) {
+        output.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        output.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        output.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        output.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+size_t normalize_word(const char* data, size_t size, std::string& output) {
+    output.clear();
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+
+    // Убираем пробелы в начале и конце
+    while (p < end && is_space(*p)) {
+        ++p;
+    }
+    while (end > p && is_space(end[-1])) {
+        --end;
+    }
+
+    // Латинский двойник превращается в двухбайтовую кириллицу, поэтому
+    // удвоенного размера всегда достаточно и дальше буфер не растет
+    size_t max_output = static_cast<size_t>(end - p) * 2;
+    if (output.capacity() < max_output) {
+        output.reserve(max_output);
+    }
+
+    size_t count = 0;
+    uint32_t prev = 0;
+
+    auto emit = [&](uint32_t cp) {
+        // Схлопываем повторы одной и той же буквы
+        if (cp == prev) {
+            return;
+        }
+        prev = cp;
+        append_utf8(cp, output);
+        count++;
+    };
+
+    while (p < end) {
+        // Быстрый путь: 8 байт ASCII подряд не требуют декодирования UTF-8
+        uint64_t block;
+        if (end - p >= 8 && load_ascii_block(p, block)) {
+            for (int i = 0; i < 8; i++) {
+                emit(fold_tables.ascii_normalize[p[i]]);
+            }
+            p += 8;
+            continue;
+        }
+
+        uint32_t cp;
+        p += decode_utf8(p, end, cp);
+        emit(normalize_code_point(cp));
+    }
+
+    return count;
+}
+
+size_t normalize_word(const std::string& word, std::string& output) {
+    return normalize_word(word.data(), word.size(), output);
+}
+
+size_t fold_case(const std::string& word, std::string& output) {
+    output.clear();
+    if (output.capacity() < word.size()) {
+        output.reserve(word.size());
+    }
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(word.data());
+    const unsigned char* end = p + word.size();
+    size_t count = 0;
+
+    while (p < end) {
+        // Быстрый путь: 8 байт ASCII переводятся в нижний регистр за одну операцию
+        uint64_t block;
+        if (end - p >= 8 && load_ascii_block(p, block)) {
+            block = ascii_lower_block(block);
+            char bytes[8];
+            std::memcpy(bytes, &block, sizeof(block));
+            output.append(bytes, sizeof(bytes));
+            p += 8;
+            count += 8;
+            continue;
+        }
+
+        uint32_t cp;
+        p += decode_utf8(p, end, cp);
+        append_utf8(lower_code_point(cp), output);
+        count++;
+    }
+
+    return count;
+}
+
+size_t utf8_length(const std::string& word) {
+    size_t count = 0;
+    for (unsigned char c : word) {
+        // Считаем все байты, кроме продолжений многобайтовых последовательностей
+        if ((c & 0xC0) != 0x80) {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace text
+} // namespace audiocensor
@@ -1,8 +1,8 @@
 #include "audiocensor/word_detector.h"
 #include "audiocensor/security.h"
+#include "audiocensor/constants.h"
+#include "audiocensor/text_normalizer.h"
 
-#include <nlohmann/json.hpp>
-#include <openssl/md5.h>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -11,14 +11,83 @@
 
 namespace audiocensor {
 
-using json = nlohmann::json;
-
 WordDetector::WordDetector(const std::unordered_map<std::string, std::string>& config)
     : config(config),
+      cache(config.find("detection_cache_size") != config.end()
+                ? std::stoul(config.at("detection_cache_size"))
+                : DEFAULT_DETECTION_CACHE_SIZE),
       detection_count(0),
+      _dictionary_generation(0),
+      _fuzzy_enabled(config.find("fuzzy_matching") != config.end() &&
+                     config.at("fuzzy_matching") == "true"),
+      _fuzzy_max_distance(config.find("fuzzy_max_distance") != config.end()
+                              ? std::stoi(config.at("fuzzy_max_distance"))
+                              : DEFAULT_FUZZY_MAX_DISTANCE),
+      _morphology_enabled(config.find("morphology") != config.end() &&
+                          config.at("morphology") == "true"),
       _last_check_time(std::chrono::system_clock::now()),
       _throttle_attempts(0),
       _throttle_start_time(std::chrono::system_clock::now()) {
+
+    // Списки из конфигурации (через запятую) компилируются один раз
+    std::vector<std::string> config_patterns;
+    std::vector<std::string> config_words;
+
+    if (config.find("target_patterns") != config.end()) {
+        std::istringstream iss(config.at("target_patterns"));
+        std::string pattern;
+        while (std::getline(iss, pattern, ',')) {
+            config_patterns.push_back(pattern);
+        }
+    }
+
+    if (config.find("target_words") != config.end()) {
+        std::istringstream iss(config.at("target_words"));
+        std::string word;
+        while (std::getline(iss, word, ',')) {
+            config_words.push_back(word);
+        }
+    }
+
+    if (!config_patterns.empty() || !config_words.empty()) {
+        _update_dictionary(config_patterns, config_words);
+    }
+}
+
+void WordDetector::set_dictionary(std::shared_ptr<const CompiledDictionary> dictionary) {
+    // Снимок собирается целиком до публикации, поток проверок его не ждет
+    auto snapshot = std::make_shared<DictionarySnapshot>();
+    snapshot->dictionary = std::move(dictionary);
+    snapshot->generation = ++_dictionary_generation;
+
+    size_t pattern_count = snapshot->dictionary ? snapshot->dictionary->pattern_count() : 0;
+    snapshot->patterns.reserve(pattern_count);
+    snapshot->pattern_sources.reserve(pattern_count);
+
+    for (size_t i = 0; i < pattern_count; i++) {
+        std::string pattern_str(snapshot->dictionary->pattern(i));
+        try {
+            snapshot->patterns.emplace_back(pattern_str, std::regex::optimize);
+            snapshot->pattern_sources.push_back(pattern_str);
+        } catch (const std::regex_error& e) {
+            // В случае ошибки в регулярном выражении, пропускаем его
+            std::cerr << "Ошибка в регулярном выражении " << pattern_str << ": " << e.what() << std::endl;
+        }
+    }
+
+    std::shared_ptr<const DictionarySnapshot> published = std::move(snapshot);
+    std::shared_ptr<const DictionarySnapshot> previous;
+    {
+        std::lock_guard<std::mutex> lock(_publish_mutex);
+        previous = std::atomic_exchange(&_snapshot, published);
+        // Снимок, вытесненный прошлой публикацией, освобождается здесь, а не в потоке проверок
+        std::swap(previous, _retired_snapshot);
+    }
+}
+
+std::shared_ptr<const CompiledDictionary> WordDetector::get_dictionary() const {
+    auto snapshot = std::atomic_load(&_snapshot);
+    return snapshot ? snapshot->dictionary : nullptr;
 }
 
 std::vector<std::tuple<int, int, bool>> WordDetector::process_recognition_result(
@@ -34,16 +103,13 @@ std::vector<std::tuple<int, int, bool>> WordDetector::process_recognition_result
     }
 
     try {
-        // Парсим JSON
-        json result = json::parse(result_json);
-
-        // Проверяем наличие поля "result"
-        if (!result.contains("result") || !result["result"].is_array()) {
+        // Разбираем JSON без построения дерева; элементы без поля "word" отбрасываются
+        if (!_result_parser.parse(result_json)) {
+            std::cerr << "Ошибка при разборе JSON: " << _result_parser.error() << std::endl;
             return censored_regions;
         }
 
-        auto words = result["result"];
-        if (words.empty()) {
+        if (_result_parser.empty()) {
             return censored_regions;
         }
 
@@ -70,50 +136,24 @@ std::vector<std::tuple<int, int, bool>> WordDetector::process_recognition_result
         double chunks_per_second = static_cast<double>(current_sample_rate) / chunk_size;
 
         // Обрабатываем каждое слово
-        for (const auto& word : words) {
-            // Проверяем формат данных
-            if (!word.contains("word") || !word["word"].is_string()) {
-                continue;
-            }
-
-            std::string word_text = word["word"];
-            std::transform(word_text.begin(), word_text.end(), word_text.begin(),
-                           [](unsigned char c){ return std::tolower(c); });
+        for (const auto& word : _result_parser) {
+            size_t letters = text::fold_case(word.word, _folded_buffer);
 
             // Пропускаем слишком короткие слова как шум
-            if (word_text.length() < 3) {
+            if (letters < 3) {
                 continue;
             }
-
-            // Получаем внешние списки паттернов и слов
-            std::vector<std::string> patterns;
-            std::vector<std::string> target_words;
-
-            if (config.find("target_patterns") != config.end()) {
-                std::istringstream iss(config.at("target_patterns"));
-                std::string pattern;
-                while (std::getline(iss, pattern, ',')) {
-                    patterns.push_back(pattern);
-                }
-            }
-
-            if (config.find("target_words") != config.end()) {
-                std::istringstream iss(config.at("target_words"));
-                std::string tw;
-                while (std::getline(iss, tw, ',')) {
-                    target_words.push_back(tw);
-                }
-            }
+            const std::string& word_text = _folded_buffer;
 
             // Проверяем, является ли слово запрещенным
             bool is_prohibited;
             std::string matched_pattern;
-            std::tie(is_prohibited, matched_pattern) = is_prohibited_word(word_text, patterns, target_words);
+            std::tie(is_prohibited, matched_pattern) = is_prohibited_word(word_text);
 
             if (is_prohibited) {
                 // Получаем время начала и конца слова
-                double start_time = word.contains("start") && word["start"].is_number() ? word["start"].get<double>() : 0;
-                double end_time = word.contains("end") && word["end"].is_number() ? word["end"].get<double>() : 0;
+                double start_time = word.start;
+                double end_time = word.end;
 
                 // Рассчитываем индексы чанков для цензуры с учетом текущей частоты дискретизации
                 int chunks_offset_start = static_cast<int>((start_time - (elapsed_time - buffer_delay)) *
@@ -130,8 +170,6 @@ std::vector<std::tuple<int, int, bool>> WordDetector::process_recognition_result
             }
         }
 
-    } catch (const json::parse_error& e) {
-        std::cerr << "Ошибка при разборе JSON: " << e.what() << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "Ошибка при обработке результатов распознавания: " << e.what() << std::endl;
     }
@@ -139,63 +177,38 @@ std::vector<std::tuple<int, int, bool>> WordDetector::process_recognition_result
     return censored_regions;
 }
 
-std::string WordDetector::_normalize_word(const std::string& word) {
-    if (word.empty()) {
-        return "";
-    }
+size_t WordDetector::_normalize_word(const std::string& word, std::string& output) {
+    return text::normalize_word(word, output);
+}
 
-    // Преобразуем к нижнему регистру и убираем пробелы в начале и конце
-    std::string normalized = word;
-    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
-                   [](unsigned char c){ return std::tolower(c); });
-
-    // Убираем пробелы в начале и конце
-    normalized.erase(0, normalized.find_first_not_of(" \t\r\n"));
-    normalized.erase(normalized.find_last_not_of(" \t\r\n") + 1);
-
-    // Убираем повторяющиеся символы (например, "приииивет" -> "привет")
-    std::string result;
-    char prev_char = '\0';
-
-    for (char c : normalized) {
-        if (c != prev_char) {
-            result += c;
-            prev_char = c;
-        } else {
-            // Проверяем, является ли символ гласной - заменим многосимвольные константы на одиночные символы
-            bool is_vowel = (c == '\xD0\xB0' || c == '\xD0\xB5' || c == '\xD0\xB8' || c == '\xD0\xBE' || c == '\xD1\x83' ||
-                             c == '\xD1\x8B' || c == '\xD1\x8D' || c == '\xD1\x8E' || c == '\xD1\x8F');
-
-            // Позволяем повторение гласных
-            if (is_vowel) {
-                result += c;
-            }
-        }
-    }
+void WordDetector::_folded_word(const std::string& word, std::string& output) {
+    text::fold_case(word, output);
 
-    return result;
+    // Убираем пробелы по краям без выделения памяти
+    size_t last = output.find_last_not_of(" \t\r\n");
+    output.erase(last == std::string::npos ? 0 : last + 1);
+    output.erase(0, output.find_first_not_of(" \t\r\n"));
 }
 
-std::string WordDetector::_generate_cache_key(
-    const std::string& word_text,
+uint64_t WordDetector::_generate_cache_key(const std::string& word_text, uint64_t generation) const {
+    // Ключ зависит от поколения словаря, поэтому смена словаря не требует очистки кэша
+    return DetectionCache::make_key(word_text, generation);
+}
+
+void WordDetector::_update_dictionary(
     const std::vector<std::string>& patterns,
     const std::vector<std::string>& target_words) {
 
-    // Хешируем слово для уникальности
-    unsigned char md[MD5_DIGEST_LENGTH];
-    MD5(reinterpret_cast<const unsigned char*>(word_text.c_str()), word_text.length(), md);
-
-    std::stringstream ss;
-    for (int i = 0; i < MD5_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(md[i]);
+    uint64_t fingerprint = CompiledDictionary::fingerprint(target_words, patterns);
+    auto current = get_dictionary();
+    if (current && current->get_fingerprint() == fingerprint) {
+        return;
     }
-    std::string word_hash = ss.str();
 
-    // Генерируем простую сигнатуру набора паттернов и целевых слов
-    std::string patterns_signature = std::to_string(patterns.size());
-    std::string words_signature = std::to_string(target_words.size());
-
-    return word_hash + "_" + patterns_signature + "_" + words_signature;
+    auto compiled = CompiledDictionary::build(target_words, patterns, 0, _fuzzy_max_distance);
+    if (compiled) {
+        set_dictionary(std::move(compiled));
+    }
 }
 
 void WordDetector::_throttle_check() {
@@ -276,78 +289,94 @@ std::tuple<bool, std::string> WordDetector::is_prohibited_word(
     // Защита от частых вызовов для предотвращения брутфорса
     _throttle_check();
 
-    // Нормализация входных данных
-    std::string normalized_word = _normalize_word(word_text);
+    // Нормализация входных данных в переиспользуемый буфер
+    size_t letters = _normalize_word(word_text, _normalized_buffer);
+    const std::string& normalized_word = _normalized_buffer;
 
     // Если слово короткое, скорее всего это шум
-    if (normalized_word.length() < 3) {
+    if (letters < 3) {
         return std::make_tuple(false, "");
     }
 
-    // Используем кэш для ускорения повторных проверок
-    std::string cache_key = _generate_cache_key(normalized_word, patterns, target_words);
-    if (cache.find(cache_key) != cache.end()) {
-        return cache[cache_key];
+    // Явно переданные списки заменяют словарь, только если отличаются от него
+    if (!patterns.empty() || !target_words.empty()) {
+        _update_dictionary(patterns, target_words);
+    }
+
+    // Снимок удерживается до конца проверки, даже если словарь подменят параллельно
+    std::shared_ptr<const DictionarySnapshot> snapshot = std::atomic_load(&_snapshot);
+    if (!snapshot || !snapshot->dictionary) {
+        return std::make_tuple(false, "");
+    }
+    const CompiledDictionary& dictionary = *snapshot->dictionary;
+
+    // Регулярные выражения написаны для исходного текста: они проверяются на слове
+    // в нижнем регистре, без замены ё, двойников и схлопывания повторов
+    _folded_word(word_text, _pattern_buffer);
+    const std::string& folded_word = _pattern_buffer;
+
+    // Используем кэш для ускорения повторных проверок. Ключ строится по слову для
+    // регулярных выражений: нормализованное слово однозначно получается из него
+    uint64_t cache_key = _generate_cache_key(folded_word, snapshot->generation);
+    std::tuple<bool, std::string> cached_result;
+    if (cache.lookup(cache_key, cached_result)) {
+        return cached_result;
     }
 
     // Добавляем небольшую случайную задержку для защиты от тайминг-атак
     security::add_random_delay(5, 20);
 
-    // Используем внешние паттерны и слова, если предоставлены
-    std::vector<std::string> patterns_to_use = patterns;
-    std::vector<std::string> target_words_to_use = target_words;
-
-    if (patterns_to_use.empty() && config.find("target_patterns") != config.end()) {
-        // Разбираем строку с паттернами из конфига
-        std::istringstream iss(config.at("target_patterns"));
-        std::string pattern;
-        while (std::getline(iss, pattern, ',')) {
-            patterns_to_use.push_back(pattern);
-        }
-    }
-
-    if (target_words_to_use.empty() && config.find("target_words") != config.end()) {
-        // Разбираем строку с целевыми словами из конфига
-        std::istringstream iss(config.at("target_words"));
-        std::string word;
-        while (std::getline(iss, word, ',')) {
-            target_words_to_use.push_back(word);
+    // Проверяем по регулярным выражениям, скомпилированным при публикации словаря
+    for (size_t i = 0; i < snapshot->patterns.size(); i++) {
+        if (std::regex_search(folded_word, snapshot->patterns[i])) {
+            auto result = std::make_tuple(true, snapshot->pattern_sources[i]);
+            cache.insert(cache_key, result);
+            detection_count++;
+            return result;
         }
     }
 
-    // Проверяем по регулярным выражениям
-    for (const auto& pattern_str : patterns_to_use) {
-        try {
-            std::regex pattern(pattern_str);
-            if (std::regex_search(normalized_word, pattern)) {
-                auto result = std::make_tuple(true, pattern_str);
-                cache[cache_key] = result;
-                detection_count++;
-                return result;
-            }
-        } catch (const std::regex_error& e) {
-            // В случае ошибки в регулярном выражении, пропускаем его
-            std::cerr << "Ошибка в регулярном выражении " << pattern_str << ": " << e.what() << std::endl;
+    // Проверяем по точному совпадению с учетом возможных вариаций слова
+    // (слова словаря нормализованы при компиляции)
+    for (size_t i = 0; i < dictionary.word_count(); i++) {
+        std::string_view target_normalized = dictionary.word(i);
+        if (target_normalized.empty()) {
             continue;
         }
-    }
-
-    // Проверяем по точному совпадению с учетом возможных вариаций слова
-    for (const auto& target : target_words_to_use) {
-        std::string target_normalized = _normalize_word(target);
 
         // Точное совпадение
         if (normalized_word == target_normalized) {
             auto result = std::make_tuple(true, "точное совпадение");
-            cache[cache_key] = result;
+            cache.insert(cache_key, result);
             detection_count++;
             return result;
         }
 
         // Проверка на вхождение в качестве подстроки для сложных слов
-        if (normalized_word.length() > 5 && target_normalized.find(target_normalized) != std::string::npos) {
+        if (letters > 5 && normalized_word.find(target_normalized) != std::string::npos) {
             auto result = std::make_tuple(true, "частичное совпадение");
-            cache[cache_key] = result;
+            cache.insert(cache_key, result);
+            detection_count++;
+            return result;
+        }
+    }
+
+    // Ищем словоформы слов словаря (падежи, спряжения, приставки)
+    uint32_t word_index = 0;
+    if (_morphology_enabled && dictionary.morph().find(normalized_word, word_index)) {
+        auto result = std::make_tuple(true, "словоформа: " + std::string(dictionary.word(word_index)));
+        cache.insert(cache_key, result);
+        detection_count++;
+        return result;
+    }
+
+    // Ищем близкие по написанию слова (ошибки распознавания)
+    if (_fuzzy_enabled) {
+        int distance = 0;
+        if (dictionary.fuzzy().find(normalized_word, word_index, distance)) {
+            auto result = std::make_tuple(true, "нечеткое совпадение: " + std::string(dictionary.word(word_index)) +
+                                                " (расстояние " + std::to_string(distance) + ")");
+            cache.insert(cache_key, result);
             detection_count++;
             return result;
         }
@@ -355,8 +384,25 @@ std::tuple<bool, std::string> WordDetector::is_prohibited_word(
 
     // Сохраняем отрицательный результат в кэше
     auto result = std::make_tuple(false, "");
-    cache[cache_key] = result;
+    cache.insert(cache_key, result);
     return result;
 }
 
+bool WordDetector::is_near_miss(const std::string& word_text, int slack) {
+    size_t letters = _normalize_word(word_text, _normalized_buffer);
+    if (letters < 3 || slack <= 0) {
+        return false;
+    }
+
+    std::shared_ptr<const DictionarySnapshot> snapshot = std::atomic_load(&_snapshot);
+    if (!snapshot || !snapshot->dictionary) {
+        return false;
+    }
+
+    // Без кэша: проверяются только слова, уже не прошедшие is_prohibited_word
+    uint32_t word_index = 0;
+    int distance = 0;
+    return snapshot->dictionary->fuzzy().find(_normalized_buffer, word_index, distance, slack);
+}
+
 } // namespace audiocensor
\ No newline at end of file
@@ -0,0 +1,436 @@
+#include "audiocensor/word_list_sync.h"
+#include "audiocensor/security.h"
+#include "audiocensor/constants.h"
+
+#include <nlohmann/json.hpp>
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace audiocensor {
+
+using json = nlohmann::json;
+
+namespace {
+
+// Префикс зашифрованного кэша (как у списков в настройках)
+const std::string CACHE_PREFIX = "ENC:";
+
+size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output) {
+    size_t realsize = size * nmemb;
+    output->append(static_cast<char*>(contents), realsize);
+    return realsize;
+}
+
+size_t HeaderCallback(char* buffer, size_t size, size_t nitems, std::string* etag) {
+    size_t realsize = size * nitems;
+    std::string header(buffer, realsize);
+
+    // Имена заголовков регистронезависимы
+    const std::string name = "etag:";
+    if (header.size() > name.size()) {
+        std::string prefix = header.substr(0, name.size());
+        std::transform(prefix.begin(), prefix.end(), prefix.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (prefix == name) {
+            std::string value = header.substr(name.size());
+            size_t begin = value.find_first_not_of(" \t");
+            size_t end = value.find_last_not_of(" \t\r\n");
+            *etag = (begin == std::string::npos) ? "" : value.substr(begin, end - begin + 1);
+        }
+    }
+    return realsize;
+}
+
+int ProgressCallback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    // Ненулевое значение прерывает передачу
+    const std::atomic<bool>* cancelled = static_cast<const std::atomic<bool>*>(clientp);
+    return cancelled->load() ? 1 : 0;
+}
+
+long config_long(const std::unordered_map<std::string, std::string>& config,
+                 const std::string& key, long default_value) {
+    auto it = config.find(key);
+    if (it == config.end() || it->second.empty()) {
+        return default_value;
+    }
+    try {
+        return std::stol(it->second);
+    } catch (...) {
+        return default_value;
+    }
+}
+
+// Удаляет из списка элементы removed и добавляет отсутствующие элементы added, сохраняя порядок
+void apply_delta(std::vector<std::string>& items, const json& added, const json& removed) {
+    if (removed.is_array() && !removed.empty()) {
+        std::unordered_set<std::string> removed_set;
+        for (const auto& item : removed) {
+            removed_set.insert(item.get<std::string>());
+        }
+        items.erase(std::remove_if(items.begin(), items.end(),
+                                   [&](const std::string& item) { return removed_set.count(item) > 0; }),
+                    items.end());
+    }
+
+    if (added.is_array() && !added.empty()) {
+        std::unordered_set<std::string> present(items.begin(), items.end());
+        for (const auto& item : added) {
+            std::string value = item.get<std::string>();
+            if (present.insert(value).second) {
+                items.push_back(std::move(value));
+            }
+        }
+    }
+}
+
+} // namespace
+
+WordListSync::WordListSync(const std::string& api_url,
+                           const std::string& cache_path,
+                           const std::unordered_map<std::string, std::string>& config)
+    : api_url(api_url),
+      cache_path(cache_path),
+      timeout_ms(config_long(config, "sync_timeout_ms", DEFAULT_SYNC_TIMEOUT_MS)),
+      connect_timeout_ms(config_long(config, "sync_connect_timeout_ms", DEFAULT_SYNC_CONNECT_TIMEOUT_MS)),
+      max_retries(static_cast<int>(config_long(config, "sync_retries", DEFAULT_SYNC_RETRIES))),
+      retry_delay_ms(config_long(config, "sync_retry_delay_ms", DEFAULT_SYNC_RETRY_DELAY_MS)),
+      version(0),
+      has_lists(false),
+      running(false),
+      cancelled(false) {
+}
+
+WordListSync::~WordListSync() {
+    cancel();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool WordListSync::load_cache() {
+    if (cache_path.empty()) {
+        return false;
+    }
+
+    try {
+        std::ifstream file(std::filesystem::u8path(cache_path), std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (content.compare(0, CACHE_PREFIX.size(), CACHE_PREFIX) != 0) {
+            return false;
+        }
+
+        json data = json::parse(security::deobscure_str(content.substr(CACHE_PREFIX.size())));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        words = data.value("words", std::vector<std::string>());
+        patterns = data.value("patterns", std::vector<std::string>());
+        version = data.value("version", static_cast<uint64_t>(0));
+        etag = data.value("etag", std::string());
+        has_lists = true;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка при чтении кэша списков слов: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool WordListSync::_save_cache() const {
+    if (cache_path.empty()) {
+        return false;
+    }
+
+    try {
+        json data;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            data["version"] = version;
+            data["etag"] = etag;
+            data["words"] = words;
+            data["patterns"] = patterns;
+        }
+
+        std::filesystem::path target = std::filesystem::u8path(cache_path);
+        if (target.has_parent_path()) {
+            std::filesystem::create_directories(target.parent_path());
+        }
+
+        // Пишем во временный файл и переименовываем, чтобы не оставить полузаписанный кэш
+        std::filesystem::path temporary = target;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return false;
+            }
+            file << CACHE_PREFIX << security::obscure_str(data.dump());
+            if (!file) {
+                return false;
+            }
+        }
+        std::filesystem::rename(temporary, target);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка при сохранении кэша списков слов: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool WordListSync::has_data() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return has_lists;
+}
+
+void WordListSync::get_lists(std::vector<std::string>& target_words,
+                             std::vector<std::string>& target_patterns,
+                             uint64_t& list_version) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    target_words = words;
+    target_patterns = patterns;
+    list_version = version;
+}
+
+void WordListSync::set_query_params(const std::string& params) {
+    std::lock_guard<std::mutex> lock(mutex);
+    query_params = params;
+}
+
+void WordListSync::set_response_verifier(ResponseVerifier response_verifier) {
+    std::lock_guard<std::mutex> lock(mutex);
+    verifier = std::move(response_verifier);
+}
+
+bool WordListSync::start(FinishedCallback on_finished) {
+    if (running.exchange(true)) {
+        return false;
+    }
+
+    // Предыдущий поток уже завершился (running был сброшен), забираем его
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    cancelled = false;
+    worker = std::thread([this, on_finished = std::move(on_finished)]() {
+        Result result = _sync();
+        running = false;
+        if (on_finished) {
+            on_finished(result);
+        }
+    });
+    return true;
+}
+
+void WordListSync::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(cancel_mutex);
+        cancelled = true;
+    }
+    cancel_condition.notify_all();
+}
+
+bool WordListSync::_wait_before_retry(int attempt) {
+    // 0.5с, 1с, 2с, ... но не больше 30 секунд
+    long delay = std::min(retry_delay_ms << std::min(attempt - 1, 6), 30000L);
+    std::unique_lock<std::mutex> lock(cancel_mutex);
+    return !cancel_condition.wait_for(lock, std::chrono::milliseconds(delay),
+                                      [this]() { return cancelled.load(); });
+}
+
+void WordListSync::_build_request(bool full, std::string& url, std::string& cached_etag) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    url = api_url;
+    cached_etag.clear();
+    std::string params = query_params;
+    if (has_lists && !full) {
+        params += (params.empty() ? "" : "&") + std::string("since_version=") + std::to_string(version);
+        cached_etag = etag;
+    }
+    if (!params.empty()) {
+        url += (url.find('?') == std::string::npos ? "?" : "&") + params;
+    }
+}
+
+WordListSync::Result WordListSync::_sync() {
+    Result result;
+
+    bool full = false;
+    std::string url;
+    std::string cached_etag;
+    _build_request(full, url, cached_etag);
+
+    for (int attempt = 1; attempt <= max_retries + 1; attempt++) {
+        result.attempts = attempt;
+
+        long http_code = 0;
+        std::string body;
+        std::string response_etag;
+        std::string error;
+        bool received = _request(url, cached_etag, http_code, body, response_etag, error);
+        result.http_code = http_code;
+
+        if (cancelled) {
+            result.error = "синхронизация прервана";
+            return result;
+        }
+
+        if (received && http_code == 304) {
+            std::lock_guard<std::mutex> lock(mutex);
+            result.success = has_lists;
+            result.not_modified = true;
+            if (!has_lists) {
+                result.error = "сервер ответил 304, но локального кэша нет";
+            }
+            return result;
+        }
+
+        if (received && http_code == 200) {
+            bool base_mismatch = false;
+            if (_apply_response(body, response_etag, result, base_mismatch)) {
+                result.success = true;
+                return result;
+            }
+            if (!base_mismatch || full) {
+                return result;
+            }
+
+            // Изменения не подходят к кэшу: сразу запрашиваем полный список,
+            // повторы для нового запроса отсчитываются заново
+            std::cerr << "Синхронизация списков: " << result.error << ", запрашиваем полный список" << std::endl;
+            full = true;
+            result.full_refetch = true;
+            result.error.clear();
+            _build_request(full, url, cached_etag);
+            attempt = 0;
+            continue;
+        }
+
+        // Ошибки клиента (401, 403, 404...) повторять бессмысленно
+        bool retryable = !received || http_code >= 500 || http_code == 429;
+        result.error = received ? "HTTP " + std::to_string(http_code) : error;
+        if (!retryable || attempt > max_retries) {
+            return result;
+        }
+
+        std::cerr << "Синхронизация списков: " << result.error
+                  << ", повтор " << attempt << " из " << max_retries << std::endl;
+        if (!_wait_before_retry(attempt)) {
+            result.error = "синхронизация прервана";
+            return result;
+        }
+    }
+
+    return result;
+}
+
+bool WordListSync::_request(const std::string& url, const std::string& cached_etag,
+                            long& http_code, std::string& body, std::string& response_etag,
+                            std::string& error) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        error = "ошибка инициализации cURL";
+        return false;
+    }
+
+    struct curl_slist* headers = nullptr;
+    if (!cached_etag.empty()) {
+        headers = curl_slist_append(headers, ("If-None-Match: " + cached_etag).c_str());
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response_etag);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);               // Запрос выполняется не в главном потоке
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");        // Любое сжатие, поддерживаемое libcurl
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, ProgressCallback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &cancelled);
+
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+
+    if (res != CURLE_OK) {
+        error = curl_easy_strerror(res);
+        return false;
+    }
+    return true;
+}
+
+bool WordListSync::_apply_response(const std::string& body, const std::string& response_etag,
+                                   Result& result, bool& base_mismatch) {
+    ResponseVerifier response_verifier;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        response_verifier = verifier;
+    }
+
+    // Проверяем подпись ответа для защиты от подделки
+    if (response_verifier && !response_verifier(body)) {
+        result.error = "получены подозрительные данные от API";
+        return false;
+    }
+
+    try {
+        json data = json::parse(body);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::string> new_words = words;
+        std::vector<std::string> new_patterns = patterns;
+        uint64_t new_version = data.contains("version") && data["version"].is_number_unsigned()
+                                   ? data["version"].get<uint64_t>() : 0;
+
+        if (data.value("delta", false)) {
+            // Изменения применимы только к той версии, от которой они посчитаны
+            uint64_t base_version = data.value("base_version", static_cast<uint64_t>(0));
+            if (!has_lists || base_version != version) {
+                result.error = "изменения посчитаны от версии " + std::to_string(base_version) +
+                               ", а в кэше версия " + std::to_string(version);
+                base_mismatch = true;
+                return false;
+            }
+            apply_delta(new_words, data.value("added_words", json::array()), data.value("removed_words", json::array()));
+            apply_delta(new_patterns, data.value("added_patterns", json::array()), data.value("removed_patterns", json::array()));
+            result.delta = true;
+        } else {
+            new_words = data.contains("words") && data["words"].is_array()
+                            ? data["words"].get<std::vector<std::string>>() : std::vector<std::string>();
+            new_patterns = data.contains("patterns") && data["patterns"].is_array()
+                               ? data["patterns"].get<std::vector<std::string>>() : std::vector<std::string>();
+        }
+
+        result.changed = !has_lists || new_words != words || new_patterns != patterns;
+        words = std::move(new_words);
+        patterns = std::move(new_patterns);
+        version = new_version;
+        etag = response_etag;
+        has_lists = true;
+    } catch (const std::exception& e) {
+        result.error = std::string("ошибка разбора ответа: ") + e.what();
+        return false;
+    }
+
+    if (!_save_cache()) {
+        std::cerr << "Не удалось сохранить кэш списков слов" << std::endl;
+    }
+    return true;
+}
+
+} // namespace audiocensor
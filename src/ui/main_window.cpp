@@ -2,6 +2,9 @@
 #include "audiocensor/license_manager.h"
 #include "audiocensor/config_manager.h"
 #include "audiocensor/audio_processor.h"
+#include "audiocensor/compiled_dictionary.h"
+#include "audiocensor/word_list_sync.h"
+#include "audiocensor/log_buffer.h"
 #include "audiocensor/security.h"
 #include "audiocensor/constants.h"
 #include "ui/license_dialog.h"
@@ -24,39 +27,88 @@
 #include <QCloseEvent> // Добавлено для QCloseEvent
 
 #include <nlohmann/json.hpp>
-#include <curl/curl.h>
 
 #include <iostream>
 #include <fstream>
 #include <chrono>
 #include <random>
+#include <ctime>
+#include <algorithm>
+#include <limits>
 
 namespace audiocensor {
 
 using json = nlohmann::json;
 
-// Функция для callback cURL
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output) {
-    size_t realsize = size * nmemb;
-    output->append(static_cast<char*>(contents), realsize);
-    return realsize;
+namespace {
+
+/**
+ * @brief Читает целую настройку и ограничивает ее диапазоном
+ * @return Значение настройки или default_value, если оно не число
+ */
+long long _config_clamped(const ConfigSnapshot& config, const std::string& key,
+                          long long default_value, long long min_value, long long max_value) {
+    long long value = default_value;
+    try {
+        value = std::stoll(config.get(key, std::to_string(default_value)));
+    } catch (const std::exception&) {
+        value = default_value;
+    }
+    return std::max(min_value, std::min(max_value, value));
 }
 
+} // namespace
+
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent),
       running(false),
       input_device_index(-1),
       output_device_index(-1),
-      detections_count(0)
+      detections_count(0),
+      start_pending(false),
+      license_pending(false),
+      start_license_pending(false),
+      log_flushed_sequence(0)
 {
+    // Время запуска до готовности окна (без обращения к сети)
+    startup_timer.start();
+
     // Инициализация менеджеров
     license_manager = std::make_unique<LicenseManager>();
     config_manager = std::make_unique<ConfigManager>();
 
     // Инициализация аудио процессора
-    auto config = config_manager->get_config();
+    auto config = config_manager->get_snapshot();
+    license_manager->apply_config(config->values);
     audio_processor = std::make_unique<AudioProcessor>(config);
 
+    // Лог событий: память ограничена емкостью буфера, окно обновляется не чаще log_flush_fps раз в секунду
+    log_buffer = std::make_unique<LogBuffer>(static_cast<size_t>(
+            _config_clamped(*config, "log_buffer_size", static_cast<long long>(DEFAULT_LOG_BUFFER_SIZE),
+                            1, static_cast<long long>(MAX_LOG_BUFFER_SIZE))));
+    int log_flush_fps = static_cast<int>(
+            _config_clamped(*config, "log_flush_fps", DEFAULT_LOG_FLUSH_FPS, 1, MAX_LOG_FLUSH_FPS));
+    log_flush_timer = new QTimer(this);
+    log_flush_timer->setSingleShot(true);
+    log_flush_timer->setInterval(1000 / log_flush_fps);
+    connect(log_flush_timer, &QTimer::timeout, this, &MainWindow::flush_log);
+
+    // Синхронизация списков слов: локальный кэш читается сразу, сеть - только в фоне
+    std::string words_api_url = config->get("words_api_url");
+    if (words_api_url.empty()) {
+        words_api_url = license_manager->get_words_api_url();
+    }
+    word_list_sync = std::make_unique<WordListSync>(words_api_url, config->get("word_list_cache_path"),
+                                                    config->values);
+    word_list_sync->load_cache();
+
+    // Аудио процессор получает новые снимки конфигурации без копирования
+    config_manager->subscribe([this](const ConfigSnapshotPtr& snapshot) {
+        if (audio_processor) {
+            audio_processor->update_config(snapshot);
+        }
+    });
+
     // Инициализация интеграций
     setup_integration_menu();
     initialize_integrations();
@@ -80,11 +132,25 @@ MainWindow::MainWindow(QWidget* parent)
     connect(status_timer, &QTimer::timeout, this, &MainWindow::update_status);
     status_timer->start(1000); // обновление каждую секунду
 
+    // Проверка подключения и отключения устройств, пока обработка остановлена
+    int device_refresh_interval = std::stoi(config->get("device_refresh_interval_ms",
+                                                        std::to_string(DEFAULT_DEVICE_REFRESH_INTERVAL_MS)));
+    device_refresh_timer = new QTimer(this);
+    connect(device_refresh_timer, &QTimer::timeout, this, &MainWindow::refresh_devices);
+    if (device_refresh_interval > 0) {
+        device_refresh_timer->start(device_refresh_interval);
+    }
+
     // Показываем информацию о лицензии
     show_license_info();
 }
 
 MainWindow::~MainWindow() {
+    // Прерываем синхронизацию списков, пока окно еще существует
+    if (word_list_sync) {
+        word_list_sync->cancel();
+    }
+
     // Освобождение ресурсов
     if (status_timer) {
         status_timer->stop();
@@ -146,8 +212,12 @@ void MainWindow::init_ui() {
     QGroupBox* log_panel = new QGroupBox("Лог событий", this);
     QVBoxLayout* log_layout = new QVBoxLayout(log_panel);
 
-    log_text = new QTextEdit(this);
+    // Окно хранит только последние строки; полный лог остается в буфере
+    log_text = new QPlainTextEdit(this);
     log_text->setReadOnly(true);
+    log_text->setMaximumBlockCount(static_cast<int>(
+            _config_clamped(*config_manager->get_snapshot(), "log_view_max_lines", DEFAULT_LOG_VIEW_MAX_LINES,
+                            1, std::numeric_limits<int>::max())));
     log_layout->addWidget(log_text);
 
     QHBoxLayout* log_control_layout = new QHBoxLayout();
@@ -170,6 +240,9 @@ void MainWindow::init_ui() {
 
     detections_label = new QLabel("Обнаружено: 0", this);
     statusBar()->addPermanentWidget(detections_label);
+
+    xruns_label = new QLabel("Сбои: вход 0, выход 0", this);
+    statusBar()->addPermanentWidget(xruns_label);
 }
 
 void MainWindow::connect_signals() {
@@ -185,10 +258,14 @@ void MainWindow::connect_signals() {
     // Кнопка лицензии
     connect(activate_license_button, &QPushButton::clicked, this, &MainWindow::show_license_dialog);
 
+    // Результат фоновой проверки лицензии
+    connect(license_manager.get(), &LicenseManager::licenseVerified, this, &MainWindow::license_verified);
+
     // Сигналы от аудио процессора
     connect(audio_processor.get(), &AudioProcessor::logMessage, this, &MainWindow::add_log_message);
     connect(audio_processor.get(), &AudioProcessor::wordDetected, this, &MainWindow::word_detected);
     connect(audio_processor.get(), &AudioProcessor::bufferUpdate, this, &MainWindow::update_buffer_status);
+    connect(audio_processor.get(), &AudioProcessor::xrunUpdate, this, &MainWindow::update_xrun_status);
     connect(audio_processor.get(), &AudioProcessor::deviceListUpdate, this, &MainWindow::update_device_list);
 }
 
@@ -236,7 +313,18 @@ void MainWindow::init_audio() {
     }
 }
 
+void MainWindow::refresh_devices() {
+    // Во время обработки устройства отслеживает аудио процессор
+    if (!running) {
+        audio_processor->refresh_devices();
+    }
+}
+
 void MainWindow::update_device_list(const QList<QPair<int, QString>>& devices) {
+    // Индексы после обновления списка могут измениться, выбор сохраняется по имени
+    QString selected_input = input_device_combo->currentText();
+    QString selected_output = output_device_combo->currentText();
+
     input_device_combo->clear();
     output_device_combo->clear();
 
@@ -252,18 +340,57 @@ void MainWindow::update_device_list(const QList<QPair<int, QString>>& devices) {
             output_device_combo->addItem(name, index);
         }
     }
+
+    int input_position = input_device_combo->findText(selected_input);
+    if (input_position >= 0) {
+        input_device_combo->setCurrentIndex(input_position);
+    }
+    int output_position = output_device_combo->findText(selected_output);
+    if (output_position >= 0) {
+        output_device_combo->setCurrentIndex(output_position);
+    }
 }
 
 void MainWindow::add_log_message(const QString& message) {
-    // Добавляем временную метку и сообщение в лог
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
-    log_text->append(QString("[%1] %2").arg(timestamp).arg(message));
+    // Время форматируется только при выводе
+    log_buffer->append(std::time(nullptr), message.toStdString());
+
+    // Окно обновится одной пачкой по таймеру
+    if (!log_flush_timer->isActive()) {
+        log_flush_timer->start();
+    }
+}
+
+void MainWindow::flush_log() {
+    uint64_t next = log_buffer->next_sequence();
+    uint64_t from = std::max(log_flushed_sequence, log_buffer->first_sequence());
+
+    // Строки сверх лимита окно все равно удалит, поэтому не выводим их
+    uint64_t max_lines = static_cast<uint64_t>(std::max(0, log_text->maximumBlockCount()));
+    if (max_lines > 0 && next - from > max_lines) {
+        from = next - max_lines;
+    }
+    log_flushed_sequence = next;
+    if (from >= next) {
+        return;
+    }
+
+    log_batch.clear();
+    log_buffer->for_each_since(from, [this](const LogBuffer::Entry& entry) {
+        if (!log_batch.empty()) {
+            log_batch += '\n';
+        }
+        LogBuffer::format_entry(entry, log_batch);
+    });
+    log_text->appendPlainText(QString::fromStdString(log_batch));
 
     // Прокрутка до конца
     log_text->verticalScrollBar()->setValue(log_text->verticalScrollBar()->maximum());
 }
 
 void MainWindow::clear_log() {
+    log_buffer->clear();
+    log_flushed_sequence = log_buffer->next_sequence();
     log_text->clear();
     add_log_message("🧹 Лог очищен");
 }
@@ -279,11 +406,23 @@ void MainWindow::save_log() {
     try {
         QFile file(file_path);
         if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            QTextStream stream(&file);
-            stream << log_text->toPlainText();
+            // Записи пишутся из буфера построчно, без сборки всего лога в памяти
+            std::string line;
+            bool written = true;
+            log_buffer->for_each_since(log_buffer->first_sequence(), [&](const LogBuffer::Entry& entry) {
+                line.clear();
+                LogBuffer::format_entry(entry, line);
+                line += '\n';
+                written = written && file.write(line.data(), static_cast<qint64>(line.size())) ==
+                                     static_cast<qint64>(line.size());
+            });
             file.close();
 
-            add_log_message(QString("✅ Лог сохранен в %1").arg(file_path));
+            if (written) {
+                add_log_message(QString("✅ Лог сохранен в %1").arg(file_path));
+            } else {
+                add_log_message(QString("❌ Ошибка записи в файл: %1").arg(file.errorString()));
+            }
         } else {
             add_log_message(QString("❌ Ошибка открытия файла для записи: %1").arg(file.errorString()));
         }
@@ -293,30 +432,47 @@ void MainWindow::save_log() {
 }
 
 void MainWindow::start_processing() {
-    if (running) {
+    if (running || start_pending || start_license_pending) {
         return;
     }
 
     // Проверяем лицензию перед запуском
     if (!license_manager->has_valid_license()) {
+        // Сервер мог продлить лицензию: запуск продолжится по результату проверки
+        if (license_manager->is_verification_running()) {
+            add_log_message("🔑 Лицензия проверяется на сервере, запуск продолжится после проверки...");
+            start_license_pending = true;
+            start_button->setEnabled(false);
+            return;
+        }
+
         QMessageBox::warning(this, "Ошибка лицензии",
                             "Лицензия недействительна или истекла. Пожалуйста, активируйте лицензию.");
         show_license_dialog();
         return;
     }
 
-    // Загружаем список слов из API
-    add_log_message("📡 Загрузка списка запрещённых слов из API...");
-    bool api_success = load_words_from_api();
+    start_with_word_lists();
+}
 
-    // Если не удалось загрузить слова из API, невозможно продолжить
-    if (!api_success) {
-        QMessageBox::critical(this, "Ошибка загрузки данных",
-                             "Не удалось загрузить список запрещённых слов с сервера.\n"
-                             "Проверьте подключение к интернету и повторите попытку.");
+void MainWindow::start_with_word_lists() {
+    // Со списками из локального кэша стартуем сразу, обновления проверяются в фоне
+    if (word_list_sync->has_data()) {
+        add_log_message("📡 Проверка обновлений списка запрещённых слов...");
+        load_words_from_api();
+        begin_processing();
         return;
     }
 
+    // Кэша еще нет: запуск продолжится после первой загрузки, окно при этом не блокируется
+    add_log_message("📡 Загрузка списка запрещённых слов из API...");
+    if (load_words_from_api()) {
+        start_pending = true;
+        start_button->setEnabled(false);
+    }
+}
+
+void MainWindow::begin_processing() {
     // Получаем индексы выбранных устройств
     input_device_index = input_device_combo->currentData().toInt();
     output_device_index = output_device_combo->currentData().toInt();
@@ -352,7 +508,7 @@ void MainWindow::stop_processing() {
         return;
     }
 
-    // Останавливаем поток
+    // Останавливаем поток; процессор сохраняет открытые потоки и модель до следующего запуска
     audio_processor->stop_processing();
     running = false;
 
@@ -363,18 +519,6 @@ void MainWindow::stop_processing() {
     config_manager->update_config(config);
     add_log_message("🧹 Списки слов и паттернов очищены");
 
-    // Создаем новый аудио процессор
-    audio_processor = std::make_unique<AudioProcessor>(config);
-
-    // Переподключаем сигналы
-    connect(audio_processor.get(), &AudioProcessor::logMessage, this, &MainWindow::add_log_message);
-    connect(audio_processor.get(), &AudioProcessor::wordDetected, this, &MainWindow::word_detected);
-    connect(audio_processor.get(), &AudioProcessor::bufferUpdate, this, &MainWindow::update_buffer_status);
-    connect(audio_processor.get(), &AudioProcessor::deviceListUpdate, this, &MainWindow::update_device_list);
-
-    // Повторная инициализация аудио устройств
-    audio_processor->initialize_audio();
-
     // Обновляем UI
     start_button->setEnabled(true);
     stop_button->setEnabled(false);
@@ -406,15 +550,9 @@ void MainWindow::toggle_pause() {
 
 bool MainWindow::load_words_from_api() {
     try {
-        // URL API для получения списка слов
-        std::string api_url = license_manager->get_words_api_url();
-
         // Получаем machine_id
         std::string machine_id = security::get_machine_id();
 
-        // Добавляем случайную задержку для защиты от автоматизированных атак
-        security::add_random_delay(50, 100); // 50-100 мс
-
         // Генерируем уникальный идентификатор запроса
         std::random_device rd;
         std::mt19937 gen(rd());
@@ -426,97 +564,90 @@ bool MainWindow::load_words_from_api() {
                            "&license_key=" + license_manager->get_license_key() +
                            "&request_id=" + request_id +
                            "&timestamp=" + std::to_string(std::time(nullptr));
-
-        // Формируем полный URL
-        std::string full_url = api_url + "?" + params;
-
-        // Выполняем GET запрос
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            add_log_message("❌ Ошибка инициализации cURL");
-            return false;
+        word_list_sync->set_query_params(params);
+
+        // Проверяем подпись ответа для защиты от подделки
+        LicenseManager* license = license_manager.get();
+        word_list_sync->set_response_verifier([license, machine_id](const std::string& response_data) {
+            return license->verify_api_response(response_data, machine_id);
+        });
+
+        // Запрос выполняется в фоне, результат обрабатывается в потоке интерфейса
+        bool started = word_list_sync->start([this](const WordListSync::Result& result) {
+            QMetaObject::invokeMethod(this, [this, result]() {
+                word_lists_synced(result);
+            }, Qt::QueuedConnection);
+        });
+
+        if (!started) {
+            add_log_message("⏳ Синхронизация списка слов уже выполняется");
         }
+        return started;
 
-        std::string response_data;
-
-        curl_easy_setopt(curl, CURLOPT_URL, full_url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-        CURLcode res = curl_easy_perform(curl);
-
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    } catch (const std::exception& e) {
+        add_log_message(QString("❌ Ошибка при загрузке списка слов: %1").arg(e.what()));
+        return false;
+    }
+}
 
-        curl_easy_cleanup(curl);
+void MainWindow::word_lists_synced(const WordListSync::Result& result) {
+    bool pending = start_pending;
+    start_pending = false;
 
-        if (res != CURLE_OK) {
-            add_log_message(QString("❌ Ошибка cURL: %1").arg(curl_easy_strerror(res)));
-            return false;
+    if (!result.success) {
+        add_log_message(QString("❌ Ошибка при загрузке списка слов: %1")
+                        .arg(QString::fromStdString(result.error)));
+        if (result.http_code == 401) {
+            add_log_message("❌ Проверьте лицензионный ключ и доступ к API");
         }
 
-        if (http_code == 200) {
-            // Парсим JSON ответ
-            json data = json::parse(response_data);
-
-            // Проверяем подпись ответа для защиты от подделки
-            if (!license_manager->verify_api_response(response_data, machine_id)) {
-                add_log_message("⚠️ Предупреждение: получены подозрительные данные от API");
-                return false;
-            }
-
-            // Обновляем списки слов и регулярных выражений
-            int words_count = 0;
-            int patterns_count = 0;
-            auto config = config_manager->get_config();
-
-            if (data.contains("words") && data["words"].is_array()) {
-                std::vector<std::string> target_words = data["words"].get<std::vector<std::string>>();
-                config["target_words"] = data["words"].dump();
-                words_count = target_words.size();
-                add_log_message(QString("✅ Загружено %1 запрещённых слов из API").arg(words_count));
-            } else {
-                config["target_words"] = "[]";
-                add_log_message("⚠️ API не вернул список слов, словарь пуст");
-            }
+        // Без списков запуск невозможен; если кэш есть, продолжаем работать с ним
+        if (pending) {
+            start_button->setEnabled(true);
+            QMessageBox::critical(this, "Ошибка загрузки данных",
+                                 "Не удалось загрузить список запрещённых слов с сервера.\n"
+                                 "Проверьте подключение к интернету и повторите попытку.");
+        } else if (word_list_sync->has_data()) {
+            add_log_message("⚠️ Используется сохранённый список запрещённых слов");
+        }
+        return;
+    }
 
-            // Обновляем регулярные выражения
-            if (data.contains("patterns") && data["patterns"].is_array()) {
-                std::vector<std::string> target_patterns = data["patterns"].get<std::vector<std::string>>();
-                config["target_patterns"] = data["patterns"].dump();
-                patterns_count = target_patterns.size();
-                add_log_message(QString("✅ Загружено %1 регулярных выражений из API").arg(patterns_count));
-            } else {
-                config["target_patterns"] = "[]";
-                add_log_message("⚠️ API не вернул шаблоны регулярных выражений");
-            }
+    std::vector<std::string> target_words;
+    std::vector<std::string> target_patterns;
+    uint64_t version = 0;
+    word_list_sync->get_lists(target_words, target_patterns, version);
 
-            // Обновляем конфигурацию в аудио потоке
-            audio_processor->update_config(config);
-            add_log_message("✅ Конфигурация цензуры обновлена");
+    if (result.not_modified) {
+        add_log_message(QString("✅ Список запрещённых слов актуален (версия %1)").arg(version));
+    } else {
+        add_log_message(QString("✅ Загружено %1 запрещённых слов и %2 регулярных выражений из API (версия %3%4)")
+                        .arg(target_words.size())
+                        .arg(target_patterns.size())
+                        .arg(version)
+                        .arg(result.delta ? ", только изменения" : ""));
+    }
 
-            // Сохраняем обновленную конфигурацию
-            config_manager->update_config(config);
+    bool has_entries = !target_words.empty() || !target_patterns.empty();
 
-            // Проверяем, есть ли хоть какие-то слова или шаблоны
-            if (words_count == 0 && patterns_count == 0) {
-                add_log_message("⚠️ Внимание: не получено ни слов, ни шаблонов для цензуры!");
-                return false;
-            }
+    // Словарь пересобирается в фоне, только если он отличается от загруженных списков
+    auto dictionary = audio_processor->get_dictionary();
+    if (result.changed || !dictionary ||
+        dictionary->get_fingerprint() != CompiledDictionary::fingerprint(target_words, target_patterns)) {
+        audio_processor->reload_dictionary(std::move(target_words), std::move(target_patterns), version);
+    }
 
-            return true;
-        } else {
-            add_log_message(QString("❌ Ошибка при загрузке списка слов: HTTP %1").arg(http_code));
-            if (http_code == 401) {
-                add_log_message("❌ Проверьте лицензионный ключ и доступ к API");
-            }
-            return false;
+    // Проверяем, есть ли хоть какие-то слова или шаблоны
+    if (!has_entries) {
+        add_log_message("⚠️ Внимание: не получено ни слов, ни шаблонов для цензуры!");
+        if (pending) {
+            start_button->setEnabled(true);
+            return;
         }
+    }
 
-    } catch (const std::exception& e) {
-        add_log_message(QString("❌ Ошибка при загрузке списка слов: %1").arg(e.what()));
-        return false;
+    if (pending) {
+        begin_processing();
     }
 }
 
@@ -542,6 +673,26 @@ void MainWindow::update_buffer_status(int current, int maximum) {
     buffer_label->setText(QString("Буфер: %1/%2 (%3%)").arg(current).arg(maximum).arg(percentage));
 }
 
+void MainWindow::update_xrun_status(const QVariantMap& stats) {
+    qulonglong overflows = stats.value("input_overflows").toULongLong();
+    qulonglong underflows = stats.value("output_underflows").toULongLong();
+    xruns_label->setText(QString("Сбои: вход %1, выход %2").arg(overflows).arg(underflows));
+    xruns_label->setToolTip(QString("Ошибки чтения/записи: %1/%2\n"
+                                    "Восполнено тишиной: %3 сэмплов, выброшено пауз: %9 сэмплов\n"
+                                    "Задержка устройств: %4/%5 мс (увеличена %6 раз)\n"
+                                    "Переподключений устройств: %7\n"
+                                    "Расхождение часов выхода: %8 ppm")
+                            .arg(stats.value("read_errors").toULongLong())
+                            .arg(stats.value("write_errors").toULongLong())
+                            .arg(stats.value("samples_realigned").toULongLong())
+                            .arg(stats.value("input_latency_ms").toDouble(), 0, 'f', 0)
+                            .arg(stats.value("output_latency_ms").toDouble(), 0, 'f', 0)
+                            .arg(stats.value("latency_increases").toInt())
+                            .arg(stats.value("device_reconnects").toInt())
+                            .arg(stats.value("drift_ppm").toDouble(), 0, 'f', 1)
+                            .arg(stats.value("samples_compressed").toULongLong()));
+}
+
 void MainWindow::show_license_dialog() {
     LicenseDialog dialog(license_manager.get(), this);
     if (dialog.exec() == QDialog::Accepted) {
@@ -655,10 +806,27 @@ void MainWindow::show_obs_config_dialog() {
 }
 
 bool MainWindow::check_license_on_launch() {
+    // Состояние лицензии берется из подписанного кэша, сервер опрашивается в фоне
+    QElapsedTimer license_timer;
+    license_timer.start();
     auto license_status = license_manager->get_license_status();
+    bool verifying = false;
+    if (license_manager->needs_online_verification()) {
+        verifying = license_manager->start_background_verification();
+    }
+    add_log_message(QString("⏱ Запуск: %1 мс, проверка лицензии: %2 мс")
+                    .arg(startup_timer.elapsed())
+                    .arg(license_timer.elapsed()));
 
     // Если нет ни лицензии, ни пробного периода, показываем диалог активации
     if (license_status["has_license"] != "true" && license_status["trial_active"] != "true") {
+        // Сохраненный ключ без подписанного кэша подтверждает сервер: диалог - по его ответу
+        if (verifying) {
+            add_log_message("🔑 Лицензия проверяется на сервере...");
+            license_pending = true;
+            return true;
+        }
+
         LicenseDialog dialog(license_manager.get(), this);
         if (dialog.exec() != QDialog::Accepted) {
             // Если пользователь отказался от активации, закрываем приложение
@@ -692,15 +860,54 @@ bool MainWindow::check_license_on_launch() {
 
     return true;
 }
+void MainWindow::license_verified(bool valid, const QString& message) {
+    if (valid) {
+        add_log_message("🔑 Лицензия проверена: " + message);
+    } else {
+        add_log_message("⚠️ Проверка лицензии не пройдена: " + message);
+    }
+
+    // Обновляем метки: сервер мог продлить или отозвать лицензию
+    show_license_info();
+
+    if (license_pending) {
+        license_pending = false;
+
+        // Проверка при запуске не подтвердила лицензию: предлагаем активацию
+        auto license_status = license_manager->get_license_status();
+        if (license_status["has_license"] != "true" && license_status["trial_active"] != "true") {
+            LicenseDialog dialog(license_manager.get(), this);
+            if (dialog.exec() != QDialog::Accepted) {
+                close();
+                return;
+            }
+            show_license_info();
+        }
+    }
+
+    if (start_license_pending) {
+        start_license_pending = false;
+        start_button->setEnabled(true);
+
+        // Запуск, отложенный до ответа сервера, продолжается без повторной проверки
+        if (valid) {
+            start_with_word_lists();
+        } else {
+            QMessageBox::warning(this, "Ошибка лицензии",
+                                "Лицензия недействительна или истекла. Пожалуйста, активируйте лицензию.");
+            show_license_dialog();
+        }
+    }
+}
+
 void MainWindow::closeEvent(QCloseEvent* event) {
     if (running) {
         // Останавливаем обработку при закрытии
         audio_processor->stop_processing();
     }
 
-    // Сохраняем конфигурацию перед закрытием
-    auto config = config_manager->get_config();
-    config_manager->update_config(config);
+    // Сохраняем отложенные изменения конфигурации перед закрытием
+    config_manager->flush();
 
     QMainWindow::closeEvent(event);
 }
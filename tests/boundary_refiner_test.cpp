@@ -0,0 +1,169 @@
+/**
+ * @brief Тесты BoundaryRefiner на синтетических сигналах: перенос границ к
+ *        краям звучания и запрет сужать регион внутрь отчета распознавателя
+ */
+
+#include "audiocensor/boundary_refiner.h"
+#include "test_support.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using audiocensor::BoundaryRefiner;
+using audiocensor::ConfigSnapshot;
+
+namespace {
+
+constexpr int RATE = 16000;
+constexpr int64_t ORIGIN = 100000;   // Индекс захвата первого сэмпла окна
+constexpr int64_t GUARD = 240;       // boundary_guard_ms = 15 при 16 кГц
+constexpr int64_t FRAME = 160;       // Кадр анализа 10 мс
+
+ConfigSnapshot _config(bool enabled = true) {
+    ConfigSnapshot config;
+    config.values["boundary_refine"] = enabled ? "true" : "false";
+    config.values["boundary_search_ms"] = "150";
+    config.values["boundary_threshold_db"] = "12";
+    config.values["boundary_guard_ms"] = "15";
+    return config;
+}
+
+/**
+ * @brief Окно из фонового шума; отрезки заполняются tone() и noise()
+ */
+std::vector<short> _window(size_t count, int floor_amplitude) {
+    std::vector<short> samples(count);
+    uint32_t state = 12345;
+    for (auto& sample : samples) {
+        state = state * 1664525u + 1013904223u;
+        sample = static_cast<short>(static_cast<int>(state >> 16) % (2 * floor_amplitude + 1) - floor_amplitude);
+    }
+    return samples;
+}
+
+void _tone(std::vector<short>& samples, size_t first, size_t end, double amplitude) {
+    const double pi = std::acos(-1.0);
+    for (size_t i = first; i < end; i++) {
+        samples[i] = static_cast<short>(amplitude * std::sin(2.0 * pi * 440.0 * i / RATE));
+    }
+}
+
+void _noise(std::vector<short>& samples, size_t first, size_t end, int amplitude) {
+    uint32_t state = 777;
+    for (size_t i = first; i < end; i++) {
+        state = state * 1664525u + 1013904223u;
+        samples[i] = static_cast<short>(static_cast<int>(state >> 16) % (2 * amplitude + 1) - amplitude);
+    }
+}
+
+void test_start_moves_back_to_onset() {
+    BoundaryRefiner refiner(_config(), RATE);
+    auto samples = _window(4800, 0);
+    _tone(samples, 2400, 4800, 8000);
+
+    // Vosk поставил начало внутрь слова: граница уходит назад к началу тона
+    int64_t boundary = ORIGIN + 3200;
+    CHECK(refiner.refine_start(samples.data(), samples.size(), ORIGIN, boundary));
+    CHECK(boundary <= ORIGIN + 2400 - GUARD);
+    CHECK(boundary >= ORIGIN + 2400 - GUARD - FRAME);
+}
+
+void test_start_in_silence_is_kept() {
+    BoundaryRefiner refiner(_config(), RATE);
+    auto samples = _window(4800, 0);
+    _tone(samples, 2400, 4800, 8000);
+
+    // Начало в тишине перед словом не переносится вперед, к звуку
+    int64_t boundary = ORIGIN + 1600;
+    CHECK(refiner.refine_start(samples.data(), samples.size(), ORIGIN, boundary));
+    CHECK_EQ(boundary, ORIGIN + 1600 - GUARD);
+}
+
+void test_quiet_voiceless_onset_stays_covered() {
+    BoundaryRefiner refiner(_config(), RATE);
+
+    // Фон, тихий шипящий (ниже порога звучания) и громкий гласный
+    auto samples = _window(4800, 50);
+    _noise(samples, 1600, 2400, 140);
+    _tone(samples, 2400, 4800, 8000);
+
+    // Vosk отметил начало шипящего: граница не сдвигается на гласный
+    int64_t boundary = ORIGIN + 1600;
+    CHECK(refiner.refine_start(samples.data(), samples.size(), ORIGIN, boundary));
+    CHECK(boundary <= ORIGIN + 1600 - GUARD);
+}
+
+void test_end_moves_forward_to_release() {
+    BoundaryRefiner refiner(_config(), RATE);
+    auto samples = _window(4800, 0);
+    _tone(samples, 0, 2400, 8000);
+
+    int64_t boundary = ORIGIN + 1600;
+    CHECK(refiner.refine_end(samples.data(), samples.size(), ORIGIN, boundary));
+    CHECK(boundary >= ORIGIN + 2399 + GUARD);
+    CHECK(boundary <= ORIGIN + 2399 + GUARD + FRAME);
+}
+
+void test_end_in_silence_is_kept() {
+    BoundaryRefiner refiner(_config(), RATE);
+    auto samples = _window(4800, 0);
+    _tone(samples, 0, 2400, 8000);
+
+    // Конец в тишине после слова не переносится назад, к звуку
+    int64_t boundary = ORIGIN + 3200;
+    CHECK(refiner.refine_end(samples.data(), samples.size(), ORIGIN, boundary));
+    CHECK_EQ(boundary, ORIGIN + 3200 + GUARD);
+}
+
+void test_connected_speech_never_shrinks() {
+    BoundaryRefiner refiner(_config(), RATE);
+    auto samples = _window(4800, 0);
+    _tone(samples, 0, 4800, 8000);
+
+    // Тишины нет: граница выбирается по спектру, но только снаружи отчета
+    int64_t start = ORIGIN + 2400;
+    CHECK(refiner.refine_start(samples.data(), samples.size(), ORIGIN, start));
+    CHECK(start <= ORIGIN + 2400 - GUARD);
+
+    int64_t end = ORIGIN + 2400;
+    CHECK(refiner.refine_end(samples.data(), samples.size(), ORIGIN, end));
+    CHECK(end >= ORIGIN + 2400 + GUARD);
+}
+
+void test_not_refined() {
+    auto samples = _window(4800, 0);
+    _tone(samples, 2400, 4800, 8000);
+
+    // Уточнение выключено
+    BoundaryRefiner disabled(_config(false), RATE);
+    int64_t boundary = ORIGIN + 3200;
+    CHECK(!disabled.refine_start(samples.data(), samples.size(), ORIGIN, boundary));
+    CHECK_EQ(boundary, ORIGIN + 3200);
+
+    // Граница вне окна
+    BoundaryRefiner refiner(_config(), RATE);
+    boundary = ORIGIN + 4800;
+    CHECK(!refiner.refine_end(samples.data(), samples.size(), ORIGIN, boundary));
+    CHECK_EQ(boundary, ORIGIN + 4800);
+
+    // Окно без звука: уточнять не по чему
+    auto silence = _window(4800, 0);
+    boundary = ORIGIN + 2400;
+    CHECK(!refiner.refine_start(silence.data(), silence.size(), ORIGIN, boundary));
+    CHECK(!refiner.refine_end(silence.data(), silence.size(), ORIGIN, boundary));
+    CHECK_EQ(boundary, ORIGIN + 2400);
+}
+
+} // namespace
+
+int main() {
+    test_start_moves_back_to_onset();
+    test_start_in_silence_is_kept();
+    test_quiet_voiceless_onset_stays_covered();
+    test_end_moves_forward_to_release();
+    test_end_in_silence_is_kept();
+    test_connected_speech_never_shrinks();
+    test_not_refined();
+    return test::result();
+}
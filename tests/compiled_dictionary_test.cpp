@@ -0,0 +1,296 @@
+/**
+ * @brief Тесты CompiledDictionary: сохранение и подключение образа, поврежденные образы
+ */
+
+#include "audiocensor/compiled_dictionary.h"
+#include "audiocensor/security.h"
+#include "audiocensor/text_normalizer.h"
+#include "test_support.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using audiocensor::CompiledDictionary;
+
+namespace {
+
+const std::vector<std::string> WORDS = {"собака~1", "дурак", "Привет", "кот"};
+const std::vector<std::string> PATTERNS = {"\\bслов[оа]\\b", "тест.*"};
+constexpr uint64_t VERSION = 42;
+
+// Смещения полей заголовка образа (см. ImageHeader в compiled_dictionary.cpp)
+constexpr size_t FORMAT_VERSION_OFFSET = 8;
+constexpr size_t BYTE_ORDER_OFFSET = 12;
+constexpr size_t SECTIONS_OFFSET = 48;
+constexpr size_t SECTION_INFO_SIZE = 16;
+constexpr size_t SECTION_WORD_OFFSETS = 0;
+constexpr size_t SECTION_WORD_BYTES = 1;
+constexpr size_t SECTION_MORPH_NODES = 7;
+
+std::filesystem::path _temp_path(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("audiocensor_compiled_dictionary_test_" + name);
+}
+
+std::string _read_raw(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Читает файл словаря и снимает обфускацию: тесты правят образ как есть
+ */
+std::string _read_file(const std::filesystem::path& path) {
+    return audiocensor::security::deobscure_str(_read_raw(path));
+}
+
+void _write_file(const std::filesystem::path& path, const std::string& image) {
+    std::string bytes = audiocensor::security::obscure_str(image);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+uint64_t _read_u64(const std::string& image, size_t offset) {
+    uint64_t value = 0;
+    std::memcpy(&value, image.data() + offset, sizeof(value));
+    return value;
+}
+
+void _write_u32(std::string& image, size_t offset, uint32_t value) {
+    std::memcpy(&image[offset], &value, sizeof(value));
+}
+
+void _write_u64(std::string& image, size_t offset, uint64_t value) {
+    std::memcpy(&image[offset], &value, sizeof(value));
+}
+
+size_t _section_offset(const std::string& image, size_t section) {
+    return static_cast<size_t>(_read_u64(image, SECTIONS_OFFSET + section * SECTION_INFO_SIZE));
+}
+
+size_t _section_size(const std::string& image, size_t section) {
+    return static_cast<size_t>(_read_u64(image, SECTIONS_OFFSET + section * SECTION_INFO_SIZE + 8));
+}
+
+/**
+ * @brief Сохраняет испорченную копию образа и проверяет, что open ее отвергает
+ */
+void _check_rejected(const std::string& image, const char* name) {
+    std::filesystem::path path = _temp_path(name);
+    _write_file(path, image);
+    if (CompiledDictionary::open(path.string())) {
+        test::fail(__FILE__, __LINE__, name);
+    }
+    std::filesystem::remove(path);
+}
+
+void test_round_trip() {
+    auto built = CompiledDictionary::build(WORDS, PATTERNS, VERSION, 2);
+    CHECK(built != nullptr);
+    if (!built) {
+        return;
+    }
+
+    std::filesystem::path path = _temp_path("round_trip");
+    CHECK(built->save(path.string()));
+    auto opened = CompiledDictionary::open(path.string());
+    CHECK(opened != nullptr);
+    if (!opened) {
+        return;
+    }
+
+    CHECK_EQ(opened->get_version(), VERSION);
+    CHECK_EQ(opened->get_fingerprint(), built->get_fingerprint());
+    CHECK_EQ(opened->get_fingerprint(), CompiledDictionary::fingerprint(WORDS, PATTERNS));
+
+    CHECK_EQ(opened->word_count(), WORDS.size());
+    for (size_t i = 0; i < WORDS.size(); i++) {
+        CHECK(opened->word(i) == built->word(i));
+    }
+    CHECK(opened->word(WORDS.size()).empty());
+
+    // Слова хранятся нормализованными и без порога
+    std::string normalized;
+    audiocensor::text::normalize_word("собака", normalized);
+    CHECK(opened->word(0) == normalized);
+
+    CHECK_EQ(opened->pattern_count(), PATTERNS.size());
+    for (size_t i = 0; i < PATTERNS.size(); i++) {
+        CHECK(opened->pattern(i) == PATTERNS[i]);
+    }
+    CHECK(opened->pattern(PATTERNS.size()).empty());
+
+    // Индексы работают поверх прочитанного образа так же, как поверх собранного
+    uint32_t index = 99;
+    int distance = -1;
+    audiocensor::text::normalize_word("сабака", normalized);
+    CHECK(opened->fuzzy().find(normalized, index, distance));
+    CHECK_EQ(index, 0u);
+    CHECK_EQ(distance, 1);
+
+    audiocensor::text::normalize_word("дураками", normalized);
+    CHECK(opened->morph().find(normalized, index));
+    CHECK_EQ(index, 1u);
+    CHECK_EQ(opened->morph().size(), built->morph().size());
+
+    // Повторное сохранение дает тот же образ байт в байт
+    std::filesystem::path copy = _temp_path("round_trip_copy");
+    CHECK(opened->save(copy.string()));
+    CHECK(_read_file(path) == _read_file(copy));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(copy);
+}
+
+void test_no_plaintext_on_disk() {
+    auto built = CompiledDictionary::build(WORDS, PATTERNS, VERSION, 2);
+    CHECK(built != nullptr);
+    if (!built) {
+        return;
+    }
+
+    std::filesystem::path path = _temp_path("plaintext");
+    CHECK(built->save(path.string()));
+    std::string raw = _read_raw(path);
+    std::filesystem::remove(path);
+
+    // Ни нормализованные слова, ни паттерны, ни сигнатура формата не видны в файле
+    for (size_t i = 0; i < built->word_count(); i++) {
+        CHECK(raw.find(std::string(built->word(i))) == std::string::npos);
+    }
+    for (const auto& pattern : PATTERNS) {
+        CHECK(raw.find(pattern) == std::string::npos);
+    }
+    CHECK(raw.find("ACDICT") == std::string::npos);
+
+    // Образ без обфускации (формат до ее появления) не подключается
+    path = _temp_path("plain_image");
+    {
+        std::string plain = audiocensor::security::deobscure_str(raw);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(plain.data(), static_cast<std::streamsize>(plain.size()));
+    }
+    CHECK(!CompiledDictionary::open(path.string()));
+    std::filesystem::remove(path);
+}
+
+void test_empty_dictionary() {
+    auto built = CompiledDictionary::build({}, {}, 0, 2);
+    CHECK(built != nullptr);
+    if (!built) {
+        return;
+    }
+
+    std::filesystem::path path = _temp_path("empty");
+    CHECK(built->save(path.string()));
+    auto opened = CompiledDictionary::open(path.string());
+    CHECK(opened != nullptr);
+    if (opened) {
+        CHECK_EQ(opened->word_count(), 0u);
+        CHECK_EQ(opened->pattern_count(), 0u);
+        uint32_t index = 0;
+        CHECK(!opened->morph().find("слово", index));
+    }
+    std::filesystem::remove(path);
+}
+
+void test_corrupted_images() {
+    auto built = CompiledDictionary::build(WORDS, PATTERNS, VERSION, 2);
+    CHECK(built != nullptr);
+    if (!built) {
+        return;
+    }
+    std::filesystem::path path = _temp_path("source");
+    CHECK(built->save(path.string()));
+    const std::string image = _read_file(path);
+    std::filesystem::remove(path);
+    CHECK(image.size() > SECTIONS_OFFSET);
+
+    CHECK(!CompiledDictionary::open(_temp_path("missing").string()));
+    _check_rejected("", "empty_file");
+    _check_rejected(image.substr(0, SECTIONS_OFFSET), "header_only");
+    _check_rejected(image.substr(0, image.size() - 8), "truncated");
+    _check_rejected(image + std::string(8, '\0'), "trailing_bytes");
+
+    std::string corrupted = image;
+    corrupted[0] ^= 0x20;
+    _check_rejected(corrupted, "magic");
+
+    corrupted = image;
+    _write_u32(corrupted, FORMAT_VERSION_OFFSET, 1);
+    _check_rejected(corrupted, "format_version");
+
+    corrupted = image;
+    _write_u32(corrupted, BYTE_ORDER_OFFSET, 0x04030201u);
+    _check_rejected(corrupted, "byte_order");
+
+    // Секция за пределами образа, невыровненная и с размером не кратным элементу
+    corrupted = image;
+    _write_u64(corrupted, SECTIONS_OFFSET + SECTION_WORD_BYTES * SECTION_INFO_SIZE, image.size() + 8);
+    _check_rejected(corrupted, "section_offset");
+
+    corrupted = image;
+    _write_u64(corrupted, SECTIONS_OFFSET + SECTION_WORD_BYTES * SECTION_INFO_SIZE + 8, image.size());
+    _check_rejected(corrupted, "section_size");
+
+    corrupted = image;
+    _write_u64(corrupted, SECTIONS_OFFSET + SECTION_WORD_OFFSETS * SECTION_INFO_SIZE,
+               _section_offset(image, SECTION_WORD_OFFSETS) + 4);
+    _check_rejected(corrupted, "section_alignment");
+
+    corrupted = image;
+    _write_u64(corrupted, SECTIONS_OFFSET + SECTION_WORD_OFFSETS * SECTION_INFO_SIZE + 8,
+               _section_size(image, SECTION_WORD_OFFSETS) - 2);
+    _check_rejected(corrupted, "offsets_size");
+}
+
+void test_corrupted_sections() {
+    // Заголовок цел, испорчено содержимое секций: open проверяет только границы,
+    // поэтому обращения к словам и индексам не должны выходить за образ
+    auto built = CompiledDictionary::build(WORDS, PATTERNS, VERSION, 2);
+    CHECK(built != nullptr);
+    if (!built) {
+        return;
+    }
+    std::filesystem::path path = _temp_path("sections");
+    CHECK(built->save(path.string()));
+    std::string image = _read_file(path);
+
+    _write_u32(image, _section_offset(image, SECTION_WORD_OFFSETS) + sizeof(uint32_t), 0xFFFFFFF0u);
+
+    // Узел морфологического индекса: first_child, next_sibling, word_index, byte, terminal
+    size_t nodes = _section_offset(image, SECTION_MORPH_NODES);
+    size_t nodes_size = _section_size(image, SECTION_MORPH_NODES);
+    for (size_t node = nodes; node + 16 <= nodes + nodes_size; node += 16) {
+        _write_u32(image, node, 0x7FFFFFFFu);
+        _write_u32(image, node + 4, 0x7FFFFFFFu);
+    }
+    _write_file(path, image);
+
+    auto opened = CompiledDictionary::open(path.string());
+    CHECK(opened != nullptr);
+    if (opened) {
+        CHECK(opened->word(0).empty());
+        CHECK(opened->word(1).empty());
+
+        uint32_t index = 0;
+        std::string normalized;
+        audiocensor::text::normalize_word("дураками", normalized);
+        CHECK(!opened->morph().find(normalized, index));
+    }
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+int main() {
+    test_round_trip();
+    test_no_plaintext_on_disk();
+    test_empty_dictionary();
+    test_corrupted_images();
+    test_corrupted_sections();
+    return test::result();
+}
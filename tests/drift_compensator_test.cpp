@@ -0,0 +1,172 @@
+/**
+ * @brief Тесты DriftCompensator: передача без искажений при коэффициенте 1
+ *        и сходимость регулятора к расхождению часов
+ */
+
+#include "audiocensor/drift_compensator.h"
+#include "test_support.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using audiocensor::ConfigSnapshot;
+using audiocensor::DriftCompensator;
+
+namespace {
+
+constexpr int RATE = 16000;
+constexpr int CHUNK = 1024;
+
+ConfigSnapshot _config(bool enabled = true) {
+    ConfigSnapshot config;
+    config.values["drift_compensation"] = enabled ? "true" : "false";
+    config.values["drift_kp"] = "10";
+    config.values["drift_ki"] = "0.02";
+    config.values["drift_max_ppm"] = "500";
+    config.values["drift_settle_ms"] = "5000";
+    return config;
+}
+
+std::vector<short> _signal(size_t count, uint32_t seed) {
+    std::vector<short> samples(count);
+    for (auto& sample : samples) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = static_cast<short>(seed >> 16);
+    }
+    return samples;
+}
+
+/**
+ * @brief Заполнение до окончания измерения цели; регулятор еще не действует
+ */
+size_t _settle(DriftCompensator& compensator, double fill) {
+    size_t updates = 0;
+    while (!compensator.is_locked()) {
+        compensator.update(fill);
+        updates++;
+    }
+    return updates;
+}
+
+void test_unity_ratio_passthrough() {
+    DriftCompensator compensator(_config(), RATE, CHUNK);
+    CHECK_EQ(compensator.ratio(), 1.0);
+
+    // Сигнал проходит без изменений с задержкой в два сэмпла
+    std::vector<short> input;
+    std::vector<short> output;
+    std::vector<short> chunk_output;
+    for (uint32_t chunk = 0; chunk < 8; chunk++) {
+        auto samples = _signal(CHUNK, chunk + 1);
+        compensator.process(samples.data(), samples.size(), chunk_output);
+        input.insert(input.end(), samples.begin(), samples.end());
+        output.insert(output.end(), chunk_output.begin(), chunk_output.end());
+    }
+    CHECK_EQ(output.size(), input.size() - 2);
+
+    bool unchanged = true;
+    for (size_t i = 0; i < output.size(); i++) {
+        unchanged = unchanged && output[i] == input[i];
+    }
+    CHECK(unchanged);
+
+    // Постоянное заполнение после измерения цели не меняет коэффициент
+    _settle(compensator, 300.0);
+    for (int i = 0; i < 1000; i++) {
+        compensator.update(300.0);
+    }
+    CHECK_EQ(compensator.ratio(), 1.0);
+    CHECK_EQ(compensator.drift_ppm(), 0.0);
+}
+
+void test_disabled_passthrough() {
+    DriftCompensator compensator(_config(false), RATE, CHUNK);
+    CHECK(!compensator.is_enabled());
+
+    auto samples = _signal(CHUNK, 7);
+    std::vector<short> output;
+    compensator.update(1000.0);
+    compensator.process(samples.data(), samples.size(), output);
+    CHECK(output == samples);
+    CHECK_EQ(compensator.ratio(), 1.0);
+}
+
+void test_integral_converges_to_drift() {
+    DriftCompensator compensator(_config(), RATE, CHUNK);
+
+    // Выход медленнее входа на 100 ppm: за чанк конвейер набирает 100 ppm
+    // чанка, а передискретизация снимает (коэффициент - 1) чанка
+    const double drift_ppm = 100.0;
+    const double target = 500.0;
+    _settle(compensator, target);
+
+    double fill = target;
+    double chunk_seconds = static_cast<double>(CHUNK) / RATE;
+    size_t updates = static_cast<size_t>(4000.0 / chunk_seconds);
+    for (size_t i = 0; i < updates; i++) {
+        fill += CHUNK * (drift_ppm * 1e-6 - (compensator.ratio() - 1.0));
+        compensator.update(fill);
+    }
+
+    // Интеграл держит расхождение, заполнение вернулось к цели
+    CHECK(std::abs(compensator.drift_ppm() - drift_ppm) < 1.0);
+    CHECK(std::abs((compensator.ratio() - 1.0) * 1e6 - drift_ppm) < 1.0);
+    CHECK(std::abs(fill - target) < 1.0);
+
+    // Перезапуск потоков сохраняет оценку: коэффициент сразу учитывает расхождение
+    compensator.restart();
+    CHECK(!compensator.is_locked());
+    CHECK(std::abs((compensator.ratio() - 1.0) * 1e6 - drift_ppm) < 1.0);
+
+    // Полный сброс начинает оценку заново
+    compensator.reset();
+    CHECK_EQ(compensator.drift_ppm(), 0.0);
+    CHECK_EQ(compensator.ratio(), 1.0);
+}
+
+void test_integral_bounded() {
+    DriftCompensator compensator(_config(), RATE, CHUNK);
+    _settle(compensator, 0.0);
+
+    // Ошибка, которую регулятор не может снять, не накапливается за пределом
+    for (int i = 0; i < 100000; i++) {
+        compensator.update(1600.0);
+    }
+    CHECK_EQ(compensator.drift_ppm(), 500.0);
+    CHECK(std::abs((compensator.ratio() - 1.0) * 1e6 - 500.0) < 1e-6);
+}
+
+void test_ratio_changes_output_length() {
+    DriftCompensator compensator(_config(), RATE, CHUNK);
+    _settle(compensator, 0.0);
+
+    // Заполнение выше цели: входных сэмплов на сэмпл выхода становится больше
+    for (int i = 0; i < 100; i++) {
+        compensator.update(1600.0);
+    }
+    double ratio = compensator.ratio();
+    CHECK(ratio > 1.0);
+
+    size_t produced = 0;
+    std::vector<short> output;
+    const size_t chunks = 200;
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        auto samples = _signal(CHUNK, static_cast<uint32_t>(chunk));
+        compensator.process(samples.data(), samples.size(), output);
+        produced += output.size();
+    }
+    double expected = static_cast<double>(chunks * CHUNK) / ratio;
+    CHECK(std::abs(static_cast<double>(produced) - expected) <= 3.0);
+}
+
+} // namespace
+
+int main() {
+    test_unity_ratio_passthrough();
+    test_disabled_passthrough();
+    test_integral_converges_to_drift();
+    test_integral_bounded();
+    test_ratio_changes_output_length();
+    return test::result();
+}
@@ -0,0 +1,147 @@
+/**
+ * @brief Тесты FuzzyMatcher: пороги, границы расстояния и допуск slack
+ */
+
+#include "audiocensor/fuzzy_matcher.h"
+#include "test_support.h"
+
+#include <string>
+#include <vector>
+
+using audiocensor::FuzzyMatcher;
+
+namespace {
+
+/**
+ * @brief Проверяет поиск и возвращает расстояние (-1 - не найдено)
+ */
+int _find(const FuzzyMatcher& matcher, const std::string& word, int slack = 0) {
+    uint32_t index = 0;
+    int distance = 0;
+    return matcher.find(word, index, distance, slack) ? distance : -1;
+}
+
+void test_parse_threshold() {
+    std::string word;
+    CHECK_EQ(FuzzyMatcher::parse_threshold("слово~2", word), 2);
+    CHECK_EQ(word, "слово");
+    CHECK_EQ(FuzzyMatcher::parse_threshold("слово", word), -1);
+    CHECK_EQ(word, "слово");
+
+    // Не число или слишком длинное число - часть слова
+    CHECK_EQ(FuzzyMatcher::parse_threshold("слово~x", word), -1);
+    CHECK_EQ(word, "слово~x");
+    CHECK_EQ(FuzzyMatcher::parse_threshold("слово~123", word), -1);
+    CHECK_EQ(FuzzyMatcher::parse_threshold("слово~", word), -1);
+    CHECK_EQ(word, "слово~");
+}
+
+void test_default_threshold() {
+    CHECK_EQ(FuzzyMatcher::default_threshold(3), 0);
+    CHECK_EQ(FuzzyMatcher::default_threshold(4), 1);
+    CHECK_EQ(FuzzyMatcher::default_threshold(5), 1);
+    CHECK_EQ(FuzzyMatcher::default_threshold(6), 2);
+}
+
+void test_distance_edges() {
+    FuzzyMatcher matcher;
+    matcher.build({"абвгдеж"}, {2}, 3);
+
+    CHECK_EQ(_find(matcher, "абвгдеж"), 0);
+    CHECK_EQ(_find(matcher, "абвгдез"), 1);      // замена
+    CHECK_EQ(_find(matcher, "абвгде"), 1);       // удаление
+    CHECK_EQ(_find(matcher, "абвгдежз"), 1);     // вставка
+    CHECK_EQ(_find(matcher, "абвгдзз"), 2);      // ровно порог
+    CHECK_EQ(_find(matcher, "абвгззз"), -1);     // порог + 1
+    CHECK_EQ(_find(matcher, "абвг"), -1);        // разница длины больше порога
+
+    // Индекс требует совпадения первой буквы
+    CHECK_EQ(_find(matcher, "ббвгдеж"), -1);
+    CHECK_EQ(_find(matcher, ""), -1);
+}
+
+void test_thresholds_and_short_words() {
+    FuzzyMatcher matcher;
+    matcher.build({"кот", "собака", "лошадь", "медведь"}, {-1, -1, 0, 1}, 2);
+
+    // Порог 0 (короткие слова и явный ~0) - только точное совпадение, которое
+    // проверяется вне индекса
+    CHECK_EQ(_find(matcher, "кит"), -1);
+    CHECK_EQ(_find(matcher, "лошать"), -1);
+
+    CHECK_EQ(_find(matcher, "сабака"), 1);
+    CHECK_EQ(_find(matcher, "сабакк"), 2);
+    CHECK_EQ(_find(matcher, "медвед"), 1);
+    CHECK_EQ(_find(matcher, "медвет"), -1);
+}
+
+void test_max_length() {
+    std::string long_word(FuzzyMatcher::MAX_WORD_LENGTH, 'a');
+    std::string too_long(FuzzyMatcher::MAX_WORD_LENGTH + 1, 'a');
+
+    FuzzyMatcher matcher;
+    matcher.build({long_word, too_long}, {2, 2}, 2);
+    CHECK_EQ(matcher.size(), 1u);
+
+    std::string query = long_word;
+    query[10] = 'b';
+    CHECK_EQ(_find(matcher, query), 1);
+    CHECK_EQ(_find(matcher, long_word.substr(0, FuzzyMatcher::MAX_WORD_LENGTH - 1)), 1);
+
+    // Запрос длиннее 64 букв не проверяется
+    CHECK_EQ(_find(matcher, too_long), -1);
+}
+
+void test_slack() {
+    FuzzyMatcher matcher;
+    matcher.build({"абвгдеж"}, {1}, 3);
+
+    CHECK_EQ(_find(matcher, "абвгдзз"), -1);
+    CHECK_EQ(_find(matcher, "абвгдзз", 1), 2);
+    CHECK_EQ(_find(matcher, "абвгззз", 1), -1);
+    CHECK_EQ(_find(matcher, "абвгззз", 2), 3);
+
+    // Отрицательный допуск не сужает порог
+    CHECK_EQ(_find(matcher, "абвгдез", -5), 1);
+
+    // Допуск расширяет и окно длин
+    CHECK_EQ(_find(matcher, "абвгд"), -1);
+    CHECK_EQ(_find(matcher, "абвгд", 1), 2);
+}
+
+void test_best_match() {
+    FuzzyMatcher matcher;
+    matcher.build({"проверка", "проверки"}, {2, 2}, 2);
+
+    uint32_t index = 99;
+    int distance = -1;
+    CHECK(matcher.find("проверки", index, distance));
+    CHECK_EQ(index, 1u);
+    CHECK_EQ(distance, 0);
+}
+
+void test_empty_and_clear() {
+    FuzzyMatcher matcher;
+    CHECK_EQ(_find(matcher, "слово"), -1);
+
+    matcher.build({"слово"}, {1}, 2);
+    CHECK_EQ(_find(matcher, "слава"), -1);
+    CHECK_EQ(_find(matcher, "слова"), 1);
+    matcher.clear();
+    CHECK_EQ(matcher.size(), 0u);
+    CHECK_EQ(_find(matcher, "слова"), -1);
+}
+
+} // namespace
+
+int main() {
+    test_parse_threshold();
+    test_default_threshold();
+    test_distance_edges();
+    test_thresholds_and_short_words();
+    test_max_length();
+    test_slack();
+    test_best_match();
+    test_empty_and_clear();
+    return test::result();
+}
@@ -0,0 +1,256 @@
+#ifndef AUDIOCENSOR_HTTP_STUB_H
+#define AUDIOCENSOR_HTTP_STUB_H
+
+/**
+ * @brief Локальный HTTP-сервер с заранее заданными ответами для тестов сетевого кода
+ *
+ * Сервер слушает 127.0.0.1 на свободном порту и отвечает на запросы по
+ * очереди ответов (пустая очередь - 500). Каждый запрос запоминается вместе
+ * с заголовками и телом, чтобы тест мог проверить, что отправил клиент.
+ * Ответ с delay_ms больше таймаута клиента имитирует зависший сервер.
+ * Только POSIX: тесты с сетью на Windows не собираются.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace test {
+
+class HttpStub {
+public:
+    /**
+     * @brief Ответ сервера
+     */
+    struct Response {
+        int status = 200;
+        std::string body;
+        std::map<std::string, std::string> headers;
+        int delay_ms = 0;           // Пауза перед ответом
+    };
+
+    /**
+     * @brief Полученный запрос
+     */
+    struct Request {
+        std::string method;
+        std::string target;         // Путь с параметрами
+        std::map<std::string, std::string> headers;   // Имена в нижнем регистре
+        std::string body;
+    };
+
+    HttpStub() : listener(-1), port(0), stopping(false) {
+        // Запросы к заглушке не должны уходить в прокси из окружения
+        setenv("no_proxy", "127.0.0.1,localhost", 1);
+        setenv("NO_PROXY", "127.0.0.1,localhost", 1);
+
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listener, 8) != 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            ::close(listener);
+            listener = -1;
+            return;
+        }
+        port = ntohs(address.sin_port);
+        worker = std::thread([this]() { _serve(); });
+    }
+
+    ~HttpStub() {
+        stopping = true;
+        if (worker.joinable()) {
+            worker.join();
+        }
+        if (listener >= 0) {
+            ::close(listener);
+        }
+    }
+
+    HttpStub(const HttpStub&) = delete;
+    HttpStub& operator=(const HttpStub&) = delete;
+
+    /**
+     * @brief Проверяет, что сервер запущен
+     */
+    bool ok() const { return port != 0; }
+
+    /**
+     * @brief Возвращает адрес на сервере
+     * @param path Путь, начинающийся с "/"
+     */
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(port) + path;
+    }
+
+    /**
+     * @brief Добавляет ответ в очередь
+     */
+    void push(Response response) {
+        std::lock_guard<std::mutex> lock(mutex);
+        responses.push_back(std::move(response));
+    }
+
+    /**
+     * @brief Добавляет ответ с кодом и телом
+     */
+    void push(int status, const std::string& body, int delay_ms = 0) {
+        Response response;
+        response.status = status;
+        response.body = body;
+        response.delay_ms = delay_ms;
+        push(std::move(response));
+    }
+
+    /**
+     * @brief Возвращает полученные запросы и очищает их список
+     */
+    std::vector<Request> take_requests() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Request> result;
+        result.swap(requests);
+        return result;
+    }
+
+private:
+    void _serve() {
+        while (!stopping) {
+            pollfd descriptor{listener, POLLIN, 0};
+            if (::poll(&descriptor, 1, 20) <= 0) {
+                continue;
+            }
+            int client = ::accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                continue;
+            }
+            _handle(client);
+            ::close(client);
+        }
+    }
+
+    void _handle(int client) {
+        Request request;
+        if (!_read_request(client, request)) {
+            return;
+        }
+
+        Response response;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(request);
+            if (responses.empty()) {
+                response.status = 500;
+            } else {
+                response = std::move(responses.front());
+                responses.pop_front();
+            }
+        }
+
+        // Пауза прерывается остановкой сервера
+        auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(response.delay_ms);
+        while (!stopping && std::chrono::steady_clock::now() < until) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        std::string text = "HTTP/1.1 " + std::to_string(response.status) + " Stub\r\n";
+        for (const auto& header : response.headers) {
+            text += header.first + ": " + header.second + "\r\n";
+        }
+        text += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        text += "Connection: close\r\n\r\n";
+        if (response.status != 304) {
+            text += response.body;
+        }
+
+        // Клиент мог уже уйти по таймауту: запись не должна вызывать SIGPIPE
+        size_t sent = 0;
+        while (sent < text.size()) {
+            ssize_t written = ::send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+    }
+
+    bool _read_request(int client, Request& request) {
+        std::string data;
+        char buffer[4096];
+        size_t header_end = std::string::npos;
+        while ((header_end = data.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return false;
+            }
+            data.append(buffer, static_cast<size_t>(received));
+        }
+
+        size_t line_end = data.find("\r\n");
+        std::string line = data.substr(0, line_end);
+        size_t first = line.find(' ');
+        size_t second = line.find(' ', first + 1);
+        request.method = line.substr(0, first);
+        request.target = line.substr(first + 1, second - first - 1);
+
+        size_t pos = line_end + 2;
+        while (pos < header_end) {
+            size_t end = data.find("\r\n", pos);
+            std::string header = data.substr(pos, end - pos);
+            size_t colon = header.find(':');
+            if (colon != std::string::npos) {
+                std::string name = header.substr(0, colon);
+                std::transform(name.begin(), name.end(), name.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                size_t value_begin = header.find_first_not_of(' ', colon + 1);
+                request.headers[name] = value_begin == std::string::npos ? "" : header.substr(value_begin);
+            }
+            pos = end + 2;
+        }
+
+        request.body = data.substr(header_end + 4);
+        auto length = request.headers.find("content-length");
+        size_t expected = length != request.headers.end() ? std::strtoul(length->second.c_str(), nullptr, 10) : 0;
+        while (request.body.size() < expected) {
+            ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return false;
+            }
+            request.body.append(buffer, static_cast<size_t>(received));
+        }
+        return true;
+    }
+
+private:
+    int listener;
+    int port;
+    std::atomic<bool> stopping;
+    std::thread worker;
+    std::mutex mutex;
+    std::deque<Response> responses;
+    std::vector<Request> requests;
+};
+
+} // namespace test
+
+#endif // AUDIOCENSOR_HTTP_STUB_H
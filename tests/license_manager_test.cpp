@@ -0,0 +1,203 @@
+/**
+ * @brief Тесты LicenseManager с локальным сервером проверки (license_api_url):
+ *        отсутствующий кэш, подтверждение, отказ и таймаут
+ */
+
+#include "audiocensor/license_manager.h"
+#include "audiocensor/constants.h"
+#include "http_stub.h"
+#include "test_support.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QSettings>
+#include <QTimer>
+
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using audiocensor::LicenseManager;
+
+namespace {
+
+const std::string KEY = "TEST-KEY-0123456789";
+
+/**
+ * @brief Итог фоновой проверки
+ */
+struct Verification {
+    bool finished = false;
+    bool valid = false;
+    std::string message;
+};
+
+std::string _future_date() {
+    std::time_t later = std::time(nullptr) + 90 * 24 * 60 * 60;
+    char buffer[16];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", std::localtime(&later));
+    return buffer;
+}
+
+std::unique_ptr<LicenseManager> _manager(const test::HttpStub& server) {
+    auto manager = std::make_unique<LicenseManager>();
+    manager->apply_config({
+        {"license_api_url", server.url("/verify")},
+        {"license_timeout_ms", "300"},
+        {"license_connect_timeout_ms", "300"}
+    });
+    return manager;
+}
+
+/**
+ * @brief Сохраняет лицензию и удаляет подписанный кэш, как у установки до его появления
+ */
+void _store_license_without_cache(const std::string& expiry_date) {
+    {
+        LicenseManager manager;
+        manager.save_license(KEY, expiry_date);
+    }
+    QSettings settings(QString::fromStdString(audiocensor::LICENSE_COMPANY),
+                       QString::fromStdString(audiocensor::LICENSE_APP));
+    settings.remove("license_cache");
+    settings.remove("license_cache_signature");
+    settings.sync();
+}
+
+/**
+ * @brief Запускает фоновую проверку и ждет сигнала licenseVerified
+ */
+Verification _verify(LicenseManager& manager) {
+    Verification result;
+    QEventLoop loop;
+    QObject::connect(&manager, &LicenseManager::licenseVerified, &loop,
+                     [&](bool valid, const QString& message) {
+                         result.finished = true;
+                         result.valid = valid;
+                         result.message = message.toStdString();
+                         loop.quit();
+                     });
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+
+    if (!manager.start_background_verification()) {
+        return result;
+    }
+    loop.exec();
+    return result;
+}
+
+void test_missing_cache_is_not_trusted() {
+    test::HttpStub server;
+    _store_license_without_cache(_future_date());
+
+    auto manager = _manager(server);
+    CHECK_EQ(manager->get_license_key(), KEY);
+    CHECK(!manager->is_within_offline_grace());
+    CHECK(manager->needs_online_verification());
+    CHECK(manager->get_license_status()["has_license"] != "true");
+
+    // Кэш не пересоздается при чтении: следующий запуск тоже ему не доверяет
+    QSettings settings(QString::fromStdString(audiocensor::LICENSE_COMPANY),
+                       QString::fromStdString(audiocensor::LICENSE_APP));
+    CHECK(settings.value("license_cache", "").toString().isEmpty());
+
+    // has_valid_license отвечает по локальному состоянию и запускает проверку
+    server.push(500, "");
+    CHECK(!manager->has_valid_license());
+    QEventLoop loop;
+    QObject::connect(manager.get(), &LicenseManager::licenseVerified, &loop, [&loop]() { loop.quit(); });
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+    loop.exec();
+    CHECK_EQ(server.take_requests().size(), 1u);
+}
+
+void test_accept() {
+    test::HttpStub server;
+    std::string expiry_date = _future_date();
+    _store_license_without_cache(expiry_date);
+
+    auto manager = _manager(server);
+    server.push(200, "{\"status\": \"valid\", \"license_key\": \"" + KEY +
+                     "\", \"expiry_date\": \"" + expiry_date + "\"}");
+    Verification verification = _verify(*manager);
+    CHECK(verification.finished);
+    CHECK(verification.valid);
+    CHECK(manager->is_within_offline_grace());
+    CHECK(!manager->needs_online_verification());
+    CHECK_EQ(manager->get_license_status()["has_license"], "true");
+
+    auto requests = server.take_requests();
+    CHECK_EQ(requests.size(), 1u);
+    if (requests.size() == 1) {
+        CHECK_EQ(requests[0].method, "POST");
+        CHECK_EQ(requests[0].target, "/verify");
+        CHECK(requests[0].body.find(KEY) != std::string::npos);
+    }
+
+    // Подтвержденное состояние сохранено в подписанный кэш
+    auto reloaded = _manager(server);
+    CHECK(reloaded->is_within_offline_grace());
+    CHECK(!reloaded->needs_online_verification());
+}
+
+void test_reject() {
+    test::HttpStub server;
+    _store_license_without_cache(_future_date());
+
+    auto manager = _manager(server);
+    server.push(200, "{\"status\": \"invalid\"}");
+    Verification verification = _verify(*manager);
+    CHECK(verification.finished);
+    CHECK(!verification.valid);
+    CHECK(manager->get_license_key().empty());
+    CHECK(!manager->is_within_offline_grace());
+
+    auto reloaded = _manager(server);
+    CHECK(reloaded->get_license_key().empty());
+}
+
+void test_timeout() {
+    test::HttpStub server;
+    std::string expiry_date = _future_date();
+    _store_license_without_cache(expiry_date);
+
+    // Без кэша недоступный сервер не подтверждает лицензию, но и не удаляет ее
+    auto manager = _manager(server);
+    server.push(200, "{\"status\": \"valid\"}", 2000);
+    Verification verification = _verify(*manager);
+    CHECK(verification.finished);
+    CHECK(!verification.valid);
+    CHECK(verification.message.find("недоступен") != std::string::npos);
+    CHECK_EQ(manager->get_license_key(), KEY);
+    CHECK(!manager->is_within_offline_grace());
+
+    // С подписанным кэшем лицензия действует в пределах offline_grace_days
+    manager->save_license(KEY, expiry_date);
+    server.push(200, "{\"status\": \"valid\"}", 2000);
+    verification = _verify(*manager);
+    CHECK(verification.finished);
+    CHECK(verification.valid);
+    CHECK(manager->is_within_offline_grace());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Настройки пишутся во временный каталог, а не в настройки пользователя
+    std::filesystem::path config_home = std::filesystem::temp_directory_path() / "audiocensor_license_manager_test";
+    std::filesystem::remove_all(config_home);
+    std::filesystem::create_directories(config_home);
+    setenv("XDG_CONFIG_HOME", config_home.c_str(), 1);
+    setenv("HOME", config_home.c_str(), 1);
+
+    QCoreApplication app(argc, argv);
+    test_missing_cache_is_not_trusted();
+    test_accept();
+    test_reject();
+    test_timeout();
+
+    std::filesystem::remove_all(config_home);
+    return test::result();
+}
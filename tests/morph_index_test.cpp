@@ -0,0 +1,125 @@
+/**
+ * @brief Тесты MorphIndex: словоформы слов словаря и обычные слова, которые не должны совпадать
+ */
+
+#include "audiocensor/morph_index.h"
+#include "audiocensor/text_normalizer.h"
+#include "test_support.h"
+
+#include <string>
+#include <vector>
+
+using audiocensor::MorphIndex;
+
+namespace {
+
+const std::vector<std::string> TARGETS = {"сука", "дурак", "собака", "ругать"};
+
+void _build(MorphIndex& index) {
+    std::vector<std::string> normalized;
+    for (const std::string& word : TARGETS) {
+        std::string value;
+        audiocensor::text::normalize_word(word, value);
+        normalized.push_back(value);
+    }
+    index.build(normalized);
+}
+
+/**
+ * @brief Возвращает слово словаря, формой которого является word (пусто - не найдено)
+ */
+std::string _find(const MorphIndex& index, const std::string& word) {
+    std::string normalized;
+    audiocensor::text::normalize_word(word, normalized);
+    uint32_t word_index = 0;
+    return index.find(normalized, word_index) ? TARGETS.at(word_index) : std::string();
+}
+
+void test_inflections() {
+    MorphIndex index;
+    _build(index);
+
+    for (const char* word : {"дурак", "дурака", "дураку", "дураком", "дураки", "дураков", "дураками"}) {
+        CHECK_EQ(_find(index, word), "дурак");
+    }
+    for (const char* word : {"собака", "собаки", "собаке", "собаку", "собакой", "собак", "собаками"}) {
+        CHECK_EQ(_find(index, word), "собака");
+    }
+    for (const char* word : {"ругать", "ругает", "ругают", "ругал", "ругала", "ругали", "ругаться"}) {
+        CHECK_EQ(_find(index, word), "ругать");
+    }
+
+    // Многобуквенные приставки
+    for (const char* word : {"поругали", "обругал", "наругался"}) {
+        CHECK_EQ(_find(index, word), "ругать");
+    }
+}
+
+void test_non_targets() {
+    MorphIndex index;
+    _build(index);
+
+    // Частые слова, которые начинаются с основы слова словаря или содержат ее
+    // после однобуквенной "приставки"
+    const char* const words[] = {
+        "сук", "суков", "сукно", "сукном", "сумка", "скука",
+        "дура", "дурман", "дурно", "дуршлаг",
+        "собор", "собрание", "соблазн",
+        "ругань", "руда", "рука", "уругать", "оругал", "вдурака", "усобаки",
+        "вода", "дом", "стол", "и", ""
+    };
+    for (const char* word : words) {
+        CHECK_EQ(_find(index, word), "");
+    }
+}
+
+void test_short_words_exact_only() {
+    MorphIndex index;
+    _build(index);
+
+    // Основа короче MIN_STEM_LETTERS не отделяется: короткое слово находится
+    // только целиком, формы перечисляются в словаре явно
+    CHECK_EQ(_find(index, "сука"), "сука");
+    CHECK_EQ(_find(index, "суки"), "");
+    CHECK_EQ(_find(index, "сукой"), "");
+}
+
+void test_empty_index() {
+    MorphIndex index;
+    index.build({});
+    CHECK_EQ(index.size(), 0u);
+
+    uint32_t word_index = 0;
+    CHECK(!index.find("дурака", word_index));
+}
+
+void test_sibling_loop() {
+    // Поврежденный образ: братья первого уровня дерева основ замкнуты в цикл.
+    // Узлы 0-2 - корни деревьев основ, окончаний и приставок
+    const uint32_t none = 0xFFFFFFFFu;
+    std::vector<MorphIndex::Node> nodes(5, MorphIndex::Node{none, none, 0, 0, 0, 0});
+    nodes[0].first_child = 3;
+    nodes[3].byte = 'a';
+    nodes[3].next_sibling = 4;
+    nodes[4].byte = 'b';
+    nodes[4].next_sibling = 3;
+
+    MorphIndex index;
+    CHECK(index.attach(nodes.data(), nodes.size(), 1));
+
+    // Поиск завершается и ничего не находит
+    uint32_t word_index = 0;
+    CHECK(!index.find("zzzzzz", word_index));
+    CHECK(!index.find("бббббб", word_index));
+}
+
+} // namespace
+
+int main() {
+    test_inflections();
+    test_non_targets();
+    test_short_words_exact_only();
+    test_empty_index();
+    test_sibling_loop();
+    return test::result();
+}
@@ -0,0 +1,188 @@
+/**
+ * @brief Тесты RecognitionResultParser: escape-последовательности, суррогатные пары,
+ *        глубокая вложенность и обрезанный ввод
+ */
+
+#include "audiocensor/recognition_result.h"
+#include "test_support.h"
+
+#include <string>
+
+using audiocensor::RecognitionResultParser;
+
+namespace {
+
+/**
+ * @brief Разбирает документ с одним словом и возвращает его (пустая строка - ошибка)
+ */
+std::string _word(RecognitionResultParser& parser, const std::string& encoded) {
+    if (!parser.parse("{\"result\": [{\"word\": \"" + encoded + "\"}]}") || parser.size() != 1) {
+        return "";
+    }
+    return parser[0].word;
+}
+
+void test_vosk_result() {
+    RecognitionResultParser parser(1);
+    std::string json = R"({
+  "result" : [{
+      "conf" : 1.000000,
+      "end" : 1.110000,
+      "start" : 0.870000,
+      "word" : "привет"
+    }, {
+      "conf" : 0.5,
+      "end" : 2.5e0,
+      "start" : 1.2,
+      "word" : "мир"
+    }],
+  "text" : "привет мир"
+})";
+    CHECK(parser.parse(json));
+    CHECK(parser.has_result());
+    CHECK_EQ(parser.size(), 2u);
+    CHECK_EQ(parser[0].word, "привет");
+    CHECK_EQ(parser[0].start, 0.87);
+    CHECK_EQ(parser[0].end, 1.11);
+    CHECK_EQ(parser[0].conf, 1.0);
+    CHECK_EQ(parser[1].word, "мир");
+    CHECK_EQ(parser[1].end, 2.5);
+    CHECK_EQ(parser.text(), "привет мир");
+    CHECK(parser.error().empty());
+
+    // Результат без слов
+    CHECK(parser.parse(R"({"text" : ""})"));
+    CHECK(!parser.has_result());
+    CHECK(parser.empty());
+    CHECK(parser.parse("{}"));
+}
+
+void test_escapes() {
+    RecognitionResultParser parser;
+    CHECK_EQ(_word(parser, R"(a\"b)"), "a\"b");
+    CHECK_EQ(_word(parser, R"(a\\b)"), "a\\b");
+    CHECK_EQ(_word(parser, R"(a\/b)"), "a/b");
+    CHECK_EQ(_word(parser, R"(\b\f\n\r\t)"), "\b\f\n\r\t");
+
+    // Неизвестная escape-последовательность и управляющий символ - ошибка
+    CHECK(!parser.parse(R"({"result": [{"word": "a\xb"}]})"));
+    CHECK(!parser.error().empty());
+    CHECK(!parser.parse("{\"text\": \"a\nb\"}"));
+    CHECK(parser.empty());
+}
+
+void test_unicode_escapes() {
+    RecognitionResultParser parser;
+    CHECK_EQ(_word(parser, R"(\u0041)"), "A");
+    CHECK_EQ(_word(parser, R"(\u00e9)"), "\xC3\xA9");
+    CHECK_EQ(_word(parser, R"(\u043f\u0440\u0438)"), "при");
+    CHECK_EQ(_word(parser, R"(\u20AC)"), "\xE2\x82\xAC");
+
+    // Суррогатная пара собирается в один символ вне BMP
+    CHECK_EQ(_word(parser, R"(\ud83d\ude00)"), "\xF0\x9F\x98\x80");
+    CHECK_EQ(_word(parser, R"(x\uD834\uDD1Ey)"), "x\xF0\x9D\x84\x9Ey");
+
+    // Непарные и некорректные суррогаты
+    CHECK(!parser.parse(R"({"text": "\ud83d"})"));
+    CHECK(!parser.parse(R"({"text": "\ud83dx"})"));
+    CHECK(!parser.parse(R"({"text": "\ud83dA"})"));
+    CHECK(!parser.parse(R"({"text": "\ud83d\ud83d"})"));
+    CHECK(!parser.parse(R"({"text": "\ude00"})"));
+    CHECK(!parser.parse(R"({"text": "\ud83d\uzz00"})"));
+
+    // Некорректные шестнадцатеричные цифры
+    CHECK(!parser.parse(R"({"text": "\u00g1"})"));
+    CHECK(!parser.parse(R"({"text": "\u12"})"));
+}
+
+void test_unknown_fields_skipped() {
+    RecognitionResultParser parser;
+    CHECK(parser.parse(R"({"alternatives": [{"a": [1, -2.5e-3, true, false, null, "\"]}"]}],
+                           "result": [{"word": "да", "extra": {"x": [[]]}, "start": "0.5"},
+                                      {"start": 1.0}, 7, "строка"],
+                           "spk": {}})"));
+    CHECK_EQ(parser.size(), 1u);
+    CHECK_EQ(parser[0].word, "да");
+    CHECK_EQ(parser[0].start, 0.0);
+}
+
+void test_deep_nesting() {
+    RecognitionResultParser parser;
+
+    // Пропускаемое значение в пределах ограничения вложенности
+    std::string nested(64, '[');
+    nested += std::string(64, ']');
+    CHECK(parser.parse("{\"x\": " + nested + ", \"text\": \"ok\"}"));
+    CHECK_EQ(parser.text(), "ok");
+
+    // Глубже ограничения - ошибка, а не переполнение стека
+    std::string too_deep(100000, '[');
+    too_deep += std::string(100000, ']');
+    CHECK(!parser.parse("{\"x\": " + too_deep + "}"));
+    CHECK(parser.error().find("вложенность") != std::string::npos);
+
+    std::string objects;
+    for (int i = 0; i < 65; ++i) {
+        objects += "{\"k\": ";
+    }
+    objects += "1";
+    objects += std::string(65, '}');
+    CHECK(!parser.parse("{\"x\": " + objects + "}"));
+
+    // Несогласованные скобки
+    CHECK(!parser.parse(R"({"x": [{"a": 1]}})"));
+}
+
+void test_truncated_input() {
+    RecognitionResultParser parser;
+    std::string json = R"({"result": [{"conf": 1.0, "end": 1.11, "start": 0.87, "word": "п😀"}], "text": "п"})";
+    CHECK(parser.parse(json));
+    CHECK_EQ(parser.size(), 1u);
+
+    // Любой обрезанный префикс отвергается без чтения за границей буфера
+    for (size_t length = 0; length < json.size(); ++length) {
+        std::string prefix = json.substr(0, length);
+        if (parser.parse(prefix.data(), prefix.size())) {
+            test::fail(__FILE__, __LINE__, "обрезанный документ принят: " + prefix);
+        }
+        CHECK(parser.empty());
+    }
+
+    CHECK(!parser.parse(nullptr, 0));
+    CHECK(!parser.parse(json + "x"));
+    CHECK(!parser.parse(R"({"text": "a"} {})"));
+    CHECK(!parser.parse(R"({"result": [{"start": -}]})"));
+    CHECK(!parser.parse(R"({"result": [{"start": 1.}]})"));
+    CHECK(!parser.parse(R"({"result": [{"start": 1e}]})"));
+}
+
+void test_reuse() {
+    // Слова предыдущего разбора не остаются в результате
+    RecognitionResultParser parser(1);
+    CHECK(parser.parse(R"({"result": [{"word": "а"}, {"word": "б"}, {"word": "в"}]})"));
+    CHECK_EQ(parser.size(), 3u);
+    CHECK(parser.parse(R"({"result": [{"word": "г"}]})"));
+    CHECK_EQ(parser.size(), 1u);
+    CHECK_EQ(parser[0].word, "г");
+    CHECK_EQ(parser[0].start, 0.0);
+
+    size_t words = 0;
+    for (const auto& word : parser) {
+        CHECK_EQ(word.word, "г");
+        ++words;
+    }
+    CHECK_EQ(words, 1u);
+}
+
+} // namespace
+
+int main() {
+    test_vosk_result();
+    test_escapes();
+    test_unicode_escapes();
+    test_unknown_fields_skipped();
+    test_deep_nesting();
+    test_truncated_input();
+    test_reuse();
+    return test::result();
+}
@@ -0,0 +1,196 @@
+/**
+ * @brief Тесты SilenceCompressor: пределы drop_budget, число выброшенных
+ *        сэмплов и чанк выхода, заканчивающийся на середине кадра
+ */
+
+#include "audiocensor/silence_compressor.h"
+#include "test_support.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using audiocensor::ConfigSnapshot;
+using audiocensor::SilenceCompressor;
+
+namespace {
+
+constexpr int RATE = 16000;
+constexpr size_t CHUNK = 1024;
+constexpr size_t FRAME = 160;       // Кадр анализа 10 мс
+constexpr size_t CROSSFADE = 32;    // Переход на стыке 2 мс
+constexpr size_t MIN_EXCESS = 320;  // catchup_min_excess_ms = 20
+
+ConfigSnapshot _config(bool enabled = true) {
+    ConfigSnapshot config;
+    config.values["catchup_enabled"] = enabled ? "true" : "false";
+    config.values["catchup_silence_db"] = "-40";
+    config.values["catchup_min_excess_ms"] = "20";
+    config.values["catchup_max_drop_percent"] = "50";
+    return config;
+}
+
+/**
+ * @brief Тихий сигнал (ниже -40 dBFS), у которого каждый сэмпл различим
+ */
+std::vector<short> _quiet(size_t count) {
+    std::vector<short> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = static_cast<short>(i % 200);
+    }
+    return samples;
+}
+
+std::vector<short> _loud(size_t count) {
+    const double pi = std::acos(-1.0);
+    std::vector<short> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = static_cast<short>(8000.0 * std::sin(2.0 * pi * 440.0 * i / RATE));
+    }
+    return samples;
+}
+
+void test_drop_budget() {
+    SilenceCompressor compressor(_config(), RATE);
+
+    // Превышения нет или оно меньше catchup_min_excess_ms
+    CHECK_EQ(compressor.drop_budget(2000, 2000, CHUNK), 0u);
+    CHECK_EQ(compressor.drop_budget(2000 + MIN_EXCESS, 2000, CHUNK), 0u);
+
+    // Бюджет - не больше превышения и целое число кадров
+    size_t budget = compressor.drop_budget(2000 + 400, 2000, CHUNK);
+    CHECK_EQ(budget, 320u);
+    CHECK_EQ(budget % FRAME, 0u);
+
+    // Большое превышение ограничено долей чанка (50% от 1024 - три кадра)
+    CHECK_EQ(compressor.drop_budget(100000, 2000, CHUNK), 480u);
+
+    // В буфере должно остаться не меньше чанка выхода
+    CHECK_EQ(compressor.drop_budget(CHUNK + 200, 0, CHUNK), 160u);
+    CHECK_EQ(compressor.drop_budget(CHUNK, 0, CHUNK), 0u);
+
+    // Сокращение выключено
+    SilenceCompressor disabled(_config(false), RATE);
+    CHECK(!disabled.is_enabled());
+    CHECK_EQ(disabled.drop_budget(100000, 2000, CHUNK), 0u);
+}
+
+void test_drops_silence() {
+    SilenceCompressor compressor(_config(), RATE);
+    auto input = _quiet(CHUNK + 480);
+    std::vector<short> output(CHUNK);
+
+    size_t consumed = compressor.compress(input.data(), input.size(), output.data(), CHUNK, 480);
+    CHECK_EQ(consumed, CHUNK + 480);
+    CHECK_EQ(compressor.samples_dropped(), 480u);
+
+    // Первый кадр сохраняется (кроме перехода на стыке): перед ним не было тихого кадра
+    bool first_frame_kept = true;
+    for (size_t i = 0; i < FRAME - CROSSFADE; i++) {
+        first_frame_kept = first_frame_kept && output[i] == input[i];
+    }
+    CHECK(first_frame_kept);
+
+    // За стыком (после перехода) выход - вход со сдвигом на выброшенное
+    CHECK_EQ(output[FRAME + 10], input[FRAME + 480 + 10]);
+    CHECK_EQ(output[CHUNK - 1], input[CHUNK + 480 - 1]);
+
+    compressor.reset();
+    CHECK_EQ(compressor.samples_dropped(), 0u);
+}
+
+void test_budget_respected() {
+    SilenceCompressor compressor(_config(), RATE);
+    auto input = _quiet(CHUNK + 480);
+    std::vector<short> output(CHUNK);
+
+    // Тишины хватает на три кадра, но разрешен один
+    size_t consumed = compressor.compress(input.data(), input.size(), output.data(), CHUNK, FRAME);
+    CHECK_EQ(consumed, CHUNK + FRAME);
+    CHECK_EQ(compressor.samples_dropped(), FRAME);
+
+    // Бюджет меньше кадра: ничего не выбрасывается
+    consumed = compressor.compress(input.data(), input.size(), output.data(), CHUNK, FRAME - 1);
+    CHECK_EQ(consumed, CHUNK);
+    CHECK_EQ(compressor.samples_dropped(), FRAME);
+}
+
+void test_speech_not_dropped() {
+    SilenceCompressor compressor(_config(), RATE);
+    auto input = _loud(CHUNK + 480);
+    std::vector<short> output(CHUNK);
+
+    size_t consumed = compressor.compress(input.data(), input.size(), output.data(), CHUNK, 480);
+    CHECK_EQ(consumed, CHUNK);
+    CHECK_EQ(compressor.samples_dropped(), 0u);
+
+    bool unchanged = true;
+    for (size_t i = 0; i < CHUNK; i++) {
+        unchanged = unchanged && output[i] == input[i];
+    }
+    CHECK(unchanged);
+}
+
+void test_word_edges_kept() {
+    SilenceCompressor compressor(_config(), RATE);
+
+    // Тишина, слово и тишина: кадры рядом со словом не выбрасываются
+    auto input = _quiet(CHUNK + 480);
+    auto loud = _loud(input.size());
+    for (size_t i = 2 * FRAME; i < 4 * FRAME; i++) {
+        input[i] = loud[i];
+    }
+    std::vector<short> output(CHUNK);
+
+    compressor.compress(input.data(), input.size(), output.data(), CHUNK, 480);
+
+    // Кадры вплотную к слову сохраняются, поэтому слово выходит целиком
+    bool word_kept = false;
+    for (size_t shift = 0; shift + 2 * FRAME <= CHUNK && !word_kept; shift += FRAME) {
+        bool match = true;
+        for (size_t i = 0; i < 2 * FRAME && match; i++) {
+            match = output[shift + i] == input[2 * FRAME + i];
+        }
+        word_kept = match;
+    }
+    CHECK(word_kept);
+}
+
+void test_chunk_ends_mid_frame() {
+    SilenceCompressor compressor(_config(), RATE);
+
+    // Чанк выхода не кратен кадру: последний кадр копируется частично
+    const size_t output_count = 1000;
+    auto input = _quiet(output_count + 480);
+    std::vector<short> output(output_count);
+
+    size_t consumed = compressor.compress(input.data(), input.size(), output.data(), output_count, 480);
+    size_t dropped = static_cast<size_t>(compressor.samples_dropped());
+    CHECK_EQ(dropped, 480u);
+    CHECK_EQ(consumed, output_count + dropped);
+    CHECK_EQ(output[output_count - 1], input[consumed - 1]);
+
+    // Следующий чанк продолжается с первого неиспользованного сэмпла
+    auto next_input = _loud(2 * output_count);
+    consumed = compressor.compress(next_input.data(), next_input.size(), output.data(), output_count, 480);
+    CHECK_EQ(consumed, output_count);
+    CHECK_EQ(output[0], next_input[0]);
+    CHECK_EQ(output[output_count - 1], next_input[output_count - 1]);
+
+    // Вход короче чанка выхода: используется весь, за пределы не выходит
+    std::vector<short> short_input = _quiet(FRAME + 40);
+    consumed = compressor.compress(short_input.data(), short_input.size(), output.data(), output_count, 480);
+    CHECK(consumed <= short_input.size());
+}
+
+} // namespace
+
+int main() {
+    test_drop_budget();
+    test_drops_silence();
+    test_budget_respected();
+    test_speech_not_dropped();
+    test_word_edges_kept();
+    test_chunk_ends_mid_frame();
+    return test::result();
+}
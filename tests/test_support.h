@@ -0,0 +1,65 @@
+#ifndef AUDIOCENSOR_TEST_SUPPORT_H
+#define AUDIOCENSOR_TEST_SUPPORT_H
+
+/**
+ * @brief Минимальная поддержка модульных тестов без внешних зависимостей
+ *
+ * Каждый тест - отдельный исполняемый файл: функции проверок вызываются
+ * из main(), который возвращает test::result(). CHECK не прерывает тест,
+ * а только печатает место ошибки, чтобы за один запуск были видны все сбои.
+ */
+
+#include <cstdio>
+#include <string>
+
+namespace test {
+
+/**
+ * @brief Счетчик проваленных проверок процесса
+ */
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+/**
+ * @brief Регистрирует проваленную проверку
+ * @param file Файл
+ * @param line Строка
+ * @param expression Текст проверки
+ */
+inline void fail(const char* file, int line, const std::string& expression) {
+    std::fprintf(stderr, "%s:%d: проверка не прошла: %s\n", file, line, expression.c_str());
+    failures()++;
+}
+
+/**
+ * @brief Итог запуска для main()
+ * @return 0 если все проверки прошли
+ */
+inline int result() {
+    if (failures() == 0) {
+        std::printf("OK\n");
+        return 0;
+    }
+    std::fprintf(stderr, "Проваленных проверок: %d\n", failures());
+    return 1;
+}
+
+} // namespace test
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            test::fail(__FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        if (!((actual) == (expected))) { \
+            test::fail(__FILE__, __LINE__, #actual " == " #expected); \
+        } \
+    } while (0)
+
+#endif // AUDIOCENSOR_TEST_SUPPORT_H
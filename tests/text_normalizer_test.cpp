@@ -0,0 +1,113 @@
+/**
+ * @brief Тесты нормализации текста: регистр, ё, латинские двойники, повторы букв
+ *        и отличие от fold_case, на котором проверяются регулярные выражения
+ */
+
+#include "audiocensor/text_normalizer.h"
+#include "test_support.h"
+
+#include <regex>
+#include <string>
+
+namespace text = audiocensor::text;
+
+namespace {
+
+std::string _normalize(const std::string& word) {
+    std::string output;
+    text::normalize_word(word, output);
+    return output;
+}
+
+std::string _fold(const std::string& word) {
+    std::string output;
+    text::fold_case(word, output);
+    return output;
+}
+
+void test_case_and_yo() {
+    CHECK_EQ(_normalize("ПРИВЕТ"), "привет");
+    CHECK_EQ(_normalize("Ёлка"), "елка");
+    CHECK_EQ(_normalize("ЁЖ"), "еж");
+    CHECK_EQ(_normalize("Ѐ"), "е");
+    CHECK_EQ(_normalize("ЂЏ"), "ђџ");
+    CHECK_EQ(_normalize("  слово\t\r\n"), "слово");
+    CHECK_EQ(_normalize(""), "");
+    CHECK_EQ(_normalize("   "), "");
+}
+
+void test_homoglyphs() {
+    // Латинские двойники заменяются кириллицей в любом регистре
+    CHECK_EQ(_normalize("cop"), "сор");
+    CHECK_EQ(_normalize("COP"), "сор");
+    CHECK_EQ(_normalize("yxa"), "уха");
+    CHECK_EQ(_normalize("kmthb"), "кмтнв");
+
+    // Прочая латиница только приводится к нижнему регистру
+    CHECK_EQ(_normalize("QZ"), "qz");
+
+    // Быстрый путь по 8 байт ASCII и остаток дают одинаковый результат
+    CHECK_EQ(_normalize("ABCDEFGHIJ"), "авсdеfgнij");
+}
+
+void test_collapse_repeats() {
+    CHECK_EQ(_normalize("приииивет"), "привет");
+    CHECK_EQ(_normalize("длинный"), "длиный");
+    CHECK_EQ(_normalize("ааААаа"), "а");
+
+    // Повтор считается после замены: "ее" из "ёе" и "оo" из кириллицы и латиницы
+    CHECK_EQ(_normalize("ёе"), "е");
+    CHECK_EQ(_normalize("оo"), "о");
+    CHECK_EQ(_normalize("aaaaaaaaaaaa"), "а");
+}
+
+void test_letter_count() {
+    std::string output;
+    CHECK_EQ(text::normalize_word("ПРИИИВЕТ", output), 6u);
+    CHECK_EQ(text::normalize_word("", output), 0u);
+    CHECK_EQ(text::fold_case("ПрИвЕт", output), 6u);
+    CHECK_EQ(text::utf8_length("ёж-x"), 4u);
+}
+
+void test_invalid_utf8() {
+    // Некорректные байты копируются как есть и не теряются
+    CHECK_EQ(_normalize("a\xFF" "b"), "а\xFF" "в");
+    CHECK_EQ(_normalize("\xD0"), "\xD0");
+    CHECK_EQ(_fold("\xD0\x41"), "\xD0" "a");
+    CHECK_EQ(_normalize("\xF0\x9F\x98\x80\xF0\x9F\x98\x80"), "\xF0\x9F\x98\x80");
+}
+
+void test_fold_case() {
+    // fold_case не меняет буквы и не схлопывает повторы
+    CHECK_EQ(_fold("ДЛИННЫЙ Ёж COP"), "длинный ёж cop");
+    CHECK_EQ(_fold("ABCDEFGHIJKLMNOPQRSTUVWXYZ"), "abcdefghijklmnopqrstuvwxyz");
+    CHECK_EQ(_fold("@[`{"), "@[`{");
+}
+
+void test_patterns_use_folded_text() {
+    // Регулярное выражение из списка написано для исходного текста: на
+    // нормализованном слове оно перестает совпадать, на fold_case - совпадает
+    const std::regex doubled("нн");
+    const std::regex yo("^ёж");
+    const std::regex latin("^cop$");
+
+    CHECK(!std::regex_search(_normalize("ДЛИННЫЙ"), doubled));
+    CHECK(std::regex_search(_fold("ДЛИННЫЙ"), doubled));
+    CHECK(!std::regex_search(_normalize("Ёжик"), yo));
+    CHECK(std::regex_search(_fold("Ёжик"), yo));
+    CHECK(!std::regex_search(_normalize("COP"), latin));
+    CHECK(std::regex_search(_fold("COP"), latin));
+}
+
+} // namespace
+
+int main() {
+    test_case_and_yo();
+    test_homoglyphs();
+    test_collapse_repeats();
+    test_letter_count();
+    test_invalid_utf8();
+    test_fold_case();
+    test_patterns_use_folded_text();
+    return test::result();
+}
@@ -0,0 +1,73 @@
+/**
+ * @brief Тесты WordDetector: регулярные выражения списка проверяются на исходном
+ *        написании слова, словарь - на нормализованном
+ */
+
+#include "audiocensor/word_detector.h"
+#include "audiocensor/compiled_dictionary.h"
+#include "test_support.h"
+
+#include <string>
+#include <tuple>
+
+using audiocensor::CompiledDictionary;
+using audiocensor::WordDetector;
+
+namespace {
+
+bool _prohibited(WordDetector& detector, const std::string& word, std::string* reason = nullptr) {
+    bool prohibited = false;
+    std::string matched;
+    std::tie(prohibited, matched) = detector.is_prohibited_word(word);
+    if (reason) {
+        *reason = matched;
+    }
+    return prohibited;
+}
+
+void test_patterns_see_original_spelling() {
+    WordDetector detector;
+    detector.set_dictionary(CompiledDictionary::build({}, {"^ёжик", "анн", "^cop$"}, 1, 2));
+
+    std::string reason;
+    CHECK(_prohibited(detector, "Ёжик", &reason));
+    CHECK_EQ(reason, "^ёжик");
+    CHECK(_prohibited(detector, "ВАННА", &reason));
+    CHECK_EQ(reason, "анн");
+    CHECK(_prohibited(detector, "COP", &reason));
+    CHECK_EQ(reason, "^cop$");
+
+    // Другое написание не совпадает с выражением
+    CHECK(!_prohibited(detector, "ежик"));
+    CHECK(!_prohibited(detector, "вана"));
+    CHECK(!_prohibited(detector, "сор"));
+}
+
+void test_words_are_normalized() {
+    WordDetector detector;
+    detector.set_dictionary(CompiledDictionary::build({"ёлка"}, {}, 1, 2));
+
+    CHECK(_prohibited(detector, "ЕЛКА"));
+    CHECK(_prohibited(detector, "ёлллка"));
+    CHECK(_prohibited(detector, "eлкa"));
+    CHECK(!_prohibited(detector, "палка"));
+}
+
+void test_cache_keeps_spellings_apart() {
+    // Написания с одинаковой нормализацией кэшируются раздельно
+    WordDetector detector;
+    detector.set_dictionary(CompiledDictionary::build({}, {"нн"}, 1, 2));
+
+    CHECK(!_prohibited(detector, "длиный"));
+    CHECK(_prohibited(detector, "длинный"));
+    CHECK(!_prohibited(detector, "длиный"));
+}
+
+} // namespace
+
+int main() {
+    test_patterns_see_original_spelling();
+    test_words_are_normalized();
+    test_cache_keeps_spellings_apart();
+    return test::result();
+}
@@ -0,0 +1,179 @@
+/**
+ * @brief Тесты WordListSync с локальной заглушкой API: полный список, изменения, 304
+ *        и изменения, посчитанные не от версии кэша
+ */
+
+#include "audiocensor/word_list_sync.h"
+#include "http_stub.h"
+#include "test_support.h"
+
+#include <filesystem>
+#include <future>
+#include <string>
+#include <vector>
+
+using audiocensor::WordListSync;
+
+namespace {
+
+const std::unordered_map<std::string, std::string> CONFIG = {
+    {"sync_timeout_ms", "2000"},
+    {"sync_connect_timeout_ms", "1000"},
+    {"sync_retries", "0"},
+    {"sync_retry_delay_ms", "10"}
+};
+
+WordListSync::Result _sync(WordListSync& sync) {
+    std::promise<WordListSync::Result> finished;
+    auto future = finished.get_future();
+    CHECK(sync.start([&finished](const WordListSync::Result& result) { finished.set_value(result); }));
+    return future.get();
+}
+
+std::vector<std::string> _words(const WordListSync& sync, uint64_t* version = nullptr) {
+    std::vector<std::string> words;
+    std::vector<std::string> patterns;
+    uint64_t list_version = 0;
+    sync.get_lists(words, patterns, list_version);
+    if (version) {
+        *version = list_version;
+    }
+    return words;
+}
+
+bool _has_param(const std::string& target, const std::string& param) {
+    return target.find(param) != std::string::npos;
+}
+
+void test_sync_sequence() {
+    test::HttpStub server;
+    CHECK(server.ok());
+
+    std::filesystem::path cache = std::filesystem::temp_directory_path() / "audiocensor_word_list_sync_test.cache";
+    std::filesystem::remove(cache);
+
+    WordListSync sync(server.url("/words"), cache.string(), CONFIG);
+    sync.set_query_params("key=abc");
+    CHECK(!sync.load_cache());
+
+    // Полный список: кэша нет, поэтому запрос без since_version и If-None-Match
+    test::HttpStub::Response full;
+    full.body = R"({"version": 5, "words": ["альфа", "бета"], "patterns": ["гамма.*"]})";
+    full.headers["ETag"] = "\"v5\"";
+    server.push(full);
+
+    WordListSync::Result result = _sync(sync);
+    CHECK(result.success);
+    CHECK(result.changed);
+    CHECK(!result.delta);
+    CHECK(!result.full_refetch);
+    uint64_t version = 0;
+    CHECK((_words(sync, &version) == std::vector<std::string>{"альфа", "бета"}));
+    CHECK_EQ(version, 5u);
+
+    auto requests = server.take_requests();
+    CHECK_EQ(requests.size(), 1u);
+    if (requests.size() == 1) {
+        CHECK(_has_param(requests[0].target, "key=abc"));
+        CHECK(!_has_param(requests[0].target, "since_version"));
+        CHECK(requests[0].headers.count("if-none-match") == 0);
+    }
+
+    // Кэш на диске читается новым экземпляром
+    {
+        WordListSync reloaded(server.url("/words"), cache.string(), CONFIG);
+        CHECK(reloaded.load_cache());
+        CHECK(reloaded.has_data());
+        CHECK((_words(reloaded) == std::vector<std::string>{"альфа", "бета"}));
+    }
+
+    // 304: запрос с версией и ETag кэша, списки не меняются
+    server.push(304, "");
+    result = _sync(sync);
+    CHECK(result.success);
+    CHECK(result.not_modified);
+    CHECK(!result.changed);
+    requests = server.take_requests();
+    CHECK_EQ(requests.size(), 1u);
+    if (requests.size() == 1) {
+        CHECK(_has_param(requests[0].target, "since_version=5"));
+        CHECK_EQ(requests[0].headers["if-none-match"], "\"v5\"");
+    }
+
+    // Изменения от версии кэша применяются к спискам
+    server.push(200, R"({"version": 6, "delta": true, "base_version": 5,
+                         "added_words": ["дельта"], "removed_words": ["альфа"]})");
+    result = _sync(sync);
+    CHECK(result.success);
+    CHECK(result.delta);
+    CHECK(result.changed);
+    CHECK((_words(sync, &version) == std::vector<std::string>{"бета", "дельта"}));
+    CHECK_EQ(version, 6u);
+    server.take_requests();
+
+    // Изменения от чужой версии: в том же проходе запрашивается полный список
+    server.push(200, R"({"version": 9, "delta": true, "base_version": 3, "added_words": ["лишнее"]})");
+    test::HttpStub::Response refetched;
+    refetched.body = R"({"version": 9, "words": ["эпсилон"], "patterns": []})";
+    refetched.headers["ETag"] = "\"v9\"";
+    server.push(refetched);
+
+    result = _sync(sync);
+    CHECK(result.success);
+    CHECK(result.full_refetch);
+    CHECK(!result.delta);
+    CHECK(result.error.empty());
+    CHECK((_words(sync, &version) == std::vector<std::string>{"эпсилон"}));
+    CHECK_EQ(version, 9u);
+
+    requests = server.take_requests();
+    CHECK_EQ(requests.size(), 2u);
+    if (requests.size() == 2) {
+        CHECK(_has_param(requests[0].target, "since_version=6"));
+        CHECK(_has_param(requests[1].target, "key=abc"));
+        CHECK(!_has_param(requests[1].target, "since_version"));
+        CHECK(requests[1].headers.count("if-none-match") == 0);
+    }
+
+    // Полный список не получен: остаются прежние списки, следующий проход снова с версией
+    server.push(200, R"({"version": 12, "delta": true, "base_version": 11})");
+    server.push(503, "");
+    result = _sync(sync);
+    CHECK(!result.success);
+    CHECK(result.full_refetch);
+    CHECK(sync.has_data());
+    CHECK((_words(sync, &version) == std::vector<std::string>{"эпсилон"}));
+    CHECK_EQ(version, 9u);
+    CHECK_EQ(server.take_requests().size(), 2u);
+
+    server.push(304, "");
+    result = _sync(sync);
+    CHECK(result.success);
+    requests = server.take_requests();
+    CHECK_EQ(requests.size(), 1u);
+    if (requests.size() == 1) {
+        CHECK(_has_param(requests[0].target, "since_version=9"));
+        CHECK_EQ(requests[0].headers["if-none-match"], "\"v9\"");
+    }
+
+    std::filesystem::remove(cache);
+}
+
+void test_not_modified_without_cache() {
+    test::HttpStub server;
+    WordListSync sync(server.url("/words"), "", CONFIG);
+
+    server.push(304, "");
+    WordListSync::Result result = _sync(sync);
+    CHECK(!result.success);
+    CHECK(result.not_modified);
+    CHECK(!sync.has_data());
+}
+
+} // namespace
+
+int main() {
+    test_sync_sequence();
+    test_not_modified_without_cache();
+    return test::result();
+}
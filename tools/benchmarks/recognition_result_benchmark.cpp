@@ -0,0 +1,128 @@
+/**
+ * @brief Сравнение разбора результатов Vosk: RecognitionResultParser и nlohmann::json
+ *
+ * Сборка: cmake -DAUDIOCENSOR_BUILD_BENCHMARKS=ON
+ * Запуск: recognition_result_benchmark [количество_итераций]
+ */
+
+#include "audiocensor/recognition_result.h"
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using audiocensor::RecognitionResultParser;
+
+namespace {
+
+/**
+ * @brief Строит результат в формате вывода Vosk (отступы и шесть знаков после запятой)
+ * @param word_count Количество слов
+ * @return Текст JSON
+ */
+std::string _make_result(int word_count) {
+    static const char* vocabulary[] = {
+        "привет", "как", "дела", "сегодня", "отличная", "погода", "stream", "чат"
+    };
+
+    std::string text;
+    std::string result = "{\n  \"result\" : [";
+    double time = 0.42;
+    char buffer[256];
+    for (int i = 0; i < word_count; ++i) {
+        const char* word = vocabulary[i % 8];
+        double duration = 0.18 + 0.03 * (i % 5);
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s{\n      \"conf\" : %f,\n      \"end\" : %f,\n"
+                      "      \"start\" : %f,\n      \"word\" : \"%s\"\n    }",
+                      i == 0 ? "" : ", ", 0.75 + 0.05 * (i % 5), time + duration, time, word);
+        result += buffer;
+        time += duration + 0.04;
+        if (i > 0) {
+            text += " ";
+        }
+        text += word;
+    }
+    result += "],\n  \"text\" : \"" + text + "\"\n}";
+    return result;
+}
+
+/**
+ * @brief Разбор так, как он выполнялся до RecognitionResultParser
+ */
+double _parse_with_dom(const std::string& document) {
+    json result = json::parse(document);
+    if (!result.contains("result") || !result["result"].is_array()) {
+        return 0.0;
+    }
+    auto words = result["result"];
+    double checksum = 0.0;
+    for (const auto& word : words) {
+        if (!word.contains("word") || !word["word"].is_string()) {
+            continue;
+        }
+        checksum += word["word"].get_ref<const std::string&>().size();
+        checksum += word["start"].get<double>() + word["end"].get<double>();
+    }
+    return checksum;
+}
+
+double _parse_streaming(RecognitionResultParser& parser, const std::string& document) {
+    if (!parser.parse(document)) {
+        return 0.0;
+    }
+    double checksum = 0.0;
+    for (const auto& word : parser) {
+        checksum += word.word.size();
+        checksum += word.start + word.end;
+    }
+    return checksum;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+    if (iterations <= 0) {
+        iterations = 20000;
+    }
+
+    RecognitionResultParser parser;
+
+    std::printf("%8s %10s %14s %14s %9s\n", "слов", "байт", "nlohmann, мкс", "потоковый, мкс", "ускорение");
+    for (int word_count : {1, 5, 20, 60, 200}) {
+        std::string document = _make_result(word_count);
+
+        // Оба способа должны давать одинаковый результат
+        double expected = _parse_with_dom(document);
+        double actual = _parse_streaming(parser, document);
+        if (expected != actual) {
+            std::fprintf(stderr, "Результаты разбора расходятся: %f != %f\n", expected, actual);
+            return 1;
+        }
+
+        volatile double sink = 0.0;
+        auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sink = sink + _parse_with_dom(document);
+        }
+        double dom_us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - started).count() / iterations;
+
+        started = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sink = sink + _parse_streaming(parser, document);
+        }
+        double streaming_us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - started).count() / iterations;
+
+        std::printf("%8d %10zu %14.2f %14.2f %8.1fx\n", word_count, document.size(),
+                    dom_us, streaming_us, dom_us / streaming_us);
+    }
+
+    return 0;
+}